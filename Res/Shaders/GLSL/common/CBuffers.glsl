@@ -50,3 +50,8 @@ layout(std140, row_major, set = 0, binding = 8) uniform GICBufferBlock
 	vec4 workload;
 	vec4 irradianceVolumeOffset;
 } GICBuffer;
+
+layout(std140, set = 0, binding = 10) uniform instanceCBufferBlock
+{
+	Instance_CB data;
+} instanceCBuffer;
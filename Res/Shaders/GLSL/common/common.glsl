@@ -75,6 +75,11 @@ struct DispatchParam_CB
 	uvec4 numThreads;
 };
 
+struct Instance_CB
+{
+	uint instanceOffset;
+};
+
 struct Plane
 {
 	vec3 N;
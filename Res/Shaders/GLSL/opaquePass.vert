@@ -14,11 +14,23 @@ layout(location = 3) out vec2 thefrag_TexCoord;
 layout(location = 4) out vec3 thefrag_Normal;
 layout(location = 5) out float thefrag_UUID;
 
+layout(std430, set = 0, binding = 13) buffer instanceSBufferBlock
+{
+	uint data[];
+} instanceSBuffer;
+
+layout(std430, row_major, set = 0, binding = 14) buffer perObjectSBufferBlock
+{
+	PerObject_CB data[];
+} perObjectSBuffer;
+
 void main()
 {
+	uint perObjectIndex = instanceSBuffer.data[instanceCBuffer.data.instanceOffset + gl_InstanceIndex];
+
 	// output the fragment position in world space
-	thefrag_WorldSpacePos = perObjectCBuffer.data.m * inPosition;
-	vec4 thefrag_WorldSpacePos_prev = perObjectCBuffer.data.m_prev * inPosition;
+	thefrag_WorldSpacePos = perObjectSBuffer.data[perObjectIndex].m * inPosition;
+	vec4 thefrag_WorldSpacePos_prev = perObjectSBuffer.data[perObjectIndex].m_prev * inPosition;
 
 	// output the current and previous fragment position in clip space
 	vec4 thefrag_CameraSpacePos_current = perFrameCBuffer.data.v * thefrag_WorldSpacePos;
@@ -31,10 +43,10 @@ void main()
 	thefrag_TexCoord = inTexCoord;
 
 	// output the normal
-	thefrag_Normal = mat3(transpose(inverse(perObjectCBuffer.data.m))) * inNormal.xyz;
+	thefrag_Normal = mat3(transpose(inverse(perObjectSBuffer.data[perObjectIndex].m))) * inNormal.xyz;
 
 	// output the UUID
-	thefrag_UUID = perObjectCBuffer.data.UUID;
+	thefrag_UUID = perObjectSBuffer.data[perObjectIndex].UUID;
 
 	gl_Position = perFrameCBuffer.data.p_jittered * thefrag_CameraSpacePos_current;
 }
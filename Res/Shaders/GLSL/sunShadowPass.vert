@@ -6,7 +6,17 @@ layout(location = 2) in vec2 inPad1;
 layout(location = 3) in vec4 inNormal;
 layout(location = 4) in vec4 inPad2;
 
+layout(std430, set = 0, binding = 13) buffer instanceSBufferBlock
+{
+	uint data[];
+} instanceSBuffer;
+
+layout(std430, row_major, set = 0, binding = 14) buffer perObjectSBufferBlock
+{
+	PerObject_CB data[];
+} perObjectSBuffer;
+
 void main()
 {
-	gl_Position = perObjectCBuffer.data.m * inPosition;
+	gl_Position = perObjectSBuffer.data[instanceSBuffer.data[instanceCBuffer.data.instanceOffset + gl_InstanceIndex]].m * inPosition;
 }
\ No newline at end of file
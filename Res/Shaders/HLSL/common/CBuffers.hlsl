@@ -46,4 +46,9 @@ cbuffer GICBuffer : register(b8)
 cbuffer volumetricPassCBuffer : register(b9)
 {
 	VolumetricPassData volumetricPassCBuffer;
+};
+
+cbuffer instanceCBuffer : register(b10)
+{
+	Instance_CB instanceCBuffer;
 };
\ No newline at end of file
@@ -91,6 +91,11 @@ struct DispatchParam_CB
 	uint4 numThreads;
 };
 
+struct Instance_CB
+{
+	uint instanceOffset;
+};
+
 struct GI_CB
 {
 	matrix p;
@@ -1,6 +1,9 @@
 // shadertype=hlsl
 #include "common/common.hlsl"
 
+StructuredBuffer<uint> instanceSBuffer : register(t13);
+StructuredBuffer<PerObject_CB> perObjectSBuffer : register(t14);
+
 struct VertexInputType
 {
 	float4 position : POSITION;
@@ -8,6 +11,7 @@ struct VertexInputType
 	float2 pada : PADA;
 	float4 normal : NORMAL;
 	float4 padb : PADB;
+	uint instanceId : SV_InstanceID;
 };
 
 struct PixelInputType
@@ -23,12 +27,13 @@ struct PixelInputType
 PixelInputType main(VertexInputType input)
 {
 	PixelInputType output;
+	PerObject_CB perObjectData = perObjectSBuffer[instanceSBuffer[instanceCBuffer.instanceOffset + input.instanceId]];
 
-	float4 frag_WorldSpacePos = mul(input.position, perObjectCBuffer.m);
+	float4 frag_WorldSpacePos = mul(input.position, perObjectData.m);
 	float4 frag_CameraSpacePos = mul(frag_WorldSpacePos, perFrameCBuffer.v);
 	output.frag_ClipSpacePos_orig = mul(frag_CameraSpacePos, perFrameCBuffer.p_original);
 
-	float4 frag_WorldSpacePos_prev = mul(input.position, perObjectCBuffer.m_prev);
+	float4 frag_WorldSpacePos_prev = mul(input.position, perObjectData.m_prev);
 	float4 frag_CameraSpacePos_prev = mul(frag_WorldSpacePos_prev, perFrameCBuffer.v_prev);
 	output.frag_ClipSpacePos_prev = mul(frag_CameraSpacePos_prev, perFrameCBuffer.p_original);
 
@@ -36,7 +41,7 @@ PixelInputType main(VertexInputType input)
 
 	output.frag_WorldSpacePos = frag_WorldSpacePos.xyz;
 	output.frag_TexCoord = input.texcoord;
-	output.frag_Normal = mul(input.normal, perObjectCBuffer.normalMat).xyz;
+	output.frag_Normal = mul(input.normal, perObjectData.normalMat).xyz;
 
 	return output;
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 // shadertype=hlsl
 #include "common/common.hlsl"
 
+StructuredBuffer<uint> instanceSBuffer : register(t13);
+StructuredBuffer<PerObject_CB> perObjectSBuffer : register(t14);
+
 struct VertexInputType
 {
 	float4 position : POSITION;
@@ -8,6 +11,7 @@ struct VertexInputType
 	float2 pada : PADA;
 	float4 normal : NORMAL;
 	float4 padb : PADB;
+	uint instanceId : SV_InstanceID;
 };
 
 struct GeometryInputType
@@ -19,6 +23,6 @@ GeometryInputType main(VertexInputType input)
 {
 	GeometryInputType output;
 
-	output.posWS = mul(input.position, perObjectCBuffer.m);
+	output.posWS = mul(input.position, perObjectSBuffer[instanceSBuffer[instanceCBuffer.instanceOffset + input.instanceId]].m);
 	return output;
 }
\ No newline at end of file
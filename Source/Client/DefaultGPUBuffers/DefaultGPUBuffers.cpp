@@ -7,6 +7,7 @@ namespace DefaultGPUBuffers
 {
 	GPUBufferDataComponent* m_PerFrameCBufferGBDC;
 	GPUBufferDataComponent* m_MeshGBDC;
+	GPUBufferDataComponent* m_MeshStructuredGBDC;
 	GPUBufferDataComponent* m_MaterialGBDC;
 	GPUBufferDataComponent* m_VolumetricFogPassMeshGBDC;
 	GPUBufferDataComponent* m_VolumetricFogPassMaterialGBDC;
@@ -16,6 +17,8 @@ namespace DefaultGPUBuffers
 	GPUBufferDataComponent* m_dispatchParamsGBDC;
 	GPUBufferDataComponent* m_GICBufferGBDC;
 	GPUBufferDataComponent* m_billboardGBDC;
+	GPUBufferDataComponent* m_instanceGBDC;
+	GPUBufferDataComponent* m_instanceCBufferGBDC;
 
 	std::vector<DispatchParamsConstantBuffer> m_DispatchParamsConstantBuffer;
 }
@@ -43,6 +46,15 @@ bool DefaultGPUBuffers::Initialize()
 
 	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_MeshGBDC);
 
+	// The same per-object data as a structured buffer, the instanced draw calls index it by the instance buffer
+	m_MeshStructuredGBDC = g_pModuleManager->getRenderingServer()->AddGPUBufferDataComponent("PerObjectSBuffer/");
+	m_MeshStructuredGBDC->m_ElementCount = l_RenderingCapability.maxMeshes;
+	m_MeshStructuredGBDC->m_ElementSize = sizeof(PerObjectConstantBuffer);
+	m_MeshStructuredGBDC->m_BindingPoint = 14;
+	m_MeshStructuredGBDC->m_GPUAccessibility = Accessibility::ReadWrite;
+
+	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_MeshStructuredGBDC);
+
 	m_MaterialGBDC = g_pModuleManager->getRenderingServer()->AddGPUBufferDataComponent("MaterialCBuffer/");
 	m_MaterialGBDC->m_ElementCount = l_RenderingCapability.maxMaterials;
 	m_MaterialGBDC->m_ElementSize = sizeof(MaterialConstantBuffer);
@@ -108,6 +120,22 @@ bool DefaultGPUBuffers::Initialize()
 
 	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_billboardGBDC);
 
+	m_instanceGBDC = g_pModuleManager->getRenderingServer()->AddGPUBufferDataComponent("InstanceSBuffer/");
+	m_instanceGBDC->m_ElementCount = l_RenderingCapability.maxMeshes;
+	m_instanceGBDC->m_ElementSize = sizeof(uint32_t);
+	m_instanceGBDC->m_BindingPoint = 13;
+	m_instanceGBDC->m_GPUAccessibility = Accessibility::ReadWrite;
+
+	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_instanceGBDC);
+
+	// The structured buffer views ignore the start offset, so the offset of each instanced draw call is bound as a constant buffer element
+	m_instanceCBufferGBDC = g_pModuleManager->getRenderingServer()->AddGPUBufferDataComponent("InstanceCBuffer/");
+	m_instanceCBufferGBDC->m_ElementCount = l_RenderingCapability.maxMeshes;
+	m_instanceCBufferGBDC->m_ElementSize = sizeof(InstanceConstantBuffer);
+	m_instanceCBufferGBDC->m_BindingPoint = 10;
+
+	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_instanceCBufferGBDC);
+
 	return true;
 }
 
@@ -115,31 +143,27 @@ bool DefaultGPUBuffers::Upload()
 {
 	auto l_PerFrameConstantBuffer = g_pModuleManager->getRenderingFrontend()->getPerFrameConstantBuffer();
 	auto& l_PerObjectConstantBuffer = g_pModuleManager->getRenderingFrontend()->getPerObjectConstantBuffer();
-	auto l_TotalDrawCallCount = l_PerObjectConstantBuffer.size();
+	auto& l_PerObjectConstantBufferDirtyRanges = g_pModuleManager->getRenderingFrontend()->getPerObjectConstantBufferDirtyRanges();
 	auto& l_MaterialConstantBuffer = g_pModuleManager->getRenderingFrontend()->getMaterialConstantBuffer();
+	auto& l_MaterialConstantBufferDirtyRanges = g_pModuleManager->getRenderingFrontend()->getMaterialConstantBufferDirtyRanges();
 	auto& l_PointLightConstantBuffer = g_pModuleManager->getRenderingFrontend()->getPointLightConstantBuffer();
+	auto& l_PointLightConstantBufferDirtyRanges = g_pModuleManager->getRenderingFrontend()->getPointLightConstantBufferDirtyRanges();
 	auto& l_SphereLightConstantBuffer = g_pModuleManager->getRenderingFrontend()->getSphereLightConstantBuffer();
+	auto& l_SphereLightConstantBufferDirtyRanges = g_pModuleManager->getRenderingFrontend()->getSphereLightConstantBufferDirtyRanges();
 	auto& l_CSMConstantBuffer = g_pModuleManager->getRenderingFrontend()->getCSMConstantBuffer();
 	auto& l_billboardPassPerObjectConstantBuffer = g_pModuleManager->getRenderingFrontend()->getBillboardPassPerObjectConstantBuffer();
+	auto& l_instanceIndices = g_pModuleManager->getRenderingFrontend()->getInstanceIndices();
+	auto& l_instanceConstantBuffer = g_pModuleManager->getRenderingFrontend()->getInstanceConstantBuffer();
 
 	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_PerFrameCBufferGBDC, &l_PerFrameConstantBuffer);
 
-	if (l_PerObjectConstantBuffer.size() > 0)
-	{
-		g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_MeshGBDC, l_PerObjectConstantBuffer, 0, l_TotalDrawCallCount);
-	}
-	if (l_MaterialConstantBuffer.size() > 0)
-	{
-		g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_MaterialGBDC, l_MaterialConstantBuffer, 0, l_TotalDrawCallCount);
-	}
-	if (l_PointLightConstantBuffer.size() > 0)
-	{
-		g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_PointLightGBDC, l_PointLightConstantBuffer, 0, l_PointLightConstantBuffer.size());
-	}
-	if (l_SphereLightConstantBuffer.size() > 0)
-	{
-		g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_SphereLightGBDC, l_SphereLightConstantBuffer, 0, l_SphereLightConstantBuffer.size());
-	}
+	// The frontend keeps these buffers between the frames, so only the ranges it changed are uploaded
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_MeshGBDC, l_PerObjectConstantBuffer, l_PerObjectConstantBufferDirtyRanges);
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_MeshStructuredGBDC, l_PerObjectConstantBuffer, l_PerObjectConstantBufferDirtyRanges);
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_MaterialGBDC, l_MaterialConstantBuffer, l_MaterialConstantBufferDirtyRanges);
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_PointLightGBDC, l_PointLightConstantBuffer, l_PointLightConstantBufferDirtyRanges);
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_SphereLightGBDC, l_SphereLightConstantBuffer, l_SphereLightConstantBufferDirtyRanges);
+
 	if (l_CSMConstantBuffer.size() > 0)
 	{
 		g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_CSMGBDC, l_CSMConstantBuffer);
@@ -148,6 +172,14 @@ bool DefaultGPUBuffers::Upload()
 	{
 		g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_billboardGBDC, l_billboardPassPerObjectConstantBuffer, 0, l_billboardPassPerObjectConstantBuffer.size());
 	}
+	if (l_instanceIndices.size() > 0)
+	{
+		g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_instanceGBDC, l_instanceIndices, 0, l_instanceIndices.size());
+	}
+	if (l_instanceConstantBuffer.size() > 0)
+	{
+		g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_instanceCBufferGBDC, l_instanceConstantBuffer, 0, l_instanceConstantBuffer.size());
+	}
 
 	return true;
 }
@@ -156,6 +188,7 @@ bool DefaultGPUBuffers::Terminate()
 {
 	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_PerFrameCBufferGBDC);
 	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_MeshGBDC);
+	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_MeshStructuredGBDC);
 	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_MaterialGBDC);
 	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_PointLightGBDC);
 	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_SphereLightGBDC);
@@ -163,6 +196,8 @@ bool DefaultGPUBuffers::Terminate()
 	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_dispatchParamsGBDC);
 	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_GICBufferGBDC);
 	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_billboardGBDC);
+	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_instanceGBDC);
+	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_instanceCBufferGBDC);
 
 	return true;
 }
@@ -177,6 +212,8 @@ GPUBufferDataComponent * DefaultGPUBuffers::GetGPUBufferDataComponent(GPUBufferU
 		break;
 	case GPUBufferUsageType::Mesh: l_result = m_MeshGBDC;
 		break;
+	case GPUBufferUsageType::MeshStructured: l_result = m_MeshStructuredGBDC;
+		break;
 	case GPUBufferUsageType::Material: l_result = m_MaterialGBDC;
 		break;
 	case GPUBufferUsageType::VolumetricFogPassMesh: l_result = m_VolumetricFogPassMeshGBDC;
@@ -195,6 +232,10 @@ GPUBufferDataComponent * DefaultGPUBuffers::GetGPUBufferDataComponent(GPUBufferU
 		break;
 	case GPUBufferUsageType::Billboard: l_result = m_billboardGBDC;
 		break;
+	case GPUBufferUsageType::Instance: l_result = m_instanceGBDC;
+		break;
+	case GPUBufferUsageType::InstanceConstant: l_result = m_instanceCBufferGBDC;
+		break;
 	default:
 		break;
 	}
@@ -7,6 +7,7 @@ namespace DefaultGPUBuffers
 	{
 		PerFrame,
 		Mesh,
+		MeshStructured,
 		Material,
 		VolumetricFogPassMesh,
 		VolumetricFogPassMaterial,
@@ -15,7 +16,9 @@ namespace DefaultGPUBuffers
 		CSM,
 		ComputeDispatchParam,
 		GI,
-		Billboard
+		Billboard,
+		Instance,
+		InstanceConstant
 	};
 
 	bool Setup();
@@ -625,7 +625,7 @@ bool GameClientNS::update()
 	{
 		if (allowUpdate)
 		{
-			auto l_tickTime = g_pModuleManager->getTickTime();
+			auto l_tickTime = g_pModuleManager->getFixedTimeStep();
 			seed += (l_tickTime / 1000.0f);
 
 			auto l_seed = (1.0f - l_tickTime / 100.0f);
@@ -14,9 +14,17 @@ namespace BSDFTestPass
 	RenderPassDataComponent* m_RPDC;
 	ShaderProgramComponent* m_SPC;
 	SamplerDataComponent* m_SDC;
+	// The shared material constant buffers are only uploaded when the scene materials change, so the test materials need their own buffer
+	GPUBufferDataComponent* m_materialGBDC;
+	// The shared per-object buffer is persistent and the shared instance buffer holds the indices of the scene objects, so the test spheres have their own ones too
+	GPUBufferDataComponent* m_meshGBDC;
+	GPUBufferDataComponent* m_instanceGBDC;
+	GPUBufferDataComponent* m_instanceCBufferGBDC;
 
 	std::vector<PerObjectConstantBuffer> m_meshConstantBuffer;
 	std::vector<MaterialConstantBuffer> m_materialConstantBuffer;
+	std::vector<uint32_t> m_instanceIndices;
+	std::vector<InstanceConstantBuffer> m_instanceConstantBuffer;
 
 	const size_t m_shpereCount = 10;
 }
@@ -47,14 +55,16 @@ bool BSDFTestPass::Setup()
 
 	m_RPDC->m_RenderPassDesc = l_RenderPassDesc;
 
-	m_RPDC->m_ResourceBinderLayoutDescs.resize(6);
+	m_RPDC->m_ResourceBinderLayoutDescs.resize(8);
 	m_RPDC->m_ResourceBinderLayoutDescs[0].m_ResourceBinderType = ResourceBinderType::Buffer;
 	m_RPDC->m_ResourceBinderLayoutDescs[0].m_DescriptorSetIndex = 0;
 	m_RPDC->m_ResourceBinderLayoutDescs[0].m_DescriptorIndex = 0;
 
 	m_RPDC->m_ResourceBinderLayoutDescs[1].m_ResourceBinderType = ResourceBinderType::Buffer;
 	m_RPDC->m_ResourceBinderLayoutDescs[1].m_DescriptorSetIndex = 0;
-	m_RPDC->m_ResourceBinderLayoutDescs[1].m_DescriptorIndex = 1;
+	m_RPDC->m_ResourceBinderLayoutDescs[1].m_DescriptorIndex = 13;
+	m_RPDC->m_ResourceBinderLayoutDescs[1].m_BinderAccessibility = Accessibility::ReadOnly;
+	m_RPDC->m_ResourceBinderLayoutDescs[1].m_ResourceAccessibility = Accessibility::ReadWrite;
 
 	m_RPDC->m_ResourceBinderLayoutDescs[2].m_ResourceBinderType = ResourceBinderType::Buffer;
 	m_RPDC->m_ResourceBinderLayoutDescs[2].m_DescriptorSetIndex = 0;
@@ -75,6 +85,16 @@ bool BSDFTestPass::Setup()
 	m_RPDC->m_ResourceBinderLayoutDescs[5].m_DescriptorIndex = 0;
 	m_RPDC->m_ResourceBinderLayoutDescs[5].m_IndirectBinding = true;
 
+	m_RPDC->m_ResourceBinderLayoutDescs[6].m_ResourceBinderType = ResourceBinderType::Buffer;
+	m_RPDC->m_ResourceBinderLayoutDescs[6].m_DescriptorSetIndex = 0;
+	m_RPDC->m_ResourceBinderLayoutDescs[6].m_DescriptorIndex = 14;
+	m_RPDC->m_ResourceBinderLayoutDescs[6].m_BinderAccessibility = Accessibility::ReadOnly;
+	m_RPDC->m_ResourceBinderLayoutDescs[6].m_ResourceAccessibility = Accessibility::ReadWrite;
+
+	m_RPDC->m_ResourceBinderLayoutDescs[7].m_ResourceBinderType = ResourceBinderType::Buffer;
+	m_RPDC->m_ResourceBinderLayoutDescs[7].m_DescriptorSetIndex = 0;
+	m_RPDC->m_ResourceBinderLayoutDescs[7].m_DescriptorIndex = 10;
+
 	m_RPDC->m_ShaderProgram = m_SPC;
 
 	m_SDC = g_pModuleManager->getRenderingServer()->AddSamplerDataComponent("BSDFTestPass/");
@@ -85,6 +105,45 @@ bool BSDFTestPass::Setup()
 	m_meshConstantBuffer.resize(l_RenderingCapability.maxMeshes);
 	m_materialConstantBuffer.resize(l_RenderingCapability.maxMaterials);
 
+	m_materialGBDC = g_pModuleManager->getRenderingServer()->AddGPUBufferDataComponent("BSDFTestPassMaterialCBuffer/");
+	m_materialGBDC->m_ElementCount = l_RenderingCapability.maxMaterials;
+	m_materialGBDC->m_ElementSize = sizeof(MaterialConstantBuffer);
+	m_materialGBDC->m_BindingPoint = 2;
+
+	// The binding points at creation differ from the shared buffers' ones, so they're not replaced by the test buffers, the test buffers are bound explicitly
+	m_meshGBDC = g_pModuleManager->getRenderingServer()->AddGPUBufferDataComponent("BSDFTestPassPerObjectSBuffer/");
+	m_meshGBDC->m_ElementCount = l_RenderingCapability.maxMeshes;
+	m_meshGBDC->m_ElementSize = sizeof(PerObjectConstantBuffer);
+	m_meshGBDC->m_BindingPoint = 15;
+	m_meshGBDC->m_GPUAccessibility = Accessibility::ReadWrite;
+
+	m_instanceGBDC = g_pModuleManager->getRenderingServer()->AddGPUBufferDataComponent("BSDFTestPassInstanceSBuffer/");
+	m_instanceGBDC->m_ElementCount = l_RenderingCapability.maxMeshes;
+	m_instanceGBDC->m_ElementSize = sizeof(uint32_t);
+	m_instanceGBDC->m_BindingPoint = 16;
+	m_instanceGBDC->m_GPUAccessibility = Accessibility::ReadWrite;
+
+	m_instanceCBufferGBDC = g_pModuleManager->getRenderingServer()->AddGPUBufferDataComponent("BSDFTestPassInstanceCBuffer/");
+	m_instanceCBufferGBDC->m_ElementCount = m_shpereCount * m_shpereCount;
+	m_instanceCBufferGBDC->m_ElementSize = sizeof(InstanceConstantBuffer);
+	m_instanceCBufferGBDC->m_BindingPoint = 11;
+
+	m_instanceIndices.resize(l_RenderingCapability.maxMeshes);
+
+	for (uint32_t i = 0; i < m_instanceIndices.size(); i++)
+	{
+		m_instanceIndices[i] = i;
+	}
+
+	// Each test sphere is drawn alone, from its own offset
+	m_instanceConstantBuffer.resize(m_shpereCount * m_shpereCount);
+
+	for (uint32_t i = 0; i < m_instanceConstantBuffer.size(); i++)
+	{
+		m_instanceConstantBuffer[i] = {};
+		m_instanceConstantBuffer[i].instanceOffset = i;
+	}
+
 	size_t l_index = 0;
 
 	auto l_interval = 4.0f;
@@ -118,6 +177,15 @@ bool BSDFTestPass::Initialize()
 	g_pModuleManager->getRenderingServer()->InitializeShaderProgramComponent(m_SPC);
 	g_pModuleManager->getRenderingServer()->InitializeRenderPassDataComponent(m_RPDC);
 	g_pModuleManager->getRenderingServer()->InitializeSamplerDataComponent(m_SDC);
+	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_materialGBDC);
+	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_meshGBDC);
+	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_instanceGBDC);
+	g_pModuleManager->getRenderingServer()->InitializeGPUBufferDataComponent(m_instanceCBufferGBDC);
+
+	// The test spheres never change
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_meshGBDC, m_meshConstantBuffer);
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_instanceGBDC, m_instanceIndices);
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_instanceCBufferGBDC, m_instanceConstantBuffer);
 
 	return true;
 }
@@ -125,11 +193,8 @@ bool BSDFTestPass::Initialize()
 bool BSDFTestPass::PrepareCommandList()
 {
 	auto l_PerFrameCBufferGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::PerFrame);
-	auto l_MeshGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::Mesh);
-	auto l_MaterialGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::Material);
 
-	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(l_MeshGBDC, m_meshConstantBuffer);
-	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(l_MaterialGBDC, m_materialConstantBuffer);
+	g_pModuleManager->getRenderingServer()->UploadGPUBufferDataComponent(m_materialGBDC, m_materialConstantBuffer);
 
 	g_pModuleManager->getRenderingServer()->CommandListBegin(m_RPDC, 0);
 	g_pModuleManager->getRenderingServer()->BindRenderPassDataComponent(m_RPDC);
@@ -137,6 +202,8 @@ bool BSDFTestPass::PrepareCommandList()
 	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, m_SDC->m_ResourceBinder, 5, 0);
 
 	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_PerFrameCBufferGBDC->m_ResourceBinder, 0, 0, Accessibility::ReadOnly);
+	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, m_instanceGBDC->m_ResourceBinder, 1, 13, Accessibility::ReadOnly);
+	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, m_meshGBDC->m_ResourceBinder, 6, 14, Accessibility::ReadOnly);
 	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_PerFrameCBufferGBDC->m_ResourceBinder, 0, 0, Accessibility::ReadOnly);
 
 	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, BRDFLUTPass::GetBRDFLUT(), 3, 0);
@@ -148,8 +215,8 @@ bool BSDFTestPass::PrepareCommandList()
 
 	for (size_t i = 0; i < m_shpereCount * m_shpereCount; i++)
 	{
-		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_MeshGBDC->m_ResourceBinder, 1, 1, Accessibility::ReadOnly, l_offset, 1);
-		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_MaterialGBDC->m_ResourceBinder, 2, 2, Accessibility::ReadOnly, l_offset, 1);
+		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, m_instanceCBufferGBDC->m_ResourceBinder, 7, 10, Accessibility::ReadOnly, l_offset, 1);
+		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, m_materialGBDC->m_ResourceBinder, 2, 2, Accessibility::ReadOnly, l_offset, 1);
 		g_pModuleManager->getRenderingServer()->DispatchDrawCall(m_RPDC, l_mesh);
 
 		l_offset++;
@@ -175,6 +242,10 @@ bool BSDFTestPass::ExecuteCommandList()
 bool BSDFTestPass::Terminate()
 {
 	g_pModuleManager->getRenderingServer()->DeleteRenderPassDataComponent(m_RPDC);
+	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_materialGBDC);
+	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_meshGBDC);
+	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_instanceGBDC);
+	g_pModuleManager->getRenderingServer()->DeleteGPUBufferDataComponent(m_instanceCBufferGBDC);
 
 	return true;
 }
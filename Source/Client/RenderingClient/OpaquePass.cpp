@@ -12,6 +12,9 @@ namespace OpaquePass
 	RenderPassDataComponent* m_RPDC;
 	ShaderProgramComponent* m_SPC;
 	SamplerDataComponent* m_SDC;
+
+	void ActivateMaterial(MaterialDataComponent* material);
+	void DeactivateMaterial(MaterialDataComponent* material);
 }
 
 bool OpaquePass::Setup()
@@ -43,14 +46,16 @@ bool OpaquePass::Setup()
 
 	m_RPDC->m_RenderPassDesc = l_RenderPassDesc;
 
-	m_RPDC->m_ResourceBinderLayoutDescs.resize(9);
+	m_RPDC->m_ResourceBinderLayoutDescs.resize(11);
 	m_RPDC->m_ResourceBinderLayoutDescs[0].m_ResourceBinderType = ResourceBinderType::Buffer;
 	m_RPDC->m_ResourceBinderLayoutDescs[0].m_DescriptorSetIndex = 0;
 	m_RPDC->m_ResourceBinderLayoutDescs[0].m_DescriptorIndex = 0;
 
 	m_RPDC->m_ResourceBinderLayoutDescs[1].m_ResourceBinderType = ResourceBinderType::Buffer;
 	m_RPDC->m_ResourceBinderLayoutDescs[1].m_DescriptorSetIndex = 0;
-	m_RPDC->m_ResourceBinderLayoutDescs[1].m_DescriptorIndex = 1;
+	m_RPDC->m_ResourceBinderLayoutDescs[1].m_DescriptorIndex = 13;
+	m_RPDC->m_ResourceBinderLayoutDescs[1].m_BinderAccessibility = Accessibility::ReadOnly;
+	m_RPDC->m_ResourceBinderLayoutDescs[1].m_ResourceAccessibility = Accessibility::ReadWrite;
 
 	m_RPDC->m_ResourceBinderLayoutDescs[2].m_ResourceBinderType = ResourceBinderType::Buffer;
 	m_RPDC->m_ResourceBinderLayoutDescs[2].m_DescriptorSetIndex = 0;
@@ -91,6 +96,16 @@ bool OpaquePass::Setup()
 	m_RPDC->m_ResourceBinderLayoutDescs[8].m_DescriptorIndex = 0;
 	m_RPDC->m_ResourceBinderLayoutDescs[8].m_IndirectBinding = true;
 
+	m_RPDC->m_ResourceBinderLayoutDescs[9].m_ResourceBinderType = ResourceBinderType::Buffer;
+	m_RPDC->m_ResourceBinderLayoutDescs[9].m_DescriptorSetIndex = 0;
+	m_RPDC->m_ResourceBinderLayoutDescs[9].m_DescriptorIndex = 14;
+	m_RPDC->m_ResourceBinderLayoutDescs[9].m_BinderAccessibility = Accessibility::ReadOnly;
+	m_RPDC->m_ResourceBinderLayoutDescs[9].m_ResourceAccessibility = Accessibility::ReadWrite;
+
+	m_RPDC->m_ResourceBinderLayoutDescs[10].m_ResourceBinderType = ResourceBinderType::Buffer;
+	m_RPDC->m_ResourceBinderLayoutDescs[10].m_DescriptorSetIndex = 0;
+	m_RPDC->m_ResourceBinderLayoutDescs[10].m_DescriptorIndex = 10;
+
 	m_RPDC->m_ShaderProgram = m_SPC;
 
 	m_SDC = g_pModuleManager->getRenderingServer()->AddSamplerDataComponent("OpaquePass/");
@@ -110,10 +125,36 @@ bool OpaquePass::Initialize()
 	return true;
 }
 
+void OpaquePass::ActivateMaterial(MaterialDataComponent* material)
+{
+	if (material != nullptr && material->m_ObjectStatus == ObjectStatus::Activated)
+	{
+		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[0].m_Texture->m_ResourceBinder, 3, 0);
+		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[1].m_Texture->m_ResourceBinder, 4, 1);
+		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[2].m_Texture->m_ResourceBinder, 5, 2);
+		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[3].m_Texture->m_ResourceBinder, 6, 3);
+		g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[4].m_Texture->m_ResourceBinder, 7, 4);
+	}
+}
+
+void OpaquePass::DeactivateMaterial(MaterialDataComponent* material)
+{
+	if (material != nullptr && material->m_ObjectStatus == ObjectStatus::Activated)
+	{
+		g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[0].m_Texture->m_ResourceBinder, 3, 0);
+		g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[1].m_Texture->m_ResourceBinder, 4, 1);
+		g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[2].m_Texture->m_ResourceBinder, 5, 2);
+		g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[3].m_Texture->m_ResourceBinder, 6, 3);
+		g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, material->m_TextureSlots[4].m_Texture->m_ResourceBinder, 7, 4);
+	}
+}
+
 bool OpaquePass::PrepareCommandList()
 {
 	auto l_PerFrameCBufferGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::PerFrame);
-	auto l_MeshGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::Mesh);
+	auto l_InstanceGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::Instance);
+	auto l_InstanceCBufferGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::InstanceConstant);
+	auto l_MeshStructuredGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::MeshStructured);
 	auto l_MaterialGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::Material);
 
 	g_pModuleManager->getRenderingServer()->CommandListBegin(m_RPDC, 0);
@@ -121,43 +162,46 @@ bool OpaquePass::PrepareCommandList()
 	g_pModuleManager->getRenderingServer()->CleanRenderTargets(m_RPDC);
 	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, m_SDC->m_ResourceBinder, 8, 0);
 	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_PerFrameCBufferGBDC->m_ResourceBinder, 0, 0, Accessibility::ReadOnly);
+	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_InstanceGBDC->m_ResourceBinder, 1, 13, Accessibility::ReadOnly);
+	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_MeshStructuredGBDC->m_ResourceBinder, 9, 14, Accessibility::ReadOnly);
 
-	auto& l_drawCallInfo = g_pModuleManager->getRenderingFrontend()->getDrawCallInfo();
+	auto& l_drawCallInfo = g_pModuleManager->getRenderingFrontend()->getInstancedDrawCallInfo();
 	auto l_drawCallCount = l_drawCallInfo.size();
 
+	// The draw calls are sorted by the material, so the material constant buffer and the textures are only rebound when it changes
+	MaterialDataComponent* l_boundMaterial = nullptr;
+	uint32_t l_boundMaterialConstantBufferIndex = UINT32_MAX;
+
 	for (uint32_t i = 0; i < l_drawCallCount; i++)
 	{
 		auto l_drawCallData = l_drawCallInfo[i];
-		if (l_drawCallData.visibilityType == VisibilityType::Opaque)
+		if (l_drawCallData.visibleInMainCamera)
 		{
 			if (l_drawCallData.mesh->m_ObjectStatus == ObjectStatus::Activated)
 			{
-				g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_MeshGBDC->m_ResourceBinder, 1, 1, Accessibility::ReadOnly, l_drawCallData.meshConstantBufferIndex, 1);
-				g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_MaterialGBDC->m_ResourceBinder, 2, 2, Accessibility::ReadOnly, l_drawCallData.materialConstantBufferIndex, 1);
+				// The whole instance buffer is bound, the vertex shader reads from the offset of the draw call
+				g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_InstanceCBufferGBDC->m_ResourceBinder, 10, 10, Accessibility::ReadOnly, i, 1);
 
-				if (l_drawCallData.material->m_ObjectStatus == ObjectStatus::Activated)
+				if (l_boundMaterialConstantBufferIndex != l_drawCallData.materialConstantBufferIndex)
 				{
-					g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[0].m_Texture->m_ResourceBinder, 3, 0);
-					g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[1].m_Texture->m_ResourceBinder, 4, 1);
-					g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[2].m_Texture->m_ResourceBinder, 5, 2);
-					g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[3].m_Texture->m_ResourceBinder, 6, 3);
-					g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[4].m_Texture->m_ResourceBinder, 7, 4);
+					g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_MaterialGBDC->m_ResourceBinder, 2, 2, Accessibility::ReadOnly, l_drawCallData.materialConstantBufferIndex, 1);
+					l_boundMaterialConstantBufferIndex = l_drawCallData.materialConstantBufferIndex;
 				}
 
-				g_pModuleManager->getRenderingServer()->DispatchDrawCall(m_RPDC, l_drawCallData.mesh);
-
-				if (l_drawCallData.material->m_ObjectStatus == ObjectStatus::Activated)
+				if (l_boundMaterial != l_drawCallData.material)
 				{
-					g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[0].m_Texture->m_ResourceBinder, 3, 0);
-					g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[1].m_Texture->m_ResourceBinder, 4, 1);
-					g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[2].m_Texture->m_ResourceBinder, 5, 2);
-					g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[3].m_Texture->m_ResourceBinder, 6, 3);
-					g_pModuleManager->getRenderingServer()->DeactivateResourceBinder(m_RPDC, ShaderStage::Pixel, l_drawCallData.material->m_TextureSlots[4].m_Texture->m_ResourceBinder, 7, 4);
+					DeactivateMaterial(l_boundMaterial);
+					ActivateMaterial(l_drawCallData.material);
+					l_boundMaterial = l_drawCallData.material;
 				}
+
+				g_pModuleManager->getRenderingServer()->DispatchDrawCall(m_RPDC, l_drawCallData.mesh, l_drawCallData.instanceCount);
 			}
 		}
 	}
 
+	DeactivateMaterial(l_boundMaterial);
+
 	g_pModuleManager->getRenderingServer()->CommandListEnd(m_RPDC);
 
 	return true;
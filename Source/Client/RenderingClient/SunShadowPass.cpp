@@ -48,15 +48,27 @@ bool SunShadowPass::Setup()
 
 	m_RPDC->m_RenderPassDesc = l_RenderPassDesc;
 
-	m_RPDC->m_ResourceBinderLayoutDescs.resize(2);
+	m_RPDC->m_ResourceBinderLayoutDescs.resize(4);
 	m_RPDC->m_ResourceBinderLayoutDescs[0].m_ResourceBinderType = ResourceBinderType::Buffer;
 	m_RPDC->m_ResourceBinderLayoutDescs[0].m_DescriptorSetIndex = 0;
-	m_RPDC->m_ResourceBinderLayoutDescs[0].m_DescriptorIndex = 1;
+	m_RPDC->m_ResourceBinderLayoutDescs[0].m_DescriptorIndex = 13;
+	m_RPDC->m_ResourceBinderLayoutDescs[0].m_BinderAccessibility = Accessibility::ReadOnly;
+	m_RPDC->m_ResourceBinderLayoutDescs[0].m_ResourceAccessibility = Accessibility::ReadWrite;
 
 	m_RPDC->m_ResourceBinderLayoutDescs[1].m_ResourceBinderType = ResourceBinderType::Buffer;
 	m_RPDC->m_ResourceBinderLayoutDescs[1].m_DescriptorSetIndex = 0;
 	m_RPDC->m_ResourceBinderLayoutDescs[1].m_DescriptorIndex = 5;
 
+	m_RPDC->m_ResourceBinderLayoutDescs[2].m_ResourceBinderType = ResourceBinderType::Buffer;
+	m_RPDC->m_ResourceBinderLayoutDescs[2].m_DescriptorSetIndex = 0;
+	m_RPDC->m_ResourceBinderLayoutDescs[2].m_DescriptorIndex = 14;
+	m_RPDC->m_ResourceBinderLayoutDescs[2].m_BinderAccessibility = Accessibility::ReadOnly;
+	m_RPDC->m_ResourceBinderLayoutDescs[2].m_ResourceAccessibility = Accessibility::ReadWrite;
+
+	m_RPDC->m_ResourceBinderLayoutDescs[3].m_ResourceBinderType = ResourceBinderType::Buffer;
+	m_RPDC->m_ResourceBinderLayoutDescs[3].m_DescriptorSetIndex = 0;
+	m_RPDC->m_ResourceBinderLayoutDescs[3].m_DescriptorIndex = 10;
+
 	m_RPDC->m_ShaderProgram = m_SPC;
 
 	return true;
@@ -72,27 +84,31 @@ bool SunShadowPass::Initialize()
 
 bool SunShadowPass::PrepareCommandList()
 {
-	auto l_MeshGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::Mesh);
+	auto l_InstanceGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::Instance);
+	auto l_InstanceCBufferGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::InstanceConstant);
+	auto l_MeshStructuredGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::MeshStructured);
 	auto l_CSMGBDC = GetGPUBufferDataComponent(GPUBufferUsageType::CSM);
 
 	g_pModuleManager->getRenderingServer()->CommandListBegin(m_RPDC, 0);
 	g_pModuleManager->getRenderingServer()->BindRenderPassDataComponent(m_RPDC);
 	g_pModuleManager->getRenderingServer()->CleanRenderTargets(m_RPDC);
 	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Geometry, l_CSMGBDC->m_ResourceBinder, 1, 5, Accessibility::ReadOnly);
+	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_InstanceGBDC->m_ResourceBinder, 0, 13, Accessibility::ReadOnly);
+	g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_MeshStructuredGBDC->m_ResourceBinder, 2, 14, Accessibility::ReadOnly);
 
-	auto& l_drawCallInfo = g_pModuleManager->getRenderingFrontend()->getDrawCallInfo();
+	auto& l_drawCallInfo = g_pModuleManager->getRenderingFrontend()->getInstancedDrawCallInfo();
 	auto l_drawCallCount = l_drawCallInfo.size();
 
 	for (uint32_t i = 0; i < l_drawCallCount; i++)
 	{
 		auto l_drawCallData = l_drawCallInfo[i];
-		if (l_drawCallData.castSunShadow && l_drawCallData.visibilityType == VisibilityType::Opaque)
+		if (l_drawCallData.castSunShadow)
 		{
 			if (l_drawCallData.mesh->m_ObjectStatus == ObjectStatus::Activated)
 			{
-				g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_MeshGBDC->m_ResourceBinder, 0, 1, Accessibility::ReadOnly, l_drawCallData.meshConstantBufferIndex, 1);
+				g_pModuleManager->getRenderingServer()->ActivateResourceBinder(m_RPDC, ShaderStage::Vertex, l_InstanceCBufferGBDC->m_ResourceBinder, 3, 10, Accessibility::ReadOnly, i, 1);
 
-				g_pModuleManager->getRenderingServer()->DispatchDrawCall(m_RPDC, l_drawCallData.mesh);
+				g_pModuleManager->getRenderingServer()->DispatchDrawCall(m_RPDC, l_drawCallData.mesh, l_drawCallData.instanceCount);
 			}
 		}
 	}
@@ -95,7 +95,7 @@ bool TransparentPass::PrepareCommandList()
 	for (uint32_t i = 0; i < l_drawCallCount; i++)
 	{
 		auto l_drawCallData = l_drawCallInfo[i];
-		if (l_drawCallData.visibilityType == VisibilityType::Transparent)
+		if (l_drawCallData.visibleInMainCamera && l_drawCallData.visibilityType == VisibilityType::Transparent)
 		{
 			if (l_drawCallData.mesh->m_ObjectStatus == ObjectStatus::Activated)
 			{
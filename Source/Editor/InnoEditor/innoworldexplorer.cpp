@@ -26,7 +26,7 @@ void InnoWorldExplorer::buildTree()
 
 	auto l_sceneHierarchyMap = g_pModuleManager->getSceneHierarchyManager()->GetSceneHierarchyMap();
 
-	for (auto& i : l_sceneHierarchyMap)
+	for (auto i : *l_sceneHierarchyMap)
 	{
 		if (i.first->m_ObjectSource == ObjectSource::Asset)
 		{
@@ -42,7 +42,7 @@ void InnoWorldExplorer::buildTree()
 			for (auto& j : i.second)
 			{
 				QTreeWidgetItem* l_componentItem = new QTreeWidgetItem();
-				l_componentItem->setText(0, j->m_ComponentName.c_str());
+				l_componentItem->setText(0, j->GetDebugName().c_str());
 
 				l_componentItem->setData(0, Qt::UserRole, QVariant((int)j->m_ComponentType));
 				l_componentItem->setData(1, Qt::UserRole, QVariant::fromValue((void*)j));
@@ -126,7 +126,7 @@ void InnoWorldExplorer::endRename()
 	else
 	{
 		auto l_entityPtr = reinterpret_cast<InnoEntity*>(m_currentEditingItem->data(1, Qt::UserRole).value<void*>());
-		l_entityPtr->m_EntityName = (m_currentEditingItem->text(0).toStdString() + "/").c_str();
+		g_pModuleManager->getEntityManager()->Rename(l_entityPtr, (m_currentEditingItem->text(0).toStdString() + "/").c_str());
 	}
 
 	m_currentEditingItem->setFlags(m_currentEditingItem->flags() & ~Qt::ItemIsEditable);
@@ -186,7 +186,7 @@ void InnoWorldExplorer::addTransformComponent()
 
 		QTreeWidgetItem* l_componentItem = new QTreeWidgetItem();
 
-		l_componentItem->setText(0, l_componentPtr->m_ComponentName.c_str());
+		l_componentItem->setText(0, l_componentPtr->GetDebugName().c_str());
 		l_componentItem->setData(0, Qt::UserRole, QVariant((int)ComponentType::TransformComponent));
 		l_componentItem->setData(1, Qt::UserRole, QVariant::fromValue((void*)l_componentPtr));
 
@@ -209,7 +209,7 @@ void InnoWorldExplorer::addVisibleComponent()
 
         QTreeWidgetItem* l_componentItem = new QTreeWidgetItem();
 
-        l_componentItem->setText(0, l_componentPtr->m_ComponentName.c_str());
+        l_componentItem->setText(0, l_componentPtr->GetDebugName().c_str());
         l_componentItem->setData(0, Qt::UserRole, QVariant((int)ComponentType::VisibleComponent));
         l_componentItem->setData(1, Qt::UserRole, QVariant::fromValue((void*)l_componentPtr));
 
@@ -232,7 +232,7 @@ void InnoWorldExplorer::addLightComponent()
 
         QTreeWidgetItem* l_componentItem = new QTreeWidgetItem();
 
-        l_componentItem->setText(0, l_componentPtr->m_ComponentName.c_str());
+        l_componentItem->setText(0, l_componentPtr->GetDebugName().c_str());
         l_componentItem->setData(0, Qt::UserRole, QVariant((int)ComponentType::LightComponent));
         l_componentItem->setData(1, Qt::UserRole, QVariant::fromValue((void*)l_componentPtr));
 
@@ -255,7 +255,7 @@ void InnoWorldExplorer::addCameraComponent()
 
         QTreeWidgetItem* l_componentItem = new QTreeWidgetItem();
 
-        l_componentItem->setText(0, l_componentPtr->m_ComponentName.c_str());
+        l_componentItem->setText(0, l_componentPtr->GetDebugName().c_str());
         l_componentItem->setData(0, Qt::UserRole, QVariant((int)ComponentType::CameraComponent));
         l_componentItem->setData(1, Qt::UserRole, QVariant::fromValue((void*)l_componentPtr));
 
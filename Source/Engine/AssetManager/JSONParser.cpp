@@ -197,6 +197,8 @@ void InnoFileSystemNS::JSONParser::to_json(json& j, const VisibleComponent& p)
 		{"TextureWrapMethod", p.m_textureWrapMethod},
 		{"ModelFileName", p.m_modelFileName},
 		{"SimulatePhysics", p.m_simulatePhysics},
+		{"MinScreenSize", p.m_minScreenSize},
+		{"MinShadowScreenSize", p.m_minShadowScreenSize},
 	};
 }
 
@@ -286,6 +288,15 @@ void InnoFileSystemNS::JSONParser::from_json(const json & j, VisibleComponent &
 	p.m_textureWrapMethod = j["TextureWrapMethod"];
 	p.m_modelFileName = j["ModelFileName"];
 	p.m_simulatePhysics = j["SimulatePhysics"];
+
+	if (j.find("MinScreenSize") != j.end())
+	{
+		p.m_minScreenSize = j["MinScreenSize"];
+	}
+	if (j.find("MinShadowScreenSize") != j.end())
+	{
+		p.m_minShadowScreenSize = j["MinShadowScreenSize"];
+	}
 }
 
 void InnoFileSystemNS::JSONParser::from_json(const json & j, LightComponent & p)
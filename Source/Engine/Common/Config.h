@@ -0,0 +1,2 @@
+#define USE_ROW_MAJOR_MEMORY_LAYOUT
+#define INNO_PLATFORM_LINUX
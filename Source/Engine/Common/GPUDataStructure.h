@@ -94,8 +94,40 @@ struct DrawCallInfo
 	MaterialDataComponent* material;
 	uint32_t meshConstantBufferIndex;
 	uint32_t materialConstantBufferIndex;
+	bool visibleInMainCamera;
 	bool castSunShadow;
+	uint32_t sunShadowCascadeMask;
 	VisibilityType visibilityType;
+	// The draw calls are sorted by it, see InnoRenderingFrontendNS::generateSortKey
+	uint64_t sortKey;
+};
+
+// A range of the elements which need to be uploaded to a persistent GPU buffer
+struct GPUBufferDirtyRange
+{
+	uint32_t startOffset;
+	uint32_t elementCount;
+};
+
+// The offset of the first instance in the instance buffer, it's bound per instanced draw call as a 256-byte constant buffer element
+struct alignas(16) InstanceConstantBuffer
+{
+	uint32_t instanceOffset;
+	uint32_t padding[63];
+};
+
+// The opaque draw calls which share the same mesh, material and culling channels are merged into one instanced draw call
+// The per-object constant buffer indices of the instances are contiguous in the instance buffer, from instanceConstantBufferOffset to instanceConstantBufferOffset + instanceCount - 1
+struct InstancedDrawCallInfo
+{
+	MeshDataComponent* mesh;
+	MaterialDataComponent* material;
+	uint32_t instanceConstantBufferOffset;
+	uint32_t instanceCount;
+	uint32_t materialConstantBufferIndex;
+	bool visibleInMainCamera;
+	bool castSunShadow;
+	uint32_t sunShadowCascadeMask;
 };
 
 struct BillboardPassDrawCallInfo
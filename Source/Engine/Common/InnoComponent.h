@@ -2,12 +2,45 @@
 #include "InnoType.h"
 #include "InnoEntity.h"
 
+inline const char* GetComponentTypeName(ComponentType componentType)
+{
+	switch (componentType)
+	{
+	case ComponentType::TransformComponent: return "TransformComponent";
+	case ComponentType::VisibleComponent: return "VisibleComponent";
+	case ComponentType::LightComponent: return "LightComponent";
+	case ComponentType::CameraComponent: return "CameraComponent";
+	case ComponentType::PhysicsDataComponent: return "PhysicsDataComponent";
+	case ComponentType::MeshDataComponent: return "MeshDataComponent";
+	case ComponentType::MaterialDataComponent: return "MaterialDataComponent";
+	case ComponentType::TextureDataComponent: return "TextureDataComponent";
+	case ComponentType::SkeletonDataComponent: return "SkeletonDataComponent";
+	case ComponentType::AnimationDataComponent: return "AnimationDataComponent";
+	case ComponentType::RenderPassDataComponent: return "RenderPassDataComponent";
+	case ComponentType::ShaderProgramComponent: return "ShaderProgramComponent";
+	case ComponentType::SamplerDataComponent: return "SamplerDataComponent";
+	case ComponentType::GPUBufferDataComponent: return "GPUBufferDataComponent";
+	default: return "UnknownComponent";
+	}
+}
+
 class InnoComponent
 {
 public:
 	InnoComponent() = default;
 	~InnoComponent() = default;
 
+	// Components spawned by the component managers are unnamed, "[EntityName].[ComponentType]_[UUID]" is built on each request so it follows the renaming of the parent entity
+	std::string GetDebugName() const
+	{
+		if (!m_ComponentName.empty() || !m_ParentEntity)
+		{
+			return m_ComponentName.c_str();
+		}
+
+		return std::string(m_ParentEntity->m_EntityName.c_str()) + "." + GetComponentTypeName(m_ComponentType) + "_" + std::to_string(m_UUID);
+	}
+
 	InnoEntity* m_ParentEntity = 0;
 	ComponentName m_ComponentName;
 	uint64_t m_UUID = 0;
@@ -15,4 +48,4 @@ public:
 	ObjectStatus m_ObjectStatus = ObjectStatus::Terminated;
 	ObjectSource m_ObjectSource = ObjectSource::Runtime;
 	ObjectOwnership m_ObjectOwnership = ObjectOwnership::Client;
-};
\ No newline at end of file
+};
@@ -470,6 +470,13 @@ public:
 		m_vector.emplace_back(values ...);
 	}
 
+	template <class InputIt>
+	void insert(typename std::vector<T>::const_iterator pos, InputIt first, InputIt last)
+	{
+		std::unique_lock<std::shared_mutex> lock{ m_mutex };
+		m_vector.insert(pos, first, last);
+	}
+
 	auto empty(void) const
 	{
 		std::shared_lock<std::shared_mutex> lock{ m_mutex };
@@ -0,0 +1,57 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// A 4 bytes handle to a string in the global string table
+class InternedString
+{
+public:
+	InternedString() = default;
+	InternedString(const InternedString& rhs) = default;
+	InternedString& operator=(const InternedString& rhs) = default;
+	~InternedString() = default;
+
+	// Same as FixedSizeString, the last character of the content is treated as the terminator
+	InternedString(const char* content);
+
+	bool operator==(const InternedString& rhs) const
+	{
+		return m_ID == rhs.m_ID;
+	}
+
+	bool operator!=(const InternedString& rhs) const
+	{
+		return m_ID != rhs.m_ID;
+	}
+
+	bool operator==(const char* rhs) const
+	{
+		return strcmp(c_str(), rhs) == 0;
+	}
+
+	bool operator!=(const char* rhs) const
+	{
+		return !(*this == rhs);
+	}
+
+	// The string table lives in Core, see InnoStringTable.cpp
+	const char* c_str() const;
+
+	size_t size() const
+	{
+		return strlen(c_str());
+	}
+
+	bool empty() const
+	{
+		return m_ID == 0;
+	}
+
+	uint32_t GetID() const
+	{
+		return m_ID;
+	}
+
+private:
+	uint32_t m_ID = 0;
+};
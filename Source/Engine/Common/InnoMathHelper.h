@@ -1,5 +1,6 @@
 #pragma once
 #include "InnoMath.h"
+#include "InnoSIMD.h"
 
 namespace InnoMath
 {
@@ -1276,6 +1277,37 @@ namespace InnoMath
 		return m;
 	}
 
+	// The rotation is normalized linear interpolated, it's close enough for the small change between two simulation steps
+	template<class T>
+	auto interpolateTransformMatrix(const TTransformMatrix<T> & from, const TTransformMatrix<T> & to, T alpha)->TTransformMatrix<T>
+	{
+#if defined (USE_COLUMN_MAJOR_MEMORY_LAYOUT)
+		auto l_posFrom = TVec4<T>(from.m_translationMat.m30, from.m_translationMat.m31, from.m_translationMat.m32, one<T>);
+		auto l_posTo = TVec4<T>(to.m_translationMat.m30, to.m_translationMat.m31, to.m_translationMat.m32, one<T>);
+#elif defined (USE_ROW_MAJOR_MEMORY_LAYOUT)
+		auto l_posFrom = TVec4<T>(from.m_translationMat.m03, from.m_translationMat.m13, from.m_translationMat.m23, one<T>);
+		auto l_posTo = TVec4<T>(to.m_translationMat.m03, to.m_translationMat.m13, to.m_translationMat.m23, one<T>);
+#endif
+		auto l_scaleFrom = TVec4<T>(from.m_scaleMat.m00, from.m_scaleMat.m11, from.m_scaleMat.m22, from.m_scaleMat.m33);
+		auto l_scaleTo = TVec4<T>(to.m_scaleMat.m00, to.m_scaleMat.m11, to.m_scaleMat.m22, to.m_scaleMat.m33);
+
+		auto l_rotFrom = InnoMath::toQuatRotator(from.m_rotationMat);
+		auto l_rotTo = InnoMath::toQuatRotator(to.m_rotationMat);
+
+		// Take the shorter arc
+		if (l_rotFrom * l_rotTo < zero<T>)
+		{
+			l_rotTo = l_rotTo * -one<T>;
+		}
+
+		TTransformMatrix<T> m;
+		m.m_translationMat = InnoMath::toTranslationMatrix(lerp(l_posTo, l_posFrom, alpha));
+		m.m_rotationMat = InnoMath::toRotationMatrix(nlerp(l_rotTo, l_rotFrom, alpha));
+		m.m_scaleMat = InnoMath::toScaleMatrix(lerp(l_scaleTo, l_scaleFrom, alpha));
+		m.m_transformationMat = calcTransformationMatrix(m);
+		return m;
+	}
+
 	template<class T>
 	auto calcLookAtMatrix(const TVec4<T> & globalPos, const TVec4<T> & localRot) -> TMat4<T>
 	{
@@ -1318,24 +1350,65 @@ namespace InnoMath
 		return l_directionTVec4.rotateDirectionByQuat(localRot);
 	}
 
+	// xoshiro256** seeded once per thread, no heap allocation after the first call
+	INNO_FORCEINLINE uint64_t generateRandomUInt64()
+	{
+		struct RandomState
+		{
+			RandomState()
+			{
+				std::random_device l_rd;
+				uint64_t l_seed = (uint64_t(l_rd()) << 32) ^ uint64_t(l_rd());
+
+				// splitmix64 to spread the seed over the whole state
+				for (auto& i : s)
+				{
+					l_seed += 0x9E3779B97F4A7C15ull;
+					uint64_t z = l_seed;
+					z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+					z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+					i = z ^ (z >> 31);
+				}
+			}
+
+			uint64_t s[4];
+		};
+
+		static thread_local RandomState l_state;
+
+		auto rotl = [](uint64_t x, int32_t k) -> uint64_t { return (x << k) | (x >> (64 - k)); };
+
+		auto& s = l_state.s;
+		const uint64_t l_result = rotl(s[1] * 5, 7) * 9;
+		const uint64_t t = s[1] << 17;
+
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 45);
+
+		return l_result;
+	}
+
 	INNO_FORCEINLINE EntityID createEntityID()
 	{
-		std::stringstream ss;
-		for (uint32_t i = 0; i < 16; i++) {
-			auto rc = []() -> unsigned char {
-				std::random_device rd;
-				std::mt19937 gen(rd());
-				std::uniform_int_distribution<> dis(0, 255);
-				return static_cast<unsigned char>(dis(gen));
-			};
-			std::stringstream hexstream;
-			hexstream << std::hex << int32_t(rc());
-			auto hex = hexstream.str();
-			ss << (hex.length() < 2 ? '0' + hex : hex);
-		}
-
-		auto l_str = ss.str();
-		EntityID result = l_str.c_str();
+		static const char l_hexDigits[] = "0123456789abcdef";
+
+		// 16 random bytes as 32 hex digits
+		char l_str[33];
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			auto l_random = generateRandomUInt64();
+			for (uint32_t j = 0; j < 16; j++)
+			{
+				l_str[i * 16 + j] = l_hexDigits[(l_random >> (j * 4)) & 0xF];
+			}
+		}
+		l_str[32] = '\0';
+
+		EntityID result = l_str;
 		return result;
 	}
 
@@ -1584,38 +1657,152 @@ namespace InnoMath
 		return l_result;
 	}
 
+	// The images of the x, y and z unit vectors and of the origin under the transformation
 	template<class T>
-	inline auto transformAABBSpace(const TAABB<T>& rhs, TMat4<T> Tm) -> TAABB<T>
+	inline void getTransformationAxes(const TMat4<T>& Tm, TVec4<T>& axisX, TVec4<T>& axisY, TVec4<T>& axisZ, TVec4<T>& translation)
 	{
-		auto l_vertices = generateAABBVertices(rhs.m_boundMax, rhs.m_boundMin);
-
-		for (auto& i : l_vertices)
-		{
 #ifdef USE_COLUMN_MAJOR_MEMORY_LAYOUT
-			i.m_pos = InnoMath::mul(i.m_pos, Tm);
+		axisX = TVec4<T>(Tm.m00, Tm.m01, Tm.m02, Tm.m03);
+		axisY = TVec4<T>(Tm.m10, Tm.m11, Tm.m12, Tm.m13);
+		axisZ = TVec4<T>(Tm.m20, Tm.m21, Tm.m22, Tm.m23);
+		translation = TVec4<T>(Tm.m30, Tm.m31, Tm.m32, Tm.m33);
 #endif
 #ifdef USE_ROW_MAJOR_MEMORY_LAYOUT
-			i.m_pos = InnoMath::mul(Tm, i.m_pos);
+		axisX = TVec4<T>(Tm.m00, Tm.m10, Tm.m20, Tm.m30);
+		axisY = TVec4<T>(Tm.m01, Tm.m11, Tm.m21, Tm.m31);
+		axisZ = TVec4<T>(Tm.m02, Tm.m12, Tm.m22, Tm.m32);
+		translation = TVec4<T>(Tm.m03, Tm.m13, Tm.m23, Tm.m33);
 #endif
-		}
+	}
 
-		auto l_boundMin = maxVec4<T>;
-		auto l_boundMax = minVec4<T>;
+	// Arvo's method, the center is transformed as a point and the half extent is projected onto the absolute values of the axes
+	// The result is the same as the bound of the 8 transformed corners, for any affine transformation
+	template<class T>
+	inline auto transformAABBSpace(const TAABB<T>& rhs, const TMat4<T>& Tm) -> TAABB<T>
+	{
+		TVec4<T> l_axisX, l_axisY, l_axisZ, l_translation;
+		getTransformationAxes(Tm, l_axisX, l_axisY, l_axisZ, l_translation);
 
-		for (auto& i : l_vertices)
-		{
-			l_boundMin = elementWiseMin(i.m_pos, l_boundMin);
-			l_boundMax = elementWiseMax(i.m_pos, l_boundMax);
-		}
+		auto l_centerX = (rhs.m_boundMax.x + rhs.m_boundMin.x) * half<T>;
+		auto l_centerY = (rhs.m_boundMax.y + rhs.m_boundMin.y) * half<T>;
+		auto l_centerZ = (rhs.m_boundMax.z + rhs.m_boundMin.z) * half<T>;
+		auto l_extentX = (rhs.m_boundMax.x - rhs.m_boundMin.x) * half<T>;
+		auto l_extentY = (rhs.m_boundMax.y - rhs.m_boundMin.y) * half<T>;
+		auto l_extentZ = (rhs.m_boundMax.z - rhs.m_boundMin.z) * half<T>;
 
-		l_boundMin.w = one<T>;
-		l_boundMax.w = one<T>;
+		TVec4<T> l_center;
+		l_center.x = l_axisX.x * l_centerX + l_axisY.x * l_centerY + l_axisZ.x * l_centerZ + l_translation.x;
+		l_center.y = l_axisX.y * l_centerX + l_axisY.y * l_centerY + l_axisZ.y * l_centerZ + l_translation.y;
+		l_center.z = l_axisX.z * l_centerX + l_axisY.z * l_centerY + l_axisZ.z * l_centerZ + l_translation.z;
+		l_center.w = one<T>;
 
-		auto l_result = generateAABB(l_boundMax, l_boundMin);
+		TVec4<T> l_extent;
+		l_extent.x = std::abs(l_axisX.x) * l_extentX + std::abs(l_axisY.x) * l_extentY + std::abs(l_axisZ.x) * l_extentZ;
+		l_extent.y = std::abs(l_axisX.y) * l_extentX + std::abs(l_axisY.y) * l_extentY + std::abs(l_axisZ.y) * l_extentZ;
+		l_extent.z = std::abs(l_axisX.z) * l_extentX + std::abs(l_axisY.z) * l_extentY + std::abs(l_axisZ.z) * l_extentZ;
+		l_extent.w = zero<T>;
+
+		TAABB<T> l_result;
+
+		l_result.m_center = l_center;
+		l_result.m_boundMax = l_center + l_extent;
+		l_result.m_boundMin = l_center - l_extent;
+		l_result.m_extend = l_extent * two<T>;
+		l_result.m_extend.w = one<T>;
 
 		return l_result;
 	};
 
+#if defined(INNO_SIMD)
+	namespace InnoMathNS
+	{
+		// The SIMD version works on one AABB with 4 lanes of (x, y, z, w), both SSE and AVX builds use the 128 bit instructions
+		struct TransformationAxesLanes
+		{
+			__m128 m_AxisX;
+			__m128 m_AxisY;
+			__m128 m_AxisZ;
+			__m128 m_Translation;
+		};
+
+		inline TransformationAxesLanes loadTransformationAxes(const Mat4& Tm)
+		{
+			TransformationAxesLanes l_result;
+
+			l_result.m_AxisX = _mm_loadu_ps(&Tm.m00);
+			l_result.m_AxisY = _mm_loadu_ps(&Tm.m10);
+			l_result.m_AxisZ = _mm_loadu_ps(&Tm.m20);
+			l_result.m_Translation = _mm_loadu_ps(&Tm.m30);
+
+			// The rows of the memory are the axes in the column-major layout, but the components of the axes in the row-major layout
+#ifdef USE_ROW_MAJOR_MEMORY_LAYOUT
+			_MM_TRANSPOSE4_PS(l_result.m_AxisX, l_result.m_AxisY, l_result.m_AxisZ, l_result.m_Translation);
+#endif
+			return l_result;
+		}
+
+		inline void transformAABBSpace(const AABB& rhs, const TransformationAxesLanes& axes, AABB& result)
+		{
+			const __m128 l_half = _mm_set1_ps(0.5f);
+			const __m128 l_absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+			const __m128 l_xyzMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+			const __m128 l_wOne = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+			auto l_boundMax = _mm_loadu_ps(&rhs.m_boundMax.x);
+			auto l_boundMin = _mm_loadu_ps(&rhs.m_boundMin.x);
+			auto l_center = _mm_mul_ps(_mm_add_ps(l_boundMax, l_boundMin), l_half);
+			auto l_extent = _mm_mul_ps(_mm_sub_ps(l_boundMax, l_boundMin), l_half);
+
+			auto l_centerX = _mm_shuffle_ps(l_center, l_center, _MM_SHUFFLE(0, 0, 0, 0));
+			auto l_centerY = _mm_shuffle_ps(l_center, l_center, _MM_SHUFFLE(1, 1, 1, 1));
+			auto l_centerZ = _mm_shuffle_ps(l_center, l_center, _MM_SHUFFLE(2, 2, 2, 2));
+			auto l_extentX = _mm_shuffle_ps(l_extent, l_extent, _MM_SHUFFLE(0, 0, 0, 0));
+			auto l_extentY = _mm_shuffle_ps(l_extent, l_extent, _MM_SHUFFLE(1, 1, 1, 1));
+			auto l_extentZ = _mm_shuffle_ps(l_extent, l_extent, _MM_SHUFFLE(2, 2, 2, 2));
+
+			auto l_resultCenter = _mm_add_ps(_mm_add_ps(_mm_mul_ps(axes.m_AxisX, l_centerX), _mm_mul_ps(axes.m_AxisY, l_centerY)), _mm_add_ps(_mm_mul_ps(axes.m_AxisZ, l_centerZ), axes.m_Translation));
+			auto l_resultExtent = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_and_ps(axes.m_AxisX, l_absMask), l_extentX), _mm_mul_ps(_mm_and_ps(axes.m_AxisY, l_absMask), l_extentY)), _mm_mul_ps(_mm_and_ps(axes.m_AxisZ, l_absMask), l_extentZ));
+
+			l_resultCenter = _mm_or_ps(_mm_and_ps(l_resultCenter, l_xyzMask), l_wOne);
+			l_resultExtent = _mm_and_ps(l_resultExtent, l_xyzMask);
+
+			_mm_storeu_ps(&result.m_center.x, l_resultCenter);
+			_mm_storeu_ps(&result.m_boundMax.x, _mm_add_ps(l_resultCenter, l_resultExtent));
+			_mm_storeu_ps(&result.m_boundMin.x, _mm_sub_ps(l_resultCenter, l_resultExtent));
+			_mm_storeu_ps(&result.m_extend.x, _mm_or_ps(_mm_add_ps(l_resultExtent, l_resultExtent), l_wOne));
+		}
+	}
+#endif
+
+	// Transform count AABBs, each by its own transformation
+	inline void transformAABBSpace(const AABB* rhs, const Mat4* Tm, size_t count, AABB* result)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+#if defined(INNO_SIMD)
+			InnoMathNS::transformAABBSpace(rhs[i], InnoMathNS::loadTransformationAxes(Tm[i]), result[i]);
+#else
+			result[i] = transformAABBSpace(rhs[i], Tm[i]);
+#endif
+		}
+	}
+
+	// Transform count AABBs by the same transformation
+	inline void transformAABBSpace(const AABB* rhs, const Mat4& Tm, size_t count, AABB* result)
+	{
+#if defined(INNO_SIMD)
+		auto l_axes = InnoMathNS::loadTransformationAxes(Tm);
+#endif
+		for (size_t i = 0; i < count; i++)
+		{
+#if defined(INNO_SIMD)
+			InnoMathNS::transformAABBSpace(rhs[i], l_axes, result[i]);
+#else
+			result[i] = transformAABBSpace(rhs[i], Tm);
+#endif
+		}
+	}
+
 	inline std::vector<Vertex> worldToViewSpace(const std::vector<Vertex>& rhs, Mat4 t, Mat4 r)
 	{
 		auto l_result = rhs;
@@ -1652,90 +1839,101 @@ namespace InnoMath
 		return l_result;
 	}
 
-	inline std::vector<Vertex> generateFrustumVerticesVS(Mat4 p)
+	// Write the 8 frustum corners to result, near clip plane first
+	inline void generateFrustumVerticesVS(const Mat4& p, Vertex* result)
 	{
-		std::vector<Vertex> rhs(8);
+		InnoMath::generateNDC<float>(result);
 
-		InnoMath::generateNDC<float>(&rhs[0]);
+		// Invert the projection matrix once instead of per vertex in clipToViewSpace
+		auto l_pInv = p.inverse();
 
-		for (auto& i : rhs)
+		for (size_t i = 0; i < 8; i++)
 		{
-			i.m_pos = InnoMath::clipToViewSpace(i.m_pos, p);
+#if defined USE_COLUMN_MAJOR_MEMORY_LAYOUT
+			auto l_pos = InnoMath::mul(result[i].m_pos, l_pInv);
+#elif defined USE_ROW_MAJOR_MEMORY_LAYOUT
+			auto l_pos = InnoMath::mul(l_pInv, result[i].m_pos);
+#endif
+			result[i].m_pos = l_pos * (1.0f / l_pos.w);
 		}
 
-		// near clip plane first
 		// @TODO: reverse only along Z axis, not simple mirrored version
-		std::reverse(rhs.begin(), rhs.end());
+		std::reverse(result, result + 8);
+	}
 
+	inline std::vector<Vertex> generateFrustumVerticesVS(Mat4 p)
+	{
 		std::vector<Vertex> l_vertices(8);
 
-		for (uint32_t i = 0; i < 8; i++)
-		{
-			l_vertices[i] = rhs[i];
-		}
+		generateFrustumVerticesVS(p, &l_vertices[0]);
 
 		return l_vertices;
 	}
 
-	inline std::vector<Vertex> generateFrustumVerticesWS(Mat4 p, Mat4 r, Mat4 t)
+	inline void generateFrustumVerticesWS(const Mat4& p, const Mat4& r, const Mat4& t, Vertex* result)
 	{
-		auto rhs = generateFrustumVerticesVS(p);
-
-		for (auto& i : rhs)
-		{
-			i.m_pos = InnoMath::viewToWorldSpace(i.m_pos, t, r);
-		}
+		generateFrustumVerticesVS(p, result);
 
-		for (auto& i : rhs)
+		for (size_t i = 0; i < 8; i++)
 		{
-			i.m_normal = Vec4(i.m_pos.x, i.m_pos.y, i.m_pos.z, 0.0f).normalize();
+			result[i].m_pos = InnoMath::viewToWorldSpace(result[i].m_pos, t, r);
+			result[i].m_normal = Vec4(result[i].m_pos.x, result[i].m_pos.y, result[i].m_pos.z, 0.0f).normalize();
 		}
-
-		return rhs;
 	}
 
-	inline std::vector<Vertex> generateAABBVertices(Vec4 boundMax, Vec4 boundMin)
+	inline std::vector<Vertex> generateFrustumVerticesWS(Mat4 p, Mat4 r, Mat4 t)
 	{
 		std::vector<Vertex> l_vertices(8);
 
-		l_vertices[0].m_pos = (Vec4(boundMax.x, boundMax.y, boundMax.z, 1.0f));
-		l_vertices[0].m_texCoord = Vec2(1.0f, 1.0f);
+		generateFrustumVerticesWS(p, r, t, &l_vertices[0]);
 
-		l_vertices[1].m_pos = (Vec4(boundMax.x, boundMin.y, boundMax.z, 1.0f));
-		l_vertices[1].m_texCoord = Vec2(1.0f, 0.0f);
+		return l_vertices;
+	}
+
+	inline void generateAABBVertices(const Vec4& boundMax, const Vec4& boundMin, Vertex* result)
+	{
+		result[0].m_pos = (Vec4(boundMax.x, boundMax.y, boundMax.z, 1.0f));
+		result[0].m_texCoord = Vec2(1.0f, 1.0f);
+
+		result[1].m_pos = (Vec4(boundMax.x, boundMin.y, boundMax.z, 1.0f));
+		result[1].m_texCoord = Vec2(1.0f, 0.0f);
 
-		l_vertices[2].m_pos = (Vec4(boundMin.x, boundMin.y, boundMax.z, 1.0f));
-		l_vertices[2].m_texCoord = Vec2(0.0f, 0.0f);
+		result[2].m_pos = (Vec4(boundMin.x, boundMin.y, boundMax.z, 1.0f));
+		result[2].m_texCoord = Vec2(0.0f, 0.0f);
 
-		l_vertices[3].m_pos = (Vec4(boundMin.x, boundMax.y, boundMax.z, 1.0f));
-		l_vertices[3].m_texCoord = Vec2(0.0f, 1.0f);
+		result[3].m_pos = (Vec4(boundMin.x, boundMax.y, boundMax.z, 1.0f));
+		result[3].m_texCoord = Vec2(0.0f, 1.0f);
 
-		l_vertices[4].m_pos = (Vec4(boundMax.x, boundMax.y, boundMin.z, 1.0f));
-		l_vertices[4].m_texCoord = Vec2(1.0f, 1.0f);
+		result[4].m_pos = (Vec4(boundMax.x, boundMax.y, boundMin.z, 1.0f));
+		result[4].m_texCoord = Vec2(1.0f, 1.0f);
 
-		l_vertices[5].m_pos = (Vec4(boundMax.x, boundMin.y, boundMin.z, 1.0f));
-		l_vertices[5].m_texCoord = Vec2(1.0f, 0.0f);
+		result[5].m_pos = (Vec4(boundMax.x, boundMin.y, boundMin.z, 1.0f));
+		result[5].m_texCoord = Vec2(1.0f, 0.0f);
 
-		l_vertices[6].m_pos = (Vec4(boundMin.x, boundMin.y, boundMin.z, 1.0f));
-		l_vertices[6].m_texCoord = Vec2(0.0f, 0.0f);
+		result[6].m_pos = (Vec4(boundMin.x, boundMin.y, boundMin.z, 1.0f));
+		result[6].m_texCoord = Vec2(0.0f, 0.0f);
 
-		l_vertices[7].m_pos = (Vec4(boundMin.x, boundMax.y, boundMin.z, 1.0f));
-		l_vertices[7].m_texCoord = Vec2(0.0f, 1.0f);
+		result[7].m_pos = (Vec4(boundMin.x, boundMax.y, boundMin.z, 1.0f));
+		result[7].m_texCoord = Vec2(0.0f, 1.0f);
 
-		for (auto& l_vertexData : l_vertices)
+		for (size_t i = 0; i < 8; i++)
 		{
-			l_vertexData.m_normal = Vec4(l_vertexData.m_pos.x, l_vertexData.m_pos.y, l_vertexData.m_pos.z, 0.0f).normalize();
+			result[i].m_normal = Vec4(result[i].m_pos.x, result[i].m_pos.y, result[i].m_pos.z, 0.0f).normalize();
 		}
+	}
+
+	inline std::vector<Vertex> generateAABBVertices(Vec4 boundMax, Vec4 boundMin)
+	{
+		std::vector<Vertex> l_vertices(8);
+
+		generateAABBVertices(boundMax, boundMin, &l_vertices[0]);
 
 		return l_vertices;
 	}
 
 	inline std::vector<Vertex> generateAABBVertices(const AABB& rhs)
 	{
-		auto boundMax = rhs.m_boundMax;
-		auto boundMin = rhs.m_boundMin;
-
-		return generateAABBVertices(boundMax, boundMin);
+		return generateAABBVertices(rhs.m_boundMax, rhs.m_boundMin);
 	}
 
 	inline Vec4 colorTemperatureToRGB(float kelvin)
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Thin wrappers of the float SIMD intrinsics, the instruction set is decided at compile time from the compiler flags
+#if defined(__AVX__)
+#define INNO_SIMD_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INNO_SIMD_SSE
+#include <emmintrin.h>
+#endif
+
+#if defined(INNO_SIMD_AVX) || defined(INNO_SIMD_SSE)
+#define INNO_SIMD
+#endif
+
+namespace InnoSIMD
+{
+#if defined(INNO_SIMD_AVX)
+	const size_t m_LaneCount = 8;
+	using FloatLanes = __m256;
+
+	inline FloatLanes Load(const float* p) { return _mm256_loadu_ps(p); }
+	inline void Store(float* p, FloatLanes lanes) { _mm256_storeu_ps(p, lanes); }
+	inline FloatLanes Broadcast(const float* p) { return _mm256_broadcast_ss(p); }
+	inline FloatLanes Set(float value) { return _mm256_set1_ps(value); }
+	inline FloatLanes LaneIndices() { return _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f); }
+	inline FloatLanes Zero() { return _mm256_setzero_ps(); }
+	inline FloatLanes Add(FloatLanes lhs, FloatLanes rhs) { return _mm256_add_ps(lhs, rhs); }
+	inline FloatLanes Sub(FloatLanes lhs, FloatLanes rhs) { return _mm256_sub_ps(lhs, rhs); }
+	inline FloatLanes Mul(FloatLanes lhs, FloatLanes rhs) { return _mm256_mul_ps(lhs, rhs); }
+	inline FloatLanes Min(FloatLanes lhs, FloatLanes rhs) { return _mm256_min_ps(lhs, rhs); }
+	inline FloatLanes Max(FloatLanes lhs, FloatLanes rhs) { return _mm256_max_ps(lhs, rhs); }
+	inline FloatLanes And(FloatLanes lhs, FloatLanes rhs) { return _mm256_and_ps(lhs, rhs); }
+	inline FloatLanes Or(FloatLanes lhs, FloatLanes rhs) { return _mm256_or_ps(lhs, rhs); }
+	inline FloatLanes Greater(FloatLanes lhs, FloatLanes rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_GT_OQ); }
+	inline FloatLanes GreaterEqual(FloatLanes lhs, FloatLanes rhs) { return _mm256_cmp_ps(lhs, rhs, _CMP_GE_OQ); }
+	inline FloatLanes Select(FloatLanes mask, FloatLanes lhs, FloatLanes rhs) { return _mm256_blendv_ps(rhs, lhs, mask); }
+	inline uint32_t MoveMask(FloatLanes lanes) { return (uint32_t)_mm256_movemask_ps(lanes); }
+#elif defined(INNO_SIMD_SSE)
+	const size_t m_LaneCount = 4;
+	using FloatLanes = __m128;
+
+	inline FloatLanes Load(const float* p) { return _mm_loadu_ps(p); }
+	inline void Store(float* p, FloatLanes lanes) { _mm_storeu_ps(p, lanes); }
+	inline FloatLanes Broadcast(const float* p) { return _mm_load1_ps(p); }
+	inline FloatLanes Set(float value) { return _mm_set1_ps(value); }
+	inline FloatLanes LaneIndices() { return _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f); }
+	inline FloatLanes Zero() { return _mm_setzero_ps(); }
+	inline FloatLanes Add(FloatLanes lhs, FloatLanes rhs) { return _mm_add_ps(lhs, rhs); }
+	inline FloatLanes Sub(FloatLanes lhs, FloatLanes rhs) { return _mm_sub_ps(lhs, rhs); }
+	inline FloatLanes Mul(FloatLanes lhs, FloatLanes rhs) { return _mm_mul_ps(lhs, rhs); }
+	inline FloatLanes Min(FloatLanes lhs, FloatLanes rhs) { return _mm_min_ps(lhs, rhs); }
+	inline FloatLanes Max(FloatLanes lhs, FloatLanes rhs) { return _mm_max_ps(lhs, rhs); }
+	inline FloatLanes And(FloatLanes lhs, FloatLanes rhs) { return _mm_and_ps(lhs, rhs); }
+	inline FloatLanes Or(FloatLanes lhs, FloatLanes rhs) { return _mm_or_ps(lhs, rhs); }
+	inline FloatLanes Greater(FloatLanes lhs, FloatLanes rhs) { return _mm_cmpgt_ps(lhs, rhs); }
+	inline FloatLanes GreaterEqual(FloatLanes lhs, FloatLanes rhs) { return _mm_cmpge_ps(lhs, rhs); }
+	// SSE2 has no blend instruction
+	inline FloatLanes Select(FloatLanes mask, FloatLanes lhs, FloatLanes rhs) { return _mm_or_ps(_mm_and_ps(mask, lhs), _mm_andnot_ps(mask, rhs)); }
+	inline uint32_t MoveMask(FloatLanes lanes) { return (uint32_t)_mm_movemask_ps(lanes); }
+#endif
+
+	// "AVX", "SSE" or "Scalar"
+	inline const char* GetInstructionSet()
+	{
+#if defined(INNO_SIMD_AVX)
+		return "AVX";
+#elif defined(INNO_SIMD_SSE)
+		return "SSE";
+#else
+		return "Scalar";
+#endif
+	}
+}
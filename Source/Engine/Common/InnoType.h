@@ -1,6 +1,7 @@
 #pragma once
 #include "Config.h"
 #include "InnoContainer.h"
+#include "InnoInternedString.h"
 
 #if defined INNO_PLATFORM_WIN
 #define INNO_FORCEINLINE __forceinline
@@ -29,7 +30,7 @@ enum class ObjectOwnership
 };
 
 using EntityID = FixedSizeString<32>;
-using ComponentName = FixedSizeString<128>;
+using ComponentName = InternedString;
 using EntityName = FixedSizeString<128>;
 
 enum class ComponentType
@@ -1,2 +1,3 @@
 #include <shared_mutex>
 #include <optional>
+#include <string_view>
@@ -9,4 +9,6 @@ public:
 	ID3D11Buffer* m_BufferPtr = 0;
 	ID3D11ShaderResourceView* m_SRV = 0;
 	ID3D11UnorderedAccessView* m_UAV = 0;
+	// The dynamic constant buffers are discarded on every upload, so the whole content is kept here and uploaded again
+	std::vector<char> m_CPUData;
 };
\ No newline at end of file
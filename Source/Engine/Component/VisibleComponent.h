@@ -19,6 +19,10 @@ public:
 	std::string m_modelFileName;
 	bool m_simulatePhysics = false;
 
+	// The object is culled when the projected diameter of its bound sphere is smaller than these, in pixels of the main camera
+	float m_minScreenSize = 1.0f;
+	float m_minShadowScreenSize = 2.0f;
+
 	ModelMap m_modelMap;
 	std::vector<PhysicsDataComponent*> m_PDCs;
 };
@@ -45,8 +45,9 @@ void CameraComponentManagerNS::generateFrustum(CameraComponent * cameraComponent
 		auto l_rCamera = InnoMath::toRotationMatrix(l_transformComponent->m_globalTransformVector.m_rot);
 		auto l_tCamera = InnoMath::toTranslationMatrix(l_transformComponent->m_globalTransformVector.m_pos);
 
-		auto l_vertices = InnoMath::generateFrustumVerticesWS(l_pCamera, l_rCamera, l_tCamera);
-		cameraComponent->m_frustum = InnoMath::makeFrustum(&l_vertices[0]);
+		Vertex l_vertices[8];
+		InnoMath::generateFrustumVerticesWS(l_pCamera, l_rCamera, l_tCamera, l_vertices);
+		cameraComponent->m_frustum = InnoMath::makeFrustum(l_vertices);
 	}
 }
 
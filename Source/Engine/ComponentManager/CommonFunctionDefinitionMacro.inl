@@ -4,6 +4,7 @@ for (auto i : m_Components) \
 	if (i->m_ObjectOwnership == ObjectOwnership::Client) \
 	{ \
 		i->m_ObjectStatus = ObjectStatus::Terminated; \
+		g_pModuleManager->getSceneHierarchyManager()->UnregisterComponent(i); \
 		m_ComponentPool->Destroy(i); \
 	} \
 } \
@@ -27,13 +28,11 @@ m_ComponentsMap.erase_if([&](auto val) { return val.second->m_ObjectOwnership ==
 		l_Component->m_ObjectStatus = ObjectStatus::Created; \
 		l_Component->m_ObjectSource = objectSource; \
 		l_Component->m_ObjectOwnership = objectUsage; \
-		auto l_componentIndex = m_CurrentComponentIndex; \
-		auto l_componentName = ComponentName((std::string(parentEntity->m_EntityName.c_str()) + "." + std::string(#className) + "_" + std::to_string(l_componentIndex) + "/").c_str()); \
-		l_Component->m_ComponentName = l_componentName; \
 		l_Component->m_UUID = g_pModuleManager->getEntityManager()->AcquireUUID(); \
 		m_Components.emplace_back(l_Component); \
 		m_ComponentsMap.emplace(l_parentEntity, l_Component); \
 		l_Component->m_ObjectStatus = ObjectStatus::Activated; \
+		g_pModuleManager->getSceneHierarchyManager()->RegisterComponent(l_Component); \
 		m_CurrentComponentIndex++; \
 \
 		return l_Component; \
@@ -47,6 +46,7 @@ m_ComponentsMap.erase_if([&](auto val) { return val.second->m_ObjectOwnership ==
 	component->m_ObjectStatus = ObjectStatus::Terminated; \
 	m_Components.eraseByValue(reinterpret_cast<className*>(component)); \
 	m_ComponentsMap.erase(component->m_ParentEntity); \
+	g_pModuleManager->getSceneHierarchyManager()->UnregisterComponent(component); \
 	m_ComponentPool->Destroy(component);
 
 #define GetComponentImpl( className, parentEntity ) \
@@ -0,0 +1,138 @@
+#pragma once
+#include "../Component/TransformComponent.h"
+#include "../Component/VisibleComponent.h"
+#include "../Component/LightComponent.h"
+#include "../Component/CameraComponent.h"
+#include "../SceneHierarchyManager/ISceneHierarchyManager.h"
+#include "../Interface/ITaskSystem.h"
+
+template<typename T>
+struct ComponentTypeTraits;
+
+#define DeclareComponentTypeTraits( className ) \
+template<> \
+struct ComponentTypeTraits<className> \
+{ \
+	static const ComponentType m_Type = ComponentType::className; \
+};
+
+DeclareComponentTypeTraits(TransformComponent)
+DeclareComponentTypeTraits(VisibleComponent)
+DeclareComponentTypeTraits(LightComponent)
+DeclareComponentTypeTraits(CameraComponent)
+
+template<typename... Ts>
+using ComponentTuple = std::tuple<Ts*...>;
+
+template<typename... Ts>
+struct ComponentQueryChunk
+{
+	const ComponentTuple<Ts...>* m_Tuples = nullptr;
+	size_t m_Count = 0;
+
+	const ComponentTuple<Ts...>* begin() const { return m_Tuples; }
+	const ComponentTuple<Ts...>* end() const { return m_Tuples + m_Count; }
+};
+
+// Collects the entities which have all the queried component types, the tuples are stored contiguously and only re-collected after the scene hierarchy changed
+template<typename... Ts>
+class ComponentQuery
+{
+public:
+	static const size_t m_ChunkSize = 256;
+
+	// Return true if the tuples have been re-collected
+	bool Update(ISceneHierarchyManager* sceneHierarchyManager)
+	{
+		// The version and the iterated components come from the same snapshot
+		auto l_sceneHierarchyMap = sceneHierarchyManager->GetSceneHierarchyMap();
+		auto l_version = l_sceneHierarchyMap->GetVersion();
+		if (l_version == m_Version && m_Version)
+		{
+			return false;
+		}
+
+		m_Tuples.clear();
+
+		for (auto i : *l_sceneHierarchyMap)
+		{
+			ComponentTuple<Ts...> l_tuple;
+			if (CollectComponents(i.second, l_tuple, std::index_sequence_for<Ts...>{}))
+			{
+				m_Tuples.emplace_back(l_tuple);
+			}
+		}
+
+		m_Version = l_version;
+
+		return true;
+	}
+
+	size_t GetCount() const
+	{
+		return m_Tuples.size();
+	}
+
+	size_t GetChunkCount() const
+	{
+		return (m_Tuples.size() + m_ChunkSize - 1) / m_ChunkSize;
+	}
+
+	ComponentQueryChunk<Ts...> GetChunk(size_t chunkIndex) const
+	{
+		auto l_first = chunkIndex * m_ChunkSize;
+		return { m_Tuples.data() + l_first, std::min(m_ChunkSize, m_Tuples.size() - l_first) };
+	}
+
+	const std::vector<ComponentTuple<Ts...>>& GetTuples() const
+	{
+		return m_Tuples;
+	}
+
+	template<typename Func>
+	void ForEach(Func&& func) const
+	{
+		for (auto& i : m_Tuples)
+		{
+			std::apply(func, i);
+		}
+	}
+
+	// Each chunk is processed by one thread, the function must only write to the components of its tuple
+	template<typename Func>
+	void ParallelForEach(ITaskSystem* taskSystem, const char* name, Func&& func) const
+	{
+		taskSystem->parallelFor(name, m_Tuples.size(), m_ChunkSize, [&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				std::apply(func, m_Tuples[i]);
+			}
+		});
+	}
+
+private:
+	template<typename T>
+	static bool CollectComponent(const ComponentRange& components, T*& result)
+	{
+		for (auto i : components)
+		{
+			if (i->m_ComponentType == ComponentTypeTraits<T>::m_Type && i->m_ObjectStatus == ObjectStatus::Activated)
+			{
+				result = reinterpret_cast<T*>(i);
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template<size_t... Is>
+	static bool CollectComponents(const ComponentRange& components, ComponentTuple<Ts...>& result, std::index_sequence<Is...>)
+	{
+		return (CollectComponent(components, std::get<Is>(result)) && ...);
+	}
+
+	std::vector<ComponentTuple<Ts...>> m_Tuples;
+	uint64_t m_Version = 0;
+};
@@ -9,5 +9,7 @@ public:
 	virtual const std::vector<LightComponent*>& GetAllComponents() = 0;
 	virtual const LightComponent* GetSun() = 0;
 	virtual const std::vector<AABB>& GetSunSplitAABB() = 0;
+	// The split AABBs in the sun's light space, which the projection matrices are generated from
+	virtual const std::vector<AABB>& GetSunSplitAABBLS() = 0;
 	virtual const std::vector<Mat4>& GetSunProjectionMatrices() = 0;
 };
\ No newline at end of file
@@ -364,6 +364,11 @@ const std::vector<AABB>& InnoLightComponentManager::GetSunSplitAABB()
 	return m_SplitAABBWS;
 }
 
+const std::vector<AABB>& InnoLightComponentManager::GetSunSplitAABBLS()
+{
+	return m_SplitAABBLS;
+}
+
 const std::vector<Mat4>& InnoLightComponentManager::GetSunProjectionMatrices()
 {
 	return m_projectionMatrices;
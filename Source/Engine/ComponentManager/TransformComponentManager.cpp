@@ -42,7 +42,7 @@ namespace TransformComponentManagerNS
 
 	void SimulateTransformComponents()
 	{
-		auto l_tickTime = g_pModuleManager->getTickTime();
+		auto l_tickTime = g_pModuleManager->getFixedTimeStep();
 		auto l_ratio = (1.0f - l_tickTime / 100.0f);
 		l_ratio = InnoMath::clamp(l_ratio, 0.01f, 0.99f);
 
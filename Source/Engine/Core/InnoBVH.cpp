@@ -0,0 +1,868 @@
+#include "InnoBVH.h"
+#include "InnoTaskScheduler.h"
+#include "InnoLogger.h"
+#include <cfloat>
+
+namespace InnoBVHNS
+{
+	const uint32_t m_BinCount = 16;
+	const uint32_t m_MaxLeafSize = 4;
+	const uint32_t m_MaxDepth = 64;
+	const size_t m_ParallelSubtreeThreshold = 8192;
+	const size_t m_ParallelBinningThreshold = 65536;
+	const size_t m_ParallelBinningGrainSize = 16384;
+	const float m_TraversalCost = 1.0f;
+	// The top levels are split into at most 2^m_ParallelCullingDepth subtrees for the parallel culling
+	const uint32_t m_ParallelCullingDepth = 6;
+	const size_t m_ParallelCullingThreshold = 4096;
+
+	struct BuildPrimitive
+	{
+		float m_BoundMin[3];
+		float m_BoundMax[3];
+		float m_Centroid[3];
+	};
+
+	struct RangeBounds
+	{
+		float m_BoundMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float m_BoundMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		float m_CentroidMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float m_CentroidMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	};
+
+	struct Bin
+	{
+		float m_BoundMin[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+		float m_BoundMax[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+		uint32_t m_Count = 0;
+	};
+
+	using Bins = std::array<std::array<Bin, m_BinCount>, 3>;
+
+	struct BuildContext
+	{
+		const BuildPrimitive* m_Primitives;
+		uint32_t* m_PrimitiveIndices;
+	};
+
+	void Merge(RangeBounds& lhs, const RangeBounds& rhs);
+	void Merge(Bin& lhs, const Bin& rhs);
+	float HalfArea(const float* boundMin, const float* boundMax);
+	RangeBounds ComputeRangeBounds(const BuildContext& context, size_t begin, size_t end);
+	void ComputeBins(const BuildContext& context, size_t begin, size_t end, const RangeBounds& rangeBounds, const float* scales, Bins& bins);
+	void BuildNode(const BuildContext& context, size_t begin, size_t end, uint32_t depth, std::vector<BVHNode>& nodes);
+	void AppendSubtree(std::vector<BVHNode>& nodes, const std::vector<BVHNode>& subtree, uint32_t parentIndex);
+
+	enum class CullingResult { Outside, Intersect, Inside };
+
+	float HalfArea(const BVHNode& node);
+	float GetCostWeight(const BVHNode& node);
+	bool UpdateNodeBounds(BVH& bvh, const AABB* primitiveBounds, uint32_t nodeIndex);
+	void UpdateLeafCullingBounds(BVH& bvh, const AABB* primitiveBounds, const BVHNode& node);
+	void GenerateLeafIndicesAndCost(BVH& bvh, const AABB* primitiveBounds);
+
+	CullingResult Classify(const CullingFrustum& frustum, const float* center, const float* extent);
+	CullingResult Classify(const CullingFrustum& frustum, const BVHNode& node);
+	void CullSubtree(const BVH& bvh, const CullingFrustum& frustum, uint32_t rootIndex, std::vector<uint32_t>& result);
+	void CollectCullingSubtrees(const BVH& bvh, const CullingFrustum& frustum, uint32_t nodeIndex, uint32_t depth, std::vector<uint32_t>& subtrees);
+
+	struct QueryRay
+	{
+		float m_Origin[3];
+		float m_InvDirection[3];
+		float m_Extent[3];
+	};
+
+	bool IntersectRay(const QueryRay& ray, const float* center, const float* extent, float maxDistance, float& distance);
+	bool IntersectRay(const QueryRay& ray, const BVHNode& node, float maxDistance, float& distance);
+}
+
+using namespace InnoBVHNS;
+
+void InnoBVHNS::Merge(RangeBounds& lhs, const RangeBounds& rhs)
+{
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		lhs.m_BoundMin[i] = std::min(lhs.m_BoundMin[i], rhs.m_BoundMin[i]);
+		lhs.m_BoundMax[i] = std::max(lhs.m_BoundMax[i], rhs.m_BoundMax[i]);
+		lhs.m_CentroidMin[i] = std::min(lhs.m_CentroidMin[i], rhs.m_CentroidMin[i]);
+		lhs.m_CentroidMax[i] = std::max(lhs.m_CentroidMax[i], rhs.m_CentroidMax[i]);
+	}
+}
+
+void InnoBVHNS::Merge(Bin& lhs, const Bin& rhs)
+{
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		lhs.m_BoundMin[i] = std::min(lhs.m_BoundMin[i], rhs.m_BoundMin[i]);
+		lhs.m_BoundMax[i] = std::max(lhs.m_BoundMax[i], rhs.m_BoundMax[i]);
+	}
+	lhs.m_Count += rhs.m_Count;
+}
+
+float InnoBVHNS::HalfArea(const float* boundMin, const float* boundMax)
+{
+	auto l_x = boundMax[0] - boundMin[0];
+	auto l_y = boundMax[1] - boundMin[1];
+	auto l_z = boundMax[2] - boundMin[2];
+
+	return l_x * l_y + l_y * l_z + l_z * l_x;
+}
+
+InnoBVHNS::RangeBounds InnoBVHNS::ComputeRangeBounds(const BuildContext& context, size_t begin, size_t end)
+{
+	auto l_count = end - begin;
+
+	if (l_count < m_ParallelBinningThreshold)
+	{
+		RangeBounds l_result;
+
+		for (auto i = begin; i < end; i++)
+		{
+			auto& l_primitive = context.m_Primitives[context.m_PrimitiveIndices[i]];
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				l_result.m_BoundMin[j] = std::min(l_result.m_BoundMin[j], l_primitive.m_BoundMin[j]);
+				l_result.m_BoundMax[j] = std::max(l_result.m_BoundMax[j], l_primitive.m_BoundMax[j]);
+				l_result.m_CentroidMin[j] = std::min(l_result.m_CentroidMin[j], l_primitive.m_Centroid[j]);
+				l_result.m_CentroidMax[j] = std::max(l_result.m_CentroidMax[j], l_primitive.m_Centroid[j]);
+			}
+		}
+
+		return l_result;
+	}
+
+	// Each chunk writes its own partial result, they are merged in the chunk order
+	std::vector<RangeBounds> l_partialResults((l_count + m_ParallelBinningGrainSize - 1) / m_ParallelBinningGrainSize);
+
+	InnoTaskScheduler::ParallelFor("BVHRangeBoundsTask", l_count, m_ParallelBinningGrainSize, [&](size_t chunkBegin, size_t chunkEnd)
+	{
+		l_partialResults[chunkBegin / m_ParallelBinningGrainSize] = ComputeRangeBounds(context, begin + chunkBegin, begin + chunkEnd);
+	});
+
+	RangeBounds l_result;
+	for (auto& i : l_partialResults)
+	{
+		Merge(l_result, i);
+	}
+
+	return l_result;
+}
+
+void InnoBVHNS::ComputeBins(const BuildContext& context, size_t begin, size_t end, const RangeBounds& rangeBounds, const float* scales, Bins& bins)
+{
+	auto l_count = end - begin;
+
+	if (l_count < m_ParallelBinningThreshold)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			auto& l_primitive = context.m_Primitives[context.m_PrimitiveIndices[i]];
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				auto l_binIndex = std::min((uint32_t)((l_primitive.m_Centroid[j] - rangeBounds.m_CentroidMin[j]) * scales[j]), m_BinCount - 1);
+				auto& l_bin = bins[j][l_binIndex];
+				for (uint32_t k = 0; k < 3; k++)
+				{
+					l_bin.m_BoundMin[k] = std::min(l_bin.m_BoundMin[k], l_primitive.m_BoundMin[k]);
+					l_bin.m_BoundMax[k] = std::max(l_bin.m_BoundMax[k], l_primitive.m_BoundMax[k]);
+				}
+				l_bin.m_Count++;
+			}
+		}
+
+		return;
+	}
+
+	std::vector<Bins> l_partialResults((l_count + m_ParallelBinningGrainSize - 1) / m_ParallelBinningGrainSize);
+
+	InnoTaskScheduler::ParallelFor("BVHBinningTask", l_count, m_ParallelBinningGrainSize, [&](size_t chunkBegin, size_t chunkEnd)
+	{
+		ComputeBins(context, begin + chunkBegin, begin + chunkEnd, rangeBounds, scales, l_partialResults[chunkBegin / m_ParallelBinningGrainSize]);
+	});
+
+	for (auto& i : l_partialResults)
+	{
+		for (uint32_t j = 0; j < 3; j++)
+		{
+			for (uint32_t k = 0; k < m_BinCount; k++)
+			{
+				Merge(bins[j][k], i[j][k]);
+			}
+		}
+	}
+}
+
+void InnoBVHNS::AppendSubtree(std::vector<BVHNode>& nodes, const std::vector<BVHNode>& subtree, uint32_t parentIndex)
+{
+	auto l_baseIndex = (uint32_t)nodes.size();
+
+	for (auto i : subtree)
+	{
+		i.m_ParentIndex += l_baseIndex;
+		if (i.m_RightChildIndex)
+		{
+			i.m_RightChildIndex += l_baseIndex;
+		}
+		nodes.emplace_back(i);
+	}
+
+	nodes[l_baseIndex].m_ParentIndex = parentIndex;
+}
+
+void InnoBVHNS::BuildNode(const BuildContext& context, size_t begin, size_t end, uint32_t depth, std::vector<BVHNode>& nodes)
+{
+	auto l_nodeIndex = (uint32_t)nodes.size();
+	nodes.emplace_back();
+
+	auto l_count = end - begin;
+	auto l_rangeBounds = ComputeRangeBounds(context, begin, end);
+
+	{
+		auto& l_node = nodes[l_nodeIndex];
+		l_node.m_BoundMin = Vec4(l_rangeBounds.m_BoundMin[0], l_rangeBounds.m_BoundMin[1], l_rangeBounds.m_BoundMin[2], 1.0f);
+		l_node.m_BoundMax = Vec4(l_rangeBounds.m_BoundMax[0], l_rangeBounds.m_BoundMax[1], l_rangeBounds.m_BoundMax[2], 1.0f);
+		l_node.m_PrimitiveOffset = (uint32_t)begin;
+		l_node.m_PrimitiveCount = (uint32_t)l_count;
+	}
+
+	if (l_count == 1 || depth >= m_MaxDepth)
+	{
+		return;
+	}
+
+	float l_scales[3];
+	bool l_isDegenerated = true;
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		auto l_extent = l_rangeBounds.m_CentroidMax[i] - l_rangeBounds.m_CentroidMin[i];
+		l_scales[i] = l_extent > 0.0f ? (float)m_BinCount / l_extent : 0.0f;
+		l_isDegenerated &= !(l_extent > 0.0f);
+	}
+
+	size_t l_middle;
+
+	if (l_isDegenerated)
+	{
+		// All the centroids are at the same position, split by the primitive count
+		if (l_count <= m_MaxLeafSize)
+		{
+			return;
+		}
+		l_middle = begin + l_count / 2;
+	}
+	else
+	{
+		Bins l_bins;
+		ComputeBins(context, begin, end, l_rangeBounds, l_scales, l_bins);
+
+		auto l_bestCost = FLT_MAX;
+		uint32_t l_bestAxis = 0;
+		uint32_t l_bestSplit = 0;
+
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			if (l_scales[i] == 0.0f)
+			{
+				continue;
+			}
+
+			// Sweep from the right side to get the right costs of every split plane
+			float l_rightCosts[m_BinCount];
+			Bin l_rightBin;
+			for (uint32_t j = m_BinCount - 1; j > 0; j--)
+			{
+				Merge(l_rightBin, l_bins[i][j]);
+				l_rightCosts[j] = l_rightBin.m_Count ? HalfArea(l_rightBin.m_BoundMin, l_rightBin.m_BoundMax) * l_rightBin.m_Count : 0.0f;
+			}
+
+			Bin l_leftBin;
+			uint32_t l_rightCount = (uint32_t)l_count;
+			for (uint32_t j = 1; j < m_BinCount; j++)
+			{
+				Merge(l_leftBin, l_bins[i][j - 1]);
+				l_rightCount -= l_bins[i][j - 1].m_Count;
+
+				if (!l_leftBin.m_Count || !l_rightCount)
+				{
+					continue;
+				}
+
+				auto l_cost = HalfArea(l_leftBin.m_BoundMin, l_leftBin.m_BoundMax) * l_leftBin.m_Count + l_rightCosts[j];
+				if (l_cost < l_bestCost)
+				{
+					l_bestCost = l_cost;
+					l_bestAxis = i;
+					l_bestSplit = j;
+				}
+			}
+		}
+
+		auto l_nodeArea = HalfArea(l_rangeBounds.m_BoundMin, l_rangeBounds.m_BoundMax);
+		auto l_splitCost = l_nodeArea > 0.0f ? m_TraversalCost + l_bestCost / l_nodeArea : 0.0f;
+
+		if (l_count <= m_MaxLeafSize && (float)l_count <= l_splitCost)
+		{
+			return;
+		}
+
+		auto l_first = context.m_PrimitiveIndices + begin;
+		auto l_last = context.m_PrimitiveIndices + end;
+		auto l_centroidMin = l_rangeBounds.m_CentroidMin[l_bestAxis];
+		auto l_scale = l_scales[l_bestAxis];
+
+		auto l_result = std::partition(l_first, l_last, [&](uint32_t index)
+		{
+			auto l_binIndex = std::min((uint32_t)((context.m_Primitives[index].m_Centroid[l_bestAxis] - l_centroidMin) * l_scale), m_BinCount - 1);
+			return l_binIndex < l_bestSplit;
+		});
+
+		l_middle = begin + (l_result - l_first);
+	}
+
+	if (l_count < m_ParallelSubtreeThreshold)
+	{
+		BuildNode(context, begin, l_middle, depth + 1, nodes);
+		nodes[l_nodeIndex].m_RightChildIndex = (uint32_t)nodes.size();
+		BuildNode(context, l_middle, end, depth + 1, nodes);
+		nodes[nodes[l_nodeIndex].m_RightChildIndex].m_ParentIndex = l_nodeIndex;
+		nodes[l_nodeIndex + 1].m_ParentIndex = l_nodeIndex;
+	}
+	else
+	{
+		std::vector<BVHNode> l_subtrees[2];
+		size_t l_ranges[3] = { begin, l_middle, end };
+
+		InnoTaskScheduler::ParallelFor("BVHSubtreeTask", 2, 1, [&](size_t chunkBegin, size_t chunkEnd)
+		{
+			for (auto i = chunkBegin; i < chunkEnd; i++)
+			{
+				l_subtrees[i].reserve((l_ranges[i + 1] - l_ranges[i]) * 2);
+				BuildNode(context, l_ranges[i], l_ranges[i + 1], depth + 1, l_subtrees[i]);
+			}
+		});
+
+		AppendSubtree(nodes, l_subtrees[0], l_nodeIndex);
+		nodes[l_nodeIndex].m_RightChildIndex = (uint32_t)nodes.size();
+		AppendSubtree(nodes, l_subtrees[1], l_nodeIndex);
+	}
+}
+
+float InnoBVHNS::HalfArea(const BVHNode& node)
+{
+	auto l_extent = node.m_BoundMax - node.m_BoundMin;
+
+	return l_extent.x * l_extent.y + l_extent.y * l_extent.z + l_extent.z * l_extent.x;
+}
+
+float InnoBVHNS::GetCostWeight(const BVHNode& node)
+{
+	return node.m_RightChildIndex ? m_TraversalCost : (float)node.m_PrimitiveCount;
+}
+
+bool InnoBVHNS::UpdateNodeBounds(BVH& bvh, const AABB* primitiveBounds, uint32_t nodeIndex)
+{
+	auto& l_node = bvh.m_Nodes[nodeIndex];
+	Vec4 l_boundMin;
+	Vec4 l_boundMax;
+
+	if (l_node.m_RightChildIndex)
+	{
+		auto& l_leftChild = bvh.m_Nodes[nodeIndex + 1];
+		auto& l_rightChild = bvh.m_Nodes[l_node.m_RightChildIndex];
+		l_boundMin = InnoMath::elementWiseMin(l_leftChild.m_BoundMin, l_rightChild.m_BoundMin);
+		l_boundMax = InnoMath::elementWiseMax(l_leftChild.m_BoundMax, l_rightChild.m_BoundMax);
+	}
+	else
+	{
+		auto l_first = bvh.m_PrimitiveIndices.data() + l_node.m_PrimitiveOffset;
+		auto l_last = l_first + l_node.m_PrimitiveCount;
+		l_boundMin = primitiveBounds[*l_first].m_boundMin;
+		l_boundMax = primitiveBounds[*l_first].m_boundMax;
+		for (auto i = l_first + 1; i < l_last; i++)
+		{
+			l_boundMin = InnoMath::elementWiseMin(l_boundMin, primitiveBounds[*i].m_boundMin);
+			l_boundMax = InnoMath::elementWiseMax(l_boundMax, primitiveBounds[*i].m_boundMax);
+		}
+	}
+
+	l_boundMin.w = 1.0f;
+	l_boundMax.w = 1.0f;
+
+	if (l_boundMin == l_node.m_BoundMin && l_boundMax == l_node.m_BoundMax)
+	{
+		return false;
+	}
+
+	auto l_weight = GetCostWeight(l_node);
+	bvh.m_SAHCost -= HalfArea(l_node) * l_weight;
+	l_node.m_BoundMin = l_boundMin;
+	l_node.m_BoundMax = l_boundMax;
+	bvh.m_SAHCost += HalfArea(l_node) * l_weight;
+
+	return true;
+}
+
+void InnoBVHNS::UpdateLeafCullingBounds(BVH& bvh, const AABB* primitiveBounds, const BVHNode& node)
+{
+	for (uint32_t i = node.m_PrimitiveOffset; i < node.m_PrimitiveOffset + node.m_PrimitiveCount; i++)
+	{
+		bvh.m_PrimitiveCullingBounds.Set(i, primitiveBounds[bvh.m_PrimitiveIndices[i]]);
+	}
+}
+
+void InnoBVHNS::GenerateLeafIndicesAndCost(BVH& bvh, const AABB* primitiveBounds)
+{
+	bvh.m_PrimitiveLeafIndices.resize(bvh.m_PrimitiveIndices.size());
+	bvh.m_PrimitiveCullingBounds.resize(bvh.m_PrimitiveIndices.size());
+	bvh.m_SAHCost = 0.0f;
+
+	auto l_nodeCount = (uint32_t)bvh.m_Nodes.size();
+	for (uint32_t i = 0; i < l_nodeCount; i++)
+	{
+		auto& l_node = bvh.m_Nodes[i];
+		bvh.m_SAHCost += HalfArea(l_node) * GetCostWeight(l_node);
+
+		if (!l_node.m_RightChildIndex)
+		{
+			for (uint32_t j = 0; j < l_node.m_PrimitiveCount; j++)
+			{
+				bvh.m_PrimitiveLeafIndices[bvh.m_PrimitiveIndices[l_node.m_PrimitiveOffset + j]] = i;
+			}
+			UpdateLeafCullingBounds(bvh, primitiveBounds, l_node);
+		}
+	}
+}
+
+InnoBVHNS::CullingResult InnoBVHNS::Classify(const CullingFrustum& frustum, const float* center, const float* extent)
+{
+	auto l_result = CullingResult::Inside;
+
+	// The plane normals point outside of the frustum
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		auto l_distance = frustum.m_Normal[i][0] * center[0] + frustum.m_Normal[i][1] * center[1] + frustum.m_Normal[i][2] * center[2] - frustum.m_Distance[i];
+		auto l_radius = frustum.m_AbsNormal[i][0] * extent[0] + frustum.m_AbsNormal[i][1] * extent[1] + frustum.m_AbsNormal[i][2] * extent[2];
+
+		if (l_distance > l_radius)
+		{
+			return CullingResult::Outside;
+		}
+		if (l_distance > -l_radius)
+		{
+			l_result = CullingResult::Intersect;
+		}
+	}
+
+	return l_result;
+}
+
+bool InnoBVH::Build(BVH& bvh, const AABB* primitiveBounds, size_t primitiveCount)
+{
+	bvh.m_Nodes.clear();
+	bvh.m_PrimitiveIndices.resize(primitiveCount);
+
+	if (!primitiveCount)
+	{
+		return true;
+	}
+
+	if (primitiveCount > std::numeric_limits<uint32_t>::max())
+	{
+		InnoLogger::Log(LogLevel::Error, "InnoBVH: Too many primitives ", primitiveCount, "!");
+		return false;
+	}
+
+	std::vector<BuildPrimitive> l_primitives(primitiveCount);
+
+	InnoTaskScheduler::ParallelFor("BVHPrimitiveTask", primitiveCount, m_ParallelBinningGrainSize, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			auto& l_bounds = primitiveBounds[i];
+			auto& l_primitive = l_primitives[i];
+			l_primitive.m_BoundMin[0] = l_bounds.m_boundMin.x;
+			l_primitive.m_BoundMin[1] = l_bounds.m_boundMin.y;
+			l_primitive.m_BoundMin[2] = l_bounds.m_boundMin.z;
+			l_primitive.m_BoundMax[0] = l_bounds.m_boundMax.x;
+			l_primitive.m_BoundMax[1] = l_bounds.m_boundMax.y;
+			l_primitive.m_BoundMax[2] = l_bounds.m_boundMax.z;
+			for (uint32_t j = 0; j < 3; j++)
+			{
+				l_primitive.m_Centroid[j] = (l_primitive.m_BoundMin[j] + l_primitive.m_BoundMax[j]) * 0.5f;
+			}
+			bvh.m_PrimitiveIndices[i] = (uint32_t)i;
+		}
+	});
+
+	BuildContext l_context = { l_primitives.data(), bvh.m_PrimitiveIndices.data() };
+
+	bvh.m_Nodes.reserve(primitiveCount * 2);
+	BuildNode(l_context, 0, primitiveCount, 0, bvh.m_Nodes);
+
+	GenerateLeafIndicesAndCost(bvh, primitiveBounds);
+
+	return true;
+}
+
+void InnoBVH::Refit(BVH& bvh, const AABB* primitiveBounds, const uint32_t* changedPrimitives, size_t changedPrimitiveCount)
+{
+	for (size_t i = 0; i < changedPrimitiveCount; i++)
+	{
+		auto l_nodeIndex = bvh.m_PrimitiveLeafIndices[changedPrimitives[i]];
+		UpdateLeafCullingBounds(bvh, primitiveBounds, bvh.m_Nodes[l_nodeIndex]);
+
+		// Stop as soon as a node doesn't change, its ancestors won't change either
+		while (UpdateNodeBounds(bvh, primitiveBounds, l_nodeIndex) && l_nodeIndex)
+		{
+			l_nodeIndex = bvh.m_Nodes[l_nodeIndex].m_ParentIndex;
+		}
+	}
+}
+
+void InnoBVH::RefitAll(BVH& bvh, const AABB* primitiveBounds)
+{
+	for (auto i = bvh.m_Nodes.size(); i > 0; i--)
+	{
+		auto l_nodeIndex = (uint32_t)i - 1;
+		if (!bvh.m_Nodes[l_nodeIndex].m_RightChildIndex)
+		{
+			UpdateLeafCullingBounds(bvh, primitiveBounds, bvh.m_Nodes[l_nodeIndex]);
+		}
+		UpdateNodeBounds(bvh, primitiveBounds, l_nodeIndex);
+	}
+}
+
+float InnoBVH::GetNormalizedSAHCost(const BVH& bvh)
+{
+	if (bvh.m_Nodes.empty())
+	{
+		return 0.0f;
+	}
+
+	auto l_rootArea = HalfArea(bvh.m_Nodes[0]);
+
+	return l_rootArea > 0.0f ? bvh.m_SAHCost / l_rootArea : 0.0f;
+}
+
+InnoBVHNS::CullingResult InnoBVHNS::Classify(const CullingFrustum& frustum, const BVHNode& node)
+{
+	float l_center[3] = { (node.m_BoundMax.x + node.m_BoundMin.x) * 0.5f, (node.m_BoundMax.y + node.m_BoundMin.y) * 0.5f, (node.m_BoundMax.z + node.m_BoundMin.z) * 0.5f };
+	float l_extent[3] = { (node.m_BoundMax.x - node.m_BoundMin.x) * 0.5f, (node.m_BoundMax.y - node.m_BoundMin.y) * 0.5f, (node.m_BoundMax.z - node.m_BoundMin.z) * 0.5f };
+
+	return Classify(frustum, l_center, l_extent);
+}
+
+void InnoBVHNS::CullSubtree(const BVH& bvh, const CullingFrustum& frustum, uint32_t rootIndex, std::vector<uint32_t>& result)
+{
+	uint32_t l_stack[m_MaxDepth + 1];
+	uint32_t l_stackSize = 0;
+	uint32_t l_nodeIndex = rootIndex;
+
+	while (true)
+	{
+		auto& l_node = bvh.m_Nodes[l_nodeIndex];
+
+		auto l_cullingResult = Classify(frustum, l_node);
+
+		auto l_first = bvh.m_PrimitiveIndices.data() + l_node.m_PrimitiveOffset;
+		auto l_last = l_first + l_node.m_PrimitiveCount;
+
+		if (l_cullingResult == CullingResult::Inside)
+		{
+			result.insert(result.end(), l_first, l_last);
+		}
+		else if (l_cullingResult == CullingResult::Intersect)
+		{
+			if (l_node.m_RightChildIndex)
+			{
+				l_stack[l_stackSize++] = l_node.m_RightChildIndex;
+				l_nodeIndex++;
+				continue;
+			}
+
+			auto l_resultCount = result.size();
+			result.resize(l_resultCount + l_node.m_PrimitiveCount);
+			l_resultCount += InnoCulling::Cull(frustum, bvh.m_PrimitiveCullingBounds, l_node.m_PrimitiveOffset, l_node.m_PrimitiveOffset + l_node.m_PrimitiveCount, bvh.m_PrimitiveIndices.data(), result.data() + l_resultCount);
+			result.resize(l_resultCount);
+		}
+
+		if (!l_stackSize)
+		{
+			return;
+		}
+		l_nodeIndex = l_stack[--l_stackSize];
+	}
+}
+
+void InnoBVHNS::CollectCullingSubtrees(const BVH& bvh, const CullingFrustum& frustum, uint32_t nodeIndex, uint32_t depth, std::vector<uint32_t>& subtrees)
+{
+	auto& l_node = bvh.m_Nodes[nodeIndex];
+
+	// Only the intersecting interior nodes are split further, the others are culled as a whole by one worker
+	if (depth < m_ParallelCullingDepth && l_node.m_RightChildIndex && Classify(frustum, l_node) == CullingResult::Intersect)
+	{
+		CollectCullingSubtrees(bvh, frustum, nodeIndex + 1, depth + 1, subtrees);
+		CollectCullingSubtrees(bvh, frustum, l_node.m_RightChildIndex, depth + 1, subtrees);
+	}
+	else
+	{
+		subtrees.emplace_back(nodeIndex);
+	}
+}
+
+void InnoBVH::Cull(const BVH& bvh, const Frustum& frustum, std::vector<uint32_t>& result)
+{
+	if (bvh.m_Nodes.empty())
+	{
+		return;
+	}
+
+	CullSubtree(bvh, InnoCulling::GenerateCullingFrustum(frustum), 0, result);
+}
+
+void InnoBVH::ParallelCull(const BVH& bvh, const Frustum& frustum, std::vector<uint32_t>& result)
+{
+	if (bvh.m_PrimitiveIndices.size() < m_ParallelCullingThreshold)
+	{
+		Cull(bvh, frustum, result);
+		return;
+	}
+
+	auto l_frustum = InnoCulling::GenerateCullingFrustum(frustum);
+
+	// The subtrees are collected in the depth-first order, so concatenating their results gives the same order as the serial traversal
+	std::vector<uint32_t> l_subtrees;
+	CollectCullingSubtrees(bvh, l_frustum, 0, 0, l_subtrees);
+
+	auto l_subtreeCount = l_subtrees.size();
+	std::vector<std::vector<uint32_t>> l_subtreeResults(l_subtreeCount);
+
+	InnoTaskScheduler::ParallelFor("BVHCullingTask", l_subtreeCount, 1, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			CullSubtree(bvh, l_frustum, l_subtrees[i], l_subtreeResults[i]);
+		}
+	});
+
+	std::vector<size_t> l_offsets(l_subtreeCount + 1);
+	l_offsets[0] = result.size();
+	for (size_t i = 0; i < l_subtreeCount; i++)
+	{
+		l_offsets[i + 1] = l_offsets[i] + l_subtreeResults[i].size();
+	}
+
+	result.resize(l_offsets[l_subtreeCount]);
+
+	InnoTaskScheduler::ParallelFor("BVHCullingMergeTask", l_subtreeCount, 8, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			std::copy(l_subtreeResults[i].begin(), l_subtreeResults[i].end(), result.begin() + l_offsets[i]);
+		}
+	});
+}
+
+bool InnoBVHNS::IntersectRay(const QueryRay& ray, const float* center, const float* extent, float maxDistance, float& distance)
+{
+	auto l_tMin = 0.0f;
+	auto l_tMax = maxDistance;
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		auto l_halfSize = extent[i] + ray.m_Extent[i];
+		auto l_t0 = (center[i] - l_halfSize - ray.m_Origin[i]) * ray.m_InvDirection[i];
+		auto l_t1 = (center[i] + l_halfSize - ray.m_Origin[i]) * ray.m_InvDirection[i];
+
+		l_tMin = std::max(l_tMin, std::min(l_t0, l_t1));
+		l_tMax = std::min(l_tMax, std::max(l_t0, l_t1));
+	}
+
+	distance = l_tMin;
+
+	return l_tMin <= l_tMax;
+}
+
+bool InnoBVHNS::IntersectRay(const QueryRay& ray, const BVHNode& node, float maxDistance, float& distance)
+{
+	float l_center[3] = { (node.m_BoundMax.x + node.m_BoundMin.x) * 0.5f, (node.m_BoundMax.y + node.m_BoundMin.y) * 0.5f, (node.m_BoundMax.z + node.m_BoundMin.z) * 0.5f };
+	float l_extent[3] = { (node.m_BoundMax.x - node.m_BoundMin.x) * 0.5f, (node.m_BoundMax.y - node.m_BoundMin.y) * 0.5f, (node.m_BoundMax.z - node.m_BoundMin.z) * 0.5f };
+
+	return IntersectRay(ray, l_center, l_extent, maxDistance, distance);
+}
+
+bool InnoBVH::Raycast(const BVH& bvh, const Vec4& origin, const Vec4& direction, const Vec4& extent, float maxDistance, const BVHRaycastCallback& callback, uint32_t& hitPrimitiveIndex, float& hitDistance)
+{
+	if (bvh.m_Nodes.empty())
+	{
+		return false;
+	}
+
+	// A zero direction component gets a huge inverse instead of infinity, so the slab test never produces NaN
+	QueryRay l_ray;
+	float l_direction[3] = { direction.x, direction.y, direction.z };
+	float l_origin[3] = { origin.x, origin.y, origin.z };
+	float l_extent[3] = { extent.x * 0.5f, extent.y * 0.5f, extent.z * 0.5f };
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		l_ray.m_Origin[i] = l_origin[i];
+		l_ray.m_InvDirection[i] = l_direction[i] != 0.0f ? 1.0f / l_direction[i] : FLT_MAX;
+		l_ray.m_Extent[i] = l_extent[i];
+	}
+
+	auto& l_bounds = bvh.m_PrimitiveCullingBounds;
+	auto l_closestDistance = maxDistance;
+	auto l_isHit = false;
+
+	float l_distance;
+	if (!IntersectRay(l_ray, bvh.m_Nodes[0], l_closestDistance, l_distance))
+	{
+		return false;
+	}
+
+	// The farther child is pushed with its entry distance, and skipped when popped if a closer hit has been found meanwhile
+	std::pair<uint32_t, float> l_stack[m_MaxDepth + 1];
+	uint32_t l_stackSize = 0;
+	uint32_t l_nodeIndex = 0;
+
+	while (true)
+	{
+		auto& l_node = bvh.m_Nodes[l_nodeIndex];
+
+		if (l_node.m_RightChildIndex)
+		{
+			float l_leftDistance;
+			float l_rightDistance;
+			auto l_isLeftHit = IntersectRay(l_ray, bvh.m_Nodes[l_nodeIndex + 1], l_closestDistance, l_leftDistance);
+			auto l_isRightHit = IntersectRay(l_ray, bvh.m_Nodes[l_node.m_RightChildIndex], l_closestDistance, l_rightDistance);
+
+			if (l_isLeftHit && l_isRightHit)
+			{
+				if (l_leftDistance <= l_rightDistance)
+				{
+					l_stack[l_stackSize++] = { l_node.m_RightChildIndex, l_rightDistance };
+					l_nodeIndex = l_nodeIndex + 1;
+				}
+				else
+				{
+					l_stack[l_stackSize++] = { l_nodeIndex + 1, l_leftDistance };
+					l_nodeIndex = l_node.m_RightChildIndex;
+				}
+				continue;
+			}
+			else if (l_isLeftHit || l_isRightHit)
+			{
+				l_nodeIndex = l_isLeftHit ? l_nodeIndex + 1 : l_node.m_RightChildIndex;
+				continue;
+			}
+		}
+		else
+		{
+			for (auto i = l_node.m_PrimitiveOffset; i < l_node.m_PrimitiveOffset + l_node.m_PrimitiveCount; i++)
+			{
+				float l_center[3] = { l_bounds.m_CenterX[i], l_bounds.m_CenterY[i], l_bounds.m_CenterZ[i] };
+				float l_primitiveExtent[3] = { l_bounds.m_ExtentX[i], l_bounds.m_ExtentY[i], l_bounds.m_ExtentZ[i] };
+
+				if (!IntersectRay(l_ray, l_center, l_primitiveExtent, l_closestDistance, l_distance))
+				{
+					continue;
+				}
+
+				auto l_primitiveIndex = bvh.m_PrimitiveIndices[i];
+				if (callback)
+				{
+					l_distance = callback(l_primitiveIndex, l_distance, l_closestDistance);
+					if (l_distance < 0.0f || l_distance > l_closestDistance)
+					{
+						continue;
+					}
+				}
+
+				l_closestDistance = l_distance;
+				hitPrimitiveIndex = l_primitiveIndex;
+				l_isHit = true;
+			}
+		}
+
+		while (l_stackSize && l_stack[l_stackSize - 1].second > l_closestDistance)
+		{
+			l_stackSize--;
+		}
+		if (!l_stackSize)
+		{
+			break;
+		}
+		l_nodeIndex = l_stack[--l_stackSize].first;
+	}
+
+	if (l_isHit)
+	{
+		hitDistance = l_closestDistance;
+	}
+
+	return l_isHit;
+}
+
+void InnoBVH::Overlap(const BVH& bvh, const AABB& bounds, std::vector<uint32_t>& result)
+{
+	if (bvh.m_Nodes.empty())
+	{
+		return;
+	}
+
+	auto& l_bounds = bvh.m_PrimitiveCullingBounds;
+	float l_center[3] = { (bounds.m_boundMax.x + bounds.m_boundMin.x) * 0.5f, (bounds.m_boundMax.y + bounds.m_boundMin.y) * 0.5f, (bounds.m_boundMax.z + bounds.m_boundMin.z) * 0.5f };
+	float l_extent[3] = { (bounds.m_boundMax.x - bounds.m_boundMin.x) * 0.5f, (bounds.m_boundMax.y - bounds.m_boundMin.y) * 0.5f, (bounds.m_boundMax.z - bounds.m_boundMin.z) * 0.5f };
+
+	uint32_t l_stack[m_MaxDepth + 1];
+	uint32_t l_stackSize = 0;
+	uint32_t l_nodeIndex = 0;
+
+	while (true)
+	{
+		auto& l_node = bvh.m_Nodes[l_nodeIndex];
+
+		auto l_isOverlapped = l_node.m_BoundMin.x <= bounds.m_boundMax.x && l_node.m_BoundMax.x >= bounds.m_boundMin.x
+			&& l_node.m_BoundMin.y <= bounds.m_boundMax.y && l_node.m_BoundMax.y >= bounds.m_boundMin.y
+			&& l_node.m_BoundMin.z <= bounds.m_boundMax.z && l_node.m_BoundMax.z >= bounds.m_boundMin.z;
+
+		if (l_isOverlapped)
+		{
+			auto l_isInside = l_node.m_BoundMin.x >= bounds.m_boundMin.x && l_node.m_BoundMax.x <= bounds.m_boundMax.x
+				&& l_node.m_BoundMin.y >= bounds.m_boundMin.y && l_node.m_BoundMax.y <= bounds.m_boundMax.y
+				&& l_node.m_BoundMin.z >= bounds.m_boundMin.z && l_node.m_BoundMax.z <= bounds.m_boundMax.z;
+
+			if (l_isInside)
+			{
+				auto l_first = bvh.m_PrimitiveIndices.data() + l_node.m_PrimitiveOffset;
+				result.insert(result.end(), l_first, l_first + l_node.m_PrimitiveCount);
+			}
+			else if (l_node.m_RightChildIndex)
+			{
+				l_stack[l_stackSize++] = l_node.m_RightChildIndex;
+				l_nodeIndex++;
+				continue;
+			}
+			else
+			{
+				for (auto i = l_node.m_PrimitiveOffset; i < l_node.m_PrimitiveOffset + l_node.m_PrimitiveCount; i++)
+				{
+					if (std::abs(l_bounds.m_CenterX[i] - l_center[0]) <= l_bounds.m_ExtentX[i] + l_extent[0]
+						&& std::abs(l_bounds.m_CenterY[i] - l_center[1]) <= l_bounds.m_ExtentY[i] + l_extent[1]
+						&& std::abs(l_bounds.m_CenterZ[i] - l_center[2]) <= l_bounds.m_ExtentZ[i] + l_extent[2])
+					{
+						result.emplace_back(bvh.m_PrimitiveIndices[i]);
+					}
+				}
+			}
+		}
+
+		if (!l_stackSize)
+		{
+			return;
+		}
+		l_nodeIndex = l_stack[--l_stackSize];
+	}
+}
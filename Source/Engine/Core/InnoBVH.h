@@ -0,0 +1,53 @@
+#pragma once
+#include "../Common/InnoMathHelper.h"
+#include "InnoCulling.h"
+
+struct BVHNode
+{
+	Vec4 m_BoundMin;
+	Vec4 m_BoundMax;
+	uint32_t m_ParentIndex = 0;
+	// The left child is always the next node in the depth-first order, 0 means it's a leaf node since the root can't be a right child
+	uint32_t m_RightChildIndex = 0;
+	// The primitives of the whole subtree are in [m_PrimitiveOffset, m_PrimitiveOffset + m_PrimitiveCount) of BVH::m_PrimitiveIndices
+	uint32_t m_PrimitiveOffset = 0;
+	uint32_t m_PrimitiveCount = 0;
+};
+
+struct BVH
+{
+	std::vector<BVHNode> m_Nodes;
+	std::vector<uint32_t> m_PrimitiveIndices;
+	// The leaf node index of every primitive, used by the refit
+	std::vector<uint32_t> m_PrimitiveLeafIndices;
+	// The primitive bounds in the order of m_PrimitiveIndices, leaves are tested with the SIMD culling kernel
+	CullingBounds m_PrimitiveCullingBounds;
+	// Unnormalized SAH cost, updated by the build and the refit
+	float m_SAHCost = 0.0f;
+};
+
+// Return the distance along the ray to the hit on the primitive in [boundsDistance, maxDistance], or a negative value if it's missed
+using BVHRaycastCallback = std::function<float(uint32_t primitiveIndex, float boundsDistance, float maxDistance)>;
+
+class InnoBVH
+{
+public:
+	// Binned SAH builder, large subtrees are built in parallel by the task scheduler
+	static bool Build(BVH& bvh, const AABB* primitiveBounds, size_t primitiveCount);
+	// Update the bounds from the changed primitives' leaves to the root, the topology stays the same
+	static void Refit(BVH& bvh, const AABB* primitiveBounds, const uint32_t* changedPrimitives, size_t changedPrimitiveCount);
+	// Update the bounds of all the nodes, children are always after their parent so it's one reversed pass
+	static void RefitAll(BVH& bvh, const AABB* primitiveBounds);
+	// The SAH cost relative to the root surface area, compare it with the value right after the build to measure the degradation
+	static float GetNormalizedSAHCost(const BVH& bvh);
+	// Append the indices of the primitives which intersect with the frustum to result, in the leaf order
+	static void Cull(const BVH& bvh, const Frustum& frustum, std::vector<uint32_t>& result);
+	// Same as Cull, the top levels are split into subtrees which are culled by the task scheduler and merged with a prefix sum, the result is identical to Cull
+	static void ParallelCull(const BVH& bvh, const Frustum& frustum, std::vector<uint32_t>& result);
+	// Find the closest primitive along the ray, the distance is in the unit of the direction's length
+	// The primitive bounds are inflated by the half size of extent, so a non-zero extent sweeps an AABB along the ray
+	// The bounds hit is refined by the callback if it's not empty, the nodes farther than the current closest hit are skipped
+	static bool Raycast(const BVH& bvh, const Vec4& origin, const Vec4& direction, const Vec4& extent, float maxDistance, const BVHRaycastCallback& callback, uint32_t& hitPrimitiveIndex, float& hitDistance);
+	// Append the indices of the primitives whose bounds overlap with the AABB to result, in the leaf order
+	static void Overlap(const BVH& bvh, const AABB& bounds, std::vector<uint32_t>& result);
+};
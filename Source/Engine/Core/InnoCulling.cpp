@@ -0,0 +1,176 @@
+#include "InnoCulling.h"
+#include "../Common/InnoSIMD.h"
+
+namespace InnoCullingNS
+{
+#if defined(INNO_SIMD)
+	using namespace InnoSIMD;
+
+	struct FrustumLanes
+	{
+		FloatLanes m_Normal[6][3];
+		FloatLanes m_AbsNormal[6][3];
+		FloatLanes m_Distance[6];
+	};
+
+	FrustumLanes BroadcastFrustum(const CullingFrustum& frustum)
+	{
+		FrustumLanes l_result;
+
+		for (size_t i = 0; i < 6; i++)
+		{
+			for (size_t j = 0; j < 3; j++)
+			{
+				l_result.m_Normal[i][j] = Broadcast(&frustum.m_Normal[i][j]);
+				l_result.m_AbsNormal[i][j] = Broadcast(&frustum.m_AbsNormal[i][j]);
+			}
+			l_result.m_Distance[i] = Broadcast(&frustum.m_Distance[i]);
+		}
+
+		return l_result;
+	}
+
+	// Return the bit mask of the lanes which are outside of any plane
+	inline uint32_t TestLanes(const FrustumLanes& frustum, const float* centerX, const float* centerY, const float* centerZ, const float* extentX, const float* extentY, const float* extentZ)
+	{
+		auto l_centerX = Load(centerX);
+		auto l_centerY = Load(centerY);
+		auto l_centerZ = Load(centerZ);
+		auto l_extentX = Load(extentX);
+		auto l_extentY = Load(extentY);
+		auto l_extentZ = Load(extentZ);
+
+		auto l_outside = Zero();
+
+		for (size_t i = 0; i < 6; i++)
+		{
+			auto l_distance = Sub(Add(Add(Mul(frustum.m_Normal[i][0], l_centerX), Mul(frustum.m_Normal[i][1], l_centerY)), Mul(frustum.m_Normal[i][2], l_centerZ)), frustum.m_Distance[i]);
+			auto l_radius = Add(Add(Mul(frustum.m_AbsNormal[i][0], l_extentX), Mul(frustum.m_AbsNormal[i][1], l_extentY)), Mul(frustum.m_AbsNormal[i][2], l_extentZ));
+			l_outside = Or(l_outside, Greater(l_distance, l_radius));
+		}
+
+		return MoveMask(l_outside);
+	}
+
+	// Branchless compaction, every lane is written but only the visible ones advance the output
+	inline size_t WriteLanes(uint32_t outsideMask, size_t laneCount, size_t first, const uint32_t* remap, uint32_t* result)
+	{
+		size_t l_count = 0;
+
+		for (size_t i = 0; i < laneCount; i++)
+		{
+			result[l_count] = remap ? remap[first + i] : (uint32_t)(first + i);
+			l_count += ((outsideMask >> i) & 1) ^ 1;
+		}
+
+		return l_count;
+	}
+#endif
+}
+
+CullingFrustum InnoCulling::GenerateCullingFrustum(const Frustum& frustum)
+{
+	CullingFrustum l_result;
+	const Plane* l_planes[6] = { &frustum.m_px, &frustum.m_nx, &frustum.m_py, &frustum.m_ny, &frustum.m_pz, &frustum.m_nz };
+
+	for (size_t i = 0; i < 6; i++)
+	{
+		l_result.m_Normal[i][0] = l_planes[i]->m_normal.x;
+		l_result.m_Normal[i][1] = l_planes[i]->m_normal.y;
+		l_result.m_Normal[i][2] = l_planes[i]->m_normal.z;
+		l_result.m_AbsNormal[i][0] = std::abs(l_planes[i]->m_normal.x);
+		l_result.m_AbsNormal[i][1] = std::abs(l_planes[i]->m_normal.y);
+		l_result.m_AbsNormal[i][2] = std::abs(l_planes[i]->m_normal.z);
+		l_result.m_Distance[i] = l_planes[i]->m_distance;
+	}
+
+	return l_result;
+}
+
+size_t InnoCulling::Cull(const CullingFrustum& frustum, const CullingBounds& bounds, size_t begin, size_t end, const uint32_t* remap, uint32_t* result)
+{
+#if defined(INNO_SIMD)
+	using namespace InnoCullingNS;
+
+	auto l_frustum = BroadcastFrustum(frustum);
+	size_t l_count = 0;
+	auto i = begin;
+
+	for (; i + m_LaneCount <= end; i += m_LaneCount)
+	{
+		auto l_outsideMask = TestLanes(l_frustum, &bounds.m_CenterX[i], &bounds.m_CenterY[i], &bounds.m_CenterZ[i], &bounds.m_ExtentX[i], &bounds.m_ExtentY[i], &bounds.m_ExtentZ[i]);
+		l_count += WriteLanes(l_outsideMask, m_LaneCount, i, remap, result + l_count);
+	}
+
+	// The tail is copied to a padded batch instead of reading past the end of the arrays
+	if (i < end)
+	{
+		auto l_tailCount = end - i;
+		float l_tail[6][m_LaneCount] = {};
+		const std::vector<float>* l_sources[6] = { &bounds.m_CenterX, &bounds.m_CenterY, &bounds.m_CenterZ, &bounds.m_ExtentX, &bounds.m_ExtentY, &bounds.m_ExtentZ };
+
+		for (size_t j = 0; j < 6; j++)
+		{
+			std::memcpy(l_tail[j], l_sources[j]->data() + i, l_tailCount * sizeof(float));
+		}
+
+		auto l_outsideMask = TestLanes(l_frustum, l_tail[0], l_tail[1], l_tail[2], l_tail[3], l_tail[4], l_tail[5]);
+		l_count += WriteLanes(l_outsideMask, l_tailCount, i, remap, result + l_count);
+	}
+
+	return l_count;
+#else
+	return CullScalar(frustum, bounds, begin, end, remap, result);
+#endif
+}
+
+size_t InnoCulling::CullScalar(const CullingFrustum& frustum, const CullingBounds& bounds, size_t begin, size_t end, const uint32_t* remap, uint32_t* result)
+{
+	size_t l_count = 0;
+
+	for (auto i = begin; i < end; i++)
+	{
+		auto l_visible = true;
+
+		for (size_t j = 0; j < 6; j++)
+		{
+			auto l_distance = frustum.m_Normal[j][0] * bounds.m_CenterX[i] + frustum.m_Normal[j][1] * bounds.m_CenterY[i] + frustum.m_Normal[j][2] * bounds.m_CenterZ[i] - frustum.m_Distance[j];
+			auto l_radius = frustum.m_AbsNormal[j][0] * bounds.m_ExtentX[i] + frustum.m_AbsNormal[j][1] * bounds.m_ExtentY[i] + frustum.m_AbsNormal[j][2] * bounds.m_ExtentZ[i];
+
+			if (l_distance > l_radius)
+			{
+				l_visible = false;
+				break;
+			}
+		}
+
+		if (l_visible)
+		{
+			result[l_count++] = remap ? remap[i] : (uint32_t)i;
+		}
+	}
+
+	return l_count;
+}
+
+float InnoCulling::GetPixelsPerUnit(const Mat4& projectionMatrix, float screenHeight)
+{
+	return projectionMatrix.m11 * screenHeight;
+}
+
+float InnoCulling::GetScreenSize(const Sphere& sphere, const Vec4& cameraPos, float pixelsPerUnit)
+{
+	auto l_distance = (sphere.m_center - cameraPos).length();
+
+	if (l_distance <= sphere.m_radius)
+	{
+		return std::numeric_limits<float>::max();
+	}
+
+	return sphere.m_radius * pixelsPerUnit / l_distance;
+}
+
+const char* InnoCulling::GetInstructionSet()
+{
+	return InnoSIMD::GetInstructionSet();
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "../Common/InnoMathHelper.h"
+
+// The frustum planes in the form used by the culling kernels, the normals point outside of the frustum
+struct CullingFrustum
+{
+	float m_Normal[6][3];
+	float m_AbsNormal[6][3];
+	float m_Distance[6];
+};
+
+// Center-extent bounds stored as structure of arrays, the extents are the half sizes
+struct CullingBounds
+{
+	std::vector<float> m_CenterX;
+	std::vector<float> m_CenterY;
+	std::vector<float> m_CenterZ;
+	std::vector<float> m_ExtentX;
+	std::vector<float> m_ExtentY;
+	std::vector<float> m_ExtentZ;
+
+	size_t size() const { return m_CenterX.size(); }
+
+	void resize(size_t count)
+	{
+		m_CenterX.resize(count);
+		m_CenterY.resize(count);
+		m_CenterZ.resize(count);
+		m_ExtentX.resize(count);
+		m_ExtentY.resize(count);
+		m_ExtentZ.resize(count);
+	}
+
+	void Set(size_t index, const AABB& bounds)
+	{
+		m_CenterX[index] = (bounds.m_boundMax.x + bounds.m_boundMin.x) * 0.5f;
+		m_CenterY[index] = (bounds.m_boundMax.y + bounds.m_boundMin.y) * 0.5f;
+		m_CenterZ[index] = (bounds.m_boundMax.z + bounds.m_boundMin.z) * 0.5f;
+		m_ExtentX[index] = (bounds.m_boundMax.x - bounds.m_boundMin.x) * 0.5f;
+		m_ExtentY[index] = (bounds.m_boundMax.y - bounds.m_boundMin.y) * 0.5f;
+		m_ExtentZ[index] = (bounds.m_boundMax.z - bounds.m_boundMin.z) * 0.5f;
+	}
+};
+
+class InnoCulling
+{
+public:
+	static CullingFrustum GenerateCullingFrustum(const Frustum& frustum);
+	// Test the bounds in [begin, end) against the frustum 8 (AVX) or 4 (SSE) at a time, write the indices of the visible ones to result and return their count
+	// If remap is not nullptr the written index is remap[i] instead of i; result must have room for (end - begin) indices
+	static size_t Cull(const CullingFrustum& frustum, const CullingBounds& bounds, size_t begin, size_t end, const uint32_t* remap, uint32_t* result);
+	// The scalar version of Cull, always available and used for the validation
+	static size_t CullScalar(const CullingFrustum& frustum, const CullingBounds& bounds, size_t begin, size_t end, const uint32_t* remap, uint32_t* result);
+	// The projected diameter is 2 * r / (d * tan(FOVY / 2)) * height / 2, and m11 of the projection matrix is 1 / tan(FOVY / 2)
+	static float GetPixelsPerUnit(const Mat4& projectionMatrix, float screenHeight);
+	// The projected diameter in pixels of the bound sphere, the spheres which the camera is inside of are always kept
+	static float GetScreenSize(const Sphere& sphere, const Vec4& cameraPos, float pixelsPerUnit);
+	// "AVX", "SSE" or "Scalar", decided at compile time
+	static const char* GetInstructionSet();
+};
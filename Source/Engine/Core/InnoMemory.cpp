@@ -41,6 +41,8 @@ public:
 
 		if (l_Object)
 		{
+			m_FreeChunkCount--;
+
 			// Assign new free chunk
 			auto l_Next = m_CurrentFreeChunk->m_Next;
 			if (l_Next)
@@ -61,6 +63,33 @@ public:
 		}
 	}
 
+	bool SpawnBatch(void** result, std::size_t count) override
+	{
+		if (count > m_FreeChunkCount)
+		{
+			InnoLogger::Log(LogLevel::Error, "InnoMemory: Not enough free chunks for a batch of ", count, " objects!");
+			return false;
+		}
+
+		auto l_CurrentFreeChunk = m_CurrentFreeChunk;
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			result[i] = l_CurrentFreeChunk->m_Target;
+			l_CurrentFreeChunk = l_CurrentFreeChunk->m_Next;
+		}
+
+		m_CurrentFreeChunk = l_CurrentFreeChunk;
+		m_FreeChunkCount -= count;
+
+		if (!m_CurrentFreeChunk)
+		{
+			InnoLogger::Log(LogLevel::Warning, "InnoMemory: Last free chuck has been allocated!");
+		}
+
+		return true;
+	}
+
 	void Destroy(void* const ptr) override
 	{
 		//Allocate in-place a Chunk at the corresponding position
@@ -80,6 +109,8 @@ public:
 			l_NewFreeChunk->m_Next = m_CurrentFreeChunk->m_Next;
 			m_CurrentFreeChunk->m_Next = l_NewFreeChunk;
 		}
+
+		m_FreeChunkCount++;
 	}
 
 	void Clear()
@@ -94,6 +125,9 @@ private:
 		auto l_ObjectUC = m_HeapAddress;
 		Chunk* l_PrevFreeChunk = nullptr;
 
+		m_CurrentFreeChunk = reinterpret_cast<Chunk*>(m_HeapAddress);
+		m_FreeChunkCount = m_PoolCapability;
+
 		for (auto i = 0; i < m_PoolCapability; i++)
 		{
 			auto l_NewFreeChunk = new(l_ObjectUC) Chunk();
@@ -117,6 +151,7 @@ private:
 	std::size_t m_PoolCapability;
 	unsigned char* m_HeapAddress;
 	Chunk* m_CurrentFreeChunk;
+	std::size_t m_FreeChunkCount = 0;
 };
 
 namespace MemoryMemo
@@ -17,6 +17,8 @@ public:
 	virtual ~IObjectPool() = default;
 
 	virtual void* Spawn() = 0;
+	// Reserve count slots at once, either all of them are written to result or none
+	virtual bool SpawnBatch(void** result, std::size_t count) = 0;
 	virtual void Destroy(void* const ptr) = 0;
 };
 
@@ -33,6 +35,22 @@ public:
 		return new(objectPool->Spawn()) T();
 	};
 
+	template <typename T>
+	static bool SpawnBatch(IObjectPool* objectPool, T** result, std::size_t count)
+	{
+		if (!objectPool->SpawnBatch(reinterpret_cast<void**>(result), count))
+		{
+			return false;
+		}
+
+		for (std::size_t i = 0; i < count; i++)
+		{
+			result[i] = new(result[i]) T();
+		}
+
+		return true;
+	};
+
 	template <typename T>
 	static void Destroy(IObjectPool* objectPool, T* const ptr)
 	{
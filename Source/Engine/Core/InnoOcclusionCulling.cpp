@@ -0,0 +1,289 @@
+#include "InnoOcclusionCulling.h"
+#include "../Common/InnoSIMD.h"
+
+namespace InnoOcclusionCullingNS
+{
+	// Any vertex with a smaller clip space w is treated as behind the near plane
+	const float m_MinW = 1e-4f;
+	// The occludees are tested as if they were 1% nearer, so the surfaces touching the occluders aren't culled by the rasterization error
+	const float m_OccludeeDepthBias = 1.01f;
+
+	Vec4 TransformPoint(const Mat4& m, const Vec4& p);
+	bool ToScreenSpace(const OcclusionBuffer& buffer, const Vec4& clipSpacePos, Vec4& result);
+	void RasterizeTriangle(OcclusionBuffer& buffer, const Vec4& v0, const Vec4& v1, const Vec4& v2, uint32_t rowBegin, uint32_t rowEnd);
+}
+
+using namespace InnoOcclusionCullingNS;
+
+Vec4 InnoOcclusionCullingNS::TransformPoint(const Mat4& m, const Vec4& p)
+{
+#ifdef USE_COLUMN_MAJOR_MEMORY_LAYOUT
+	return InnoMath::mul(p, m);
+#endif
+#ifdef USE_ROW_MAJOR_MEMORY_LAYOUT
+	return InnoMath::mul(m, p);
+#endif
+}
+
+bool InnoOcclusionCullingNS::ToScreenSpace(const OcclusionBuffer& buffer, const Vec4& clipSpacePos, Vec4& result)
+{
+	if (clipSpacePos.w < m_MinW)
+	{
+		return false;
+	}
+
+	auto l_invW = 1.0f / clipSpacePos.w;
+
+	result.x = (clipSpacePos.x * l_invW * 0.5f + 0.5f) * (float)buffer.m_Width;
+	result.y = (clipSpacePos.y * l_invW * 0.5f + 0.5f) * (float)buffer.m_Height;
+	result.z = l_invW;
+	result.w = 1.0f;
+
+	return true;
+}
+
+void InnoOcclusionCullingNS::RasterizeTriangle(OcclusionBuffer& buffer, const Vec4& v0, const Vec4& v1, const Vec4& v2, uint32_t rowBegin, uint32_t rowEnd)
+{
+	auto l_area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+
+	if (std::abs(l_area) < 1e-8f)
+	{
+		return;
+	}
+
+	// Both windings are rasterized, the vertices are reordered so the inside of the triangle is where all the edge functions are positive
+	const Vec4* l_vertices[3] = { &v0, &v1, &v2 };
+	if (l_area < 0.0f)
+	{
+		std::swap(l_vertices[1], l_vertices[2]);
+		l_area = -l_area;
+	}
+
+	auto l_minX = std::max(std::floor(std::min({ v0.x, v1.x, v2.x })), 0.0f);
+	auto l_maxX = std::min(std::ceil(std::max({ v0.x, v1.x, v2.x })), (float)buffer.m_Width - 1.0f);
+	auto l_minY = std::max(std::floor(std::min({ v0.y, v1.y, v2.y })), (float)rowBegin);
+	auto l_maxY = std::min(std::ceil(std::max({ v0.y, v1.y, v2.y })), (float)rowEnd - 1.0f);
+
+	if (l_minX > l_maxX || l_minY > l_maxY)
+	{
+		return;
+	}
+
+	// E(x, y) = A * x + B * y + C for the edge from a to b, the edge i is opposite to the vertex i
+	float l_edgeA[3];
+	float l_edgeB[3];
+	float l_edgeC[3];
+
+	for (uint32_t i = 0; i < 3; i++)
+	{
+		auto& l_a = *l_vertices[(i + 1) % 3];
+		auto& l_b = *l_vertices[(i + 2) % 3];
+		l_edgeA[i] = l_a.y - l_b.y;
+		l_edgeB[i] = l_b.x - l_a.x;
+		l_edgeC[i] = l_a.x * l_b.y - l_a.y * l_b.x;
+	}
+
+	// The depth is interpolated with the barycentric coordinates, which are the normalized edge functions
+	auto l_invArea = 1.0f / l_area;
+	auto l_depthA = (l_edgeA[0] * l_vertices[0]->z + l_edgeA[1] * l_vertices[1]->z + l_edgeA[2] * l_vertices[2]->z) * l_invArea;
+	auto l_depthB = (l_edgeB[0] * l_vertices[0]->z + l_edgeB[1] * l_vertices[1]->z + l_edgeB[2] * l_vertices[2]->z) * l_invArea;
+	auto l_depthC = (l_edgeC[0] * l_vertices[0]->z + l_edgeC[1] * l_vertices[1]->z + l_edgeC[2] * l_vertices[2]->z) * l_invArea;
+
+	auto l_firstX = (uint32_t)l_minX;
+	auto l_lastX = (uint32_t)l_maxX;
+
+#if defined(INNO_SIMD)
+	using namespace InnoSIMD;
+
+	// Start from an aligned column, the pixels before l_minX are outside of the triangle anyway
+	l_firstX -= l_firstX % (uint32_t)m_LaneCount;
+
+	auto l_laneOffsets = Add(LaneIndices(), Set(0.5f));
+	auto l_zero = Zero();
+
+	for (auto y = (uint32_t)l_minY; y <= (uint32_t)l_maxY; y++)
+	{
+		auto l_pixelY = (float)y + 0.5f;
+		auto l_row = buffer.m_Depth.data() + (size_t)y * buffer.m_Width;
+
+		FloatLanes l_edgeRows[3];
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			l_edgeRows[i] = Set(l_edgeB[i] * l_pixelY + l_edgeC[i]);
+		}
+		auto l_depthRow = Set(l_depthB * l_pixelY + l_depthC);
+
+		for (auto x = l_firstX; x <= l_lastX; x += (uint32_t)m_LaneCount)
+		{
+			auto l_pixelX = Add(Set((float)x), l_laneOffsets);
+
+			auto l_mask = GreaterEqual(Add(Mul(Set(l_edgeA[0]), l_pixelX), l_edgeRows[0]), l_zero);
+			l_mask = And(l_mask, GreaterEqual(Add(Mul(Set(l_edgeA[1]), l_pixelX), l_edgeRows[1]), l_zero));
+			l_mask = And(l_mask, GreaterEqual(Add(Mul(Set(l_edgeA[2]), l_pixelX), l_edgeRows[2]), l_zero));
+
+			if (!MoveMask(l_mask))
+			{
+				continue;
+			}
+
+			auto l_depth = Add(Mul(Set(l_depthA), l_pixelX), l_depthRow);
+			auto l_oldDepth = Load(l_row + x);
+			Store(l_row + x, Select(l_mask, Max(l_oldDepth, l_depth), l_oldDepth));
+		}
+	}
+#else
+	for (auto y = (uint32_t)l_minY; y <= (uint32_t)l_maxY; y++)
+	{
+		auto l_pixelY = (float)y + 0.5f;
+		auto l_row = buffer.m_Depth.data() + (size_t)y * buffer.m_Width;
+
+		for (auto x = l_firstX; x <= l_lastX; x++)
+		{
+			auto l_pixelX = (float)x + 0.5f;
+
+			if (l_edgeA[0] * l_pixelX + l_edgeB[0] * l_pixelY + l_edgeC[0] >= 0.0f
+				&& l_edgeA[1] * l_pixelX + l_edgeB[1] * l_pixelY + l_edgeC[1] >= 0.0f
+				&& l_edgeA[2] * l_pixelX + l_edgeB[2] * l_pixelY + l_edgeC[2] >= 0.0f)
+			{
+				l_row[x] = std::max(l_row[x], l_depthA * l_pixelX + l_depthB * l_pixelY + l_depthC);
+			}
+		}
+	}
+#endif
+}
+
+void InnoOcclusionCulling::Clear(OcclusionBuffer& buffer, uint32_t width, uint32_t height)
+{
+	buffer.m_TileCountX = (width + m_TileSize - 1) / m_TileSize;
+	buffer.m_TileCountY = (height + m_TileSize - 1) / m_TileSize;
+	buffer.m_Width = buffer.m_TileCountX * m_TileSize;
+	buffer.m_Height = height;
+
+	buffer.m_Depth.assign((size_t)buffer.m_Width * buffer.m_Height, 0.0f);
+	buffer.m_TileDepth.assign((size_t)buffer.m_TileCountX * buffer.m_TileCountY, 0.0f);
+}
+
+void InnoOcclusionCulling::TransformOccluderVertices(const OcclusionBuffer& buffer, const Mat4& WVP, const Vertex* vertices, size_t vertexCount, Vec4* result)
+{
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		if (!ToScreenSpace(buffer, TransformPoint(WVP, vertices[i].m_pos), result[i]))
+		{
+			result[i] = Vec4(0.0f, 0.0f, 0.0f, 0.0f);
+		}
+	}
+}
+
+void InnoOcclusionCulling::RasterizeOccluder(OcclusionBuffer& buffer, const Vec4* screenVertices, const uint32_t* indices, size_t indexCount, uint32_t rowBegin, uint32_t rowEnd)
+{
+	rowEnd = std::min(rowEnd, buffer.m_Height);
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		auto& l_v0 = screenVertices[indices[i]];
+		auto& l_v1 = screenVertices[indices[i + 1]];
+		auto& l_v2 = screenVertices[indices[i + 2]];
+
+		if (l_v0.w == 0.0f || l_v1.w == 0.0f || l_v2.w == 0.0f)
+		{
+			continue;
+		}
+
+		RasterizeTriangle(buffer, l_v0, l_v1, l_v2, rowBegin, rowEnd);
+	}
+}
+
+void InnoOcclusionCulling::UpdateHierarchy(OcclusionBuffer& buffer)
+{
+	for (uint32_t i = 0; i < buffer.m_TileCountY; i++)
+	{
+		auto l_lastY = std::min((i + 1) * m_TileSize, buffer.m_Height);
+
+		for (uint32_t j = 0; j < buffer.m_TileCountX; j++)
+		{
+			auto l_tileDepth = std::numeric_limits<float>::max();
+
+			for (auto y = i * m_TileSize; y < l_lastY; y++)
+			{
+				auto l_row = buffer.m_Depth.data() + (size_t)y * buffer.m_Width + j * m_TileSize;
+				for (uint32_t x = 0; x < m_TileSize; x++)
+				{
+					l_tileDepth = std::min(l_tileDepth, l_row[x]);
+				}
+			}
+
+			buffer.m_TileDepth[i * buffer.m_TileCountX + j] = l_tileDepth;
+		}
+	}
+}
+
+bool InnoOcclusionCulling::TestOccludee(const OcclusionBuffer& buffer, const Mat4& VP, const AABB& bounds)
+{
+	auto l_minX = std::numeric_limits<float>::max();
+	auto l_minY = std::numeric_limits<float>::max();
+	auto l_maxX = -std::numeric_limits<float>::max();
+	auto l_maxY = -std::numeric_limits<float>::max();
+	auto l_nearestDepth = 0.0f;
+
+	for (uint32_t i = 0; i < 8; i++)
+	{
+		auto l_corner = Vec4((i & 1) ? bounds.m_boundMax.x : bounds.m_boundMin.x, (i & 2) ? bounds.m_boundMax.y : bounds.m_boundMin.y, (i & 4) ? bounds.m_boundMax.z : bounds.m_boundMin.z, 1.0f);
+
+		Vec4 l_screenSpacePos;
+
+		// Crossing the near plane, it's too close to be hidden by anything
+		if (!ToScreenSpace(buffer, TransformPoint(VP, l_corner), l_screenSpacePos))
+		{
+			return true;
+		}
+
+		l_minX = std::min(l_minX, l_screenSpacePos.x);
+		l_minY = std::min(l_minY, l_screenSpacePos.y);
+		l_maxX = std::max(l_maxX, l_screenSpacePos.x);
+		l_maxY = std::max(l_maxY, l_screenSpacePos.y);
+		l_nearestDepth = std::max(l_nearestDepth, l_screenSpacePos.z);
+	}
+
+	l_nearestDepth *= m_OccludeeDepthBias;
+
+	// Every pixel the projected box touches is tested
+	auto l_firstX = (int32_t)std::max(std::floor(l_minX), 0.0f);
+	auto l_firstY = (int32_t)std::max(std::floor(l_minY), 0.0f);
+	auto l_lastX = (int32_t)std::min(std::floor(l_maxX), (float)buffer.m_Width - 1.0f);
+	auto l_lastY = (int32_t)std::min(std::floor(l_maxY), (float)buffer.m_Height - 1.0f);
+
+	if (l_firstX > l_lastX || l_firstY > l_lastY)
+	{
+		return false;
+	}
+
+	for (auto i = l_firstY / (int32_t)m_TileSize; i <= l_lastY / (int32_t)m_TileSize; i++)
+	{
+		for (auto j = l_firstX / (int32_t)m_TileSize; j <= l_lastX / (int32_t)m_TileSize; j++)
+		{
+			if (buffer.m_TileDepth[i * buffer.m_TileCountX + j] > l_nearestDepth)
+			{
+				continue;
+			}
+
+			auto l_tileFirstY = std::max(l_firstY, i * (int32_t)m_TileSize);
+			auto l_tileLastY = std::min(l_lastY, (i + 1) * (int32_t)m_TileSize - 1);
+			auto l_tileFirstX = std::max(l_firstX, j * (int32_t)m_TileSize);
+			auto l_tileLastX = std::min(l_lastX, (j + 1) * (int32_t)m_TileSize - 1);
+
+			for (auto y = l_tileFirstY; y <= l_tileLastY; y++)
+			{
+				auto l_row = buffer.m_Depth.data() + (size_t)y * buffer.m_Width;
+				for (auto x = l_tileFirstX; x <= l_tileLastX; x++)
+				{
+					if (l_row[x] <= l_nearestDepth)
+					{
+						return true;
+					}
+				}
+			}
+		}
+	}
+
+	return false;
+}
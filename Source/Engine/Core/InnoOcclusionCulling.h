@@ -0,0 +1,33 @@
+#pragma once
+#include "../Common/InnoMathHelper.h"
+
+// A low resolution depth buffer for the software occlusion culling
+// The depth is stored as 1/w, so nearer is larger and 0 is infinitely far, and it's linear in the screen space
+struct OcclusionBuffer
+{
+	// The width is rounded up to a multiple of the tile size, so a row can always be processed in whole SIMD batches
+	uint32_t m_Width = 0;
+	uint32_t m_Height = 0;
+	uint32_t m_TileCountX = 0;
+	uint32_t m_TileCountY = 0;
+	std::vector<float> m_Depth;
+	// The farthest depth of every tile, an occludee farther than it is hidden by the whole tile
+	std::vector<float> m_TileDepth;
+};
+
+class InnoOcclusionCulling
+{
+public:
+	static const uint32_t m_TileSize = 8;
+
+	static void Clear(OcclusionBuffer& buffer, uint32_t width, uint32_t height);
+	// Transform the vertices to the screen space of the buffer, the result is (x, y, 1/w, 1) in pixels, or (0, 0, 0, 0) if the vertex is behind the near plane
+	static void TransformOccluderVertices(const OcclusionBuffer& buffer, const Mat4& WVP, const Vertex* vertices, size_t vertexCount, Vec4* result);
+	// Rasterize the triangles into the rows in [rowBegin, rowEnd), different row ranges could be rasterized by different threads at the same time
+	// The triangles which have any vertex behind the near plane are skipped, so an occluder never hides more than it should
+	static void RasterizeOccluder(OcclusionBuffer& buffer, const Vec4* screenVertices, const uint32_t* indices, size_t indexCount, uint32_t rowBegin, uint32_t rowEnd);
+	// Update the tile depths after all the occluders are rasterized
+	static void UpdateHierarchy(OcclusionBuffer& buffer);
+	// Return false only if the AABB is completely behind the rasterized occluders
+	static bool TestOccludee(const OcclusionBuffer& buffer, const Mat4& VP, const AABB& bounds);
+};
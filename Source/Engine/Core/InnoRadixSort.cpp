@@ -0,0 +1,71 @@
+#include "InnoRadixSort.h"
+
+namespace InnoRadixSortNS
+{
+	// 11 bits per digit takes 6 passes for 64-bit keys, and a histogram still fits in the L1 cache
+	const uint32_t m_DigitBits = 11;
+	const uint32_t m_DigitCount = (64 + m_DigitBits - 1) / m_DigitBits;
+	const uint32_t m_BucketCount = 1 << m_DigitBits;
+}
+
+using namespace InnoRadixSortNS;
+
+void InnoRadixSort::Sort(uint64_t* keys, uint32_t* values, size_t count, uint64_t* scratchKeys, uint32_t* scratchValues)
+{
+	if (count < 2)
+	{
+		return;
+	}
+
+	// All the histograms are built in one pass over the keys
+	std::array<std::array<uint32_t, m_BucketCount>, m_DigitCount> l_histograms = {};
+
+	for (size_t i = 0; i < count; i++)
+	{
+		auto l_key = keys[i];
+		for (uint32_t j = 0; j < m_DigitCount; j++)
+		{
+			l_histograms[j][(l_key >> (j * m_DigitBits)) & (m_BucketCount - 1)]++;
+		}
+	}
+
+	auto l_sourceKeys = keys;
+	auto l_sourceValues = values;
+	auto l_targetKeys = scratchKeys;
+	auto l_targetValues = scratchValues;
+
+	for (uint32_t j = 0; j < m_DigitCount; j++)
+	{
+		auto& l_histogram = l_histograms[j];
+		auto l_shift = j * m_DigitBits;
+
+		if (l_histogram[(l_sourceKeys[0] >> l_shift) & (m_BucketCount - 1)] == count)
+		{
+			continue;
+		}
+
+		uint32_t l_offsets[m_BucketCount];
+		uint32_t l_offset = 0;
+		for (uint32_t k = 0; k < m_BucketCount; k++)
+		{
+			l_offsets[k] = l_offset;
+			l_offset += l_histogram[k];
+		}
+
+		for (size_t i = 0; i < count; i++)
+		{
+			auto l_target = l_offsets[(l_sourceKeys[i] >> l_shift) & (m_BucketCount - 1)]++;
+			l_targetKeys[l_target] = l_sourceKeys[i];
+			l_targetValues[l_target] = l_sourceValues[i];
+		}
+
+		std::swap(l_sourceKeys, l_targetKeys);
+		std::swap(l_sourceValues, l_targetValues);
+	}
+
+	if (l_sourceKeys != keys)
+	{
+		std::memcpy(keys, l_sourceKeys, count * sizeof(uint64_t));
+		std::memcpy(values, l_sourceValues, count * sizeof(uint32_t));
+	}
+}
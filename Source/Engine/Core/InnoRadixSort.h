@@ -0,0 +1,10 @@
+#pragma once
+#include "../Common/STL14.h"
+
+class InnoRadixSort
+{
+public:
+	// Stable LSD radix sort of the keys and their values, 11 bits per pass, the passes where all the keys have the same digit are skipped
+	// The scratch arrays must be as large as the input, the result is always in keys and values
+	static void Sort(uint64_t* keys, uint32_t* values, size_t count, uint64_t* scratchKeys, uint32_t* scratchValues);
+};
@@ -0,0 +1,1520 @@
+#include "InnoRigidBodyDynamics.h"
+#include "InnoTaskScheduler.h"
+#include "InnoLogger.h"
+#include <cfloat>
+
+namespace InnoRigidBodyDynamicsNS
+{
+	const float m_LinearSlop = 0.005f;
+	const float m_BaumgarteFactor = 0.2f;
+	const float m_RestitutionThreshold = 1.0f;
+	const float m_LinearDamping = 0.01f;
+	const float m_AngularDamping = 0.05f;
+	// A body slower than these is still, and an island which has been still for m_TimeToSleep falls asleep
+	const float m_SleepLinearVelocity = 0.05f;
+	const float m_SleepAngularVelocity = 0.05f;
+	const float m_TimeToSleep = 0.5f;
+	// The analytic contacts are kept within this separation, so the resting contacts don't flicker between the steps
+	const float m_ContactMargin = 0.02f;
+	const float m_AABBMargin = 0.04f;
+	// A contact point of the previous step within this distance is treated as the same point
+	const float m_ContactMatchDistance = 0.05f;
+	// The convex vertex sets are decimated to their extreme points along these many directions
+	const size_t m_ConvexSupportDirectionCount = 64;
+	const uint32_t m_MaxGJKIterationCount = 64;
+	const uint32_t m_MaxEPAIterationCount = 64;
+	const uint32_t m_MaxEPAVertexCount = m_MaxEPAIterationCount + 4;
+	const uint32_t m_MaxEPAFaceCount = 256;
+	const float m_EPATolerance = 1e-4f;
+	const size_t m_ParallelGrainSize = 64;
+
+	struct ContactResult
+	{
+		// From the first shape to the second one
+		Vec4 m_Normal;
+		uint32_t m_PointCount = 0;
+		Vec4 m_Positions[8];
+		float m_Depths[8];
+	};
+
+	struct SupportPoint
+	{
+		// m_SupportA - m_SupportB
+		Vec4 m_Point;
+		Vec4 m_SupportA;
+		Vec4 m_SupportB;
+	};
+
+	inline Vec4 Vector(float x, float y, float z)
+	{
+		return Vec4(x, y, z, 0.0f);
+	}
+
+	inline float Dot3(const Vec4& lhs, const Vec4& rhs)
+	{
+		return lhs.x * rhs.x + lhs.y * rhs.y + lhs.z * rhs.z;
+	}
+
+	inline float Length3(const Vec4& rhs)
+	{
+		return std::sqrt(Dot3(rhs, rhs));
+	}
+
+	inline float GetComponent(const Vec4& rhs, uint32_t axis)
+	{
+		return axis == 0 ? rhs.x : (axis == 1 ? rhs.y : rhs.z);
+	}
+
+	inline uint64_t GetPairKey(uint32_t bodyA, uint32_t bodyB)
+	{
+		return ((uint64_t)bodyA << 32) | bodyB;
+	}
+
+	void UpdateAxes(RigidBody& body)
+	{
+		auto& q = body.m_Rotation;
+
+		body.m_Axes[0] = Vector(1.0f - 2.0f * (q.y * q.y + q.z * q.z), 2.0f * (q.x * q.y + q.w * q.z), 2.0f * (q.x * q.z - q.w * q.y));
+		body.m_Axes[1] = Vector(2.0f * (q.x * q.y - q.w * q.z), 1.0f - 2.0f * (q.x * q.x + q.z * q.z), 2.0f * (q.y * q.z + q.w * q.x));
+		body.m_Axes[2] = Vector(2.0f * (q.x * q.z + q.w * q.y), 2.0f * (q.y * q.z - q.w * q.x), 1.0f - 2.0f * (q.x * q.x + q.y * q.y));
+	}
+
+	inline Vec4 Rotate(const RigidBody& body, const Vec4& rhs)
+	{
+		return body.m_Axes[0] * rhs.x + body.m_Axes[1] * rhs.y + body.m_Axes[2] * rhs.z;
+	}
+
+	inline Vec4 InverseRotate(const RigidBody& body, const Vec4& rhs)
+	{
+		return Vector(Dot3(body.m_Axes[0], rhs), Dot3(body.m_Axes[1], rhs), Dot3(body.m_Axes[2], rhs));
+	}
+
+	inline Vec4 ApplyInvInertia(const RigidBody& body, const Vec4& rhs)
+	{
+		return Rotate(body, InverseRotate(body, rhs).scale(body.m_InvInertiaLS));
+	}
+
+	Vec4 GetSupport(const RigidBodyWorld& world, const RigidBody& body, const Vec4& direction)
+	{
+		switch (body.m_ShapeType)
+		{
+		case RigidBodyShapeType::Sphere:
+		{
+			auto l_length = Length3(direction);
+			return l_length > FLT_EPSILON ? body.m_Position + direction * (body.m_Radius / l_length) : body.m_Position;
+		}
+		case RigidBodyShapeType::Box:
+		{
+			auto l_result = body.m_Position;
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				auto l_halfExtent = GetComponent(body.m_HalfExtents, i);
+				l_result = l_result + body.m_Axes[i] * (Dot3(body.m_Axes[i], direction) > 0.0f ? l_halfExtent : -l_halfExtent);
+			}
+			return l_result;
+		}
+		default:
+		{
+			auto& l_vertices = world.m_ConvexShapes[body.m_ConvexShapeIndex];
+			auto l_directionLS = InverseRotate(body, direction);
+			size_t l_bestIndex = 0;
+			auto l_bestDot = -FLT_MAX;
+
+			for (size_t i = 0; i < l_vertices.size(); i++)
+			{
+				auto l_dot = Dot3(l_vertices[i], l_directionLS);
+				if (l_dot > l_bestDot)
+				{
+					l_bestDot = l_dot;
+					l_bestIndex = i;
+				}
+			}
+			return body.m_Position + Rotate(body, l_vertices[l_bestIndex]);
+		}
+		}
+	}
+
+	void UpdateAABB(const RigidBodyWorld& world, RigidBody& body)
+	{
+		Vec4 l_extent;
+
+		switch (body.m_ShapeType)
+		{
+		case RigidBodyShapeType::Sphere:
+			l_extent = Vector(body.m_Radius, body.m_Radius, body.m_Radius);
+			break;
+		case RigidBodyShapeType::Box:
+			l_extent = Vector(
+				std::abs(body.m_Axes[0].x) * body.m_HalfExtents.x + std::abs(body.m_Axes[1].x) * body.m_HalfExtents.y + std::abs(body.m_Axes[2].x) * body.m_HalfExtents.z,
+				std::abs(body.m_Axes[0].y) * body.m_HalfExtents.x + std::abs(body.m_Axes[1].y) * body.m_HalfExtents.y + std::abs(body.m_Axes[2].y) * body.m_HalfExtents.z,
+				std::abs(body.m_Axes[0].z) * body.m_HalfExtents.x + std::abs(body.m_Axes[1].z) * body.m_HalfExtents.y + std::abs(body.m_Axes[2].z) * body.m_HalfExtents.z);
+			break;
+		default:
+		{
+			// The convex hull isn't centered, so take the support points on both sides of every axis
+			auto l_boundMax = Vector(GetSupport(world, body, Vector(1.0f, 0.0f, 0.0f)).x, GetSupport(world, body, Vector(0.0f, 1.0f, 0.0f)).y, GetSupport(world, body, Vector(0.0f, 0.0f, 1.0f)).z);
+			auto l_boundMin = Vector(GetSupport(world, body, Vector(-1.0f, 0.0f, 0.0f)).x, GetSupport(world, body, Vector(0.0f, -1.0f, 0.0f)).y, GetSupport(world, body, Vector(0.0f, 0.0f, -1.0f)).z);
+			l_boundMax = l_boundMax + m_AABBMargin;
+			l_boundMin = l_boundMin - m_AABBMargin;
+			l_boundMax.w = 1.0f;
+			l_boundMin.w = 1.0f;
+			body.m_AABBWS = InnoMath::generateAABB(l_boundMax, l_boundMin);
+			return;
+		}
+		}
+
+		l_extent = l_extent + m_AABBMargin;
+		l_extent.w = 0.0f;
+		body.m_AABBWS = InnoMath::generateAABB(body.m_Position + l_extent, body.m_Position - l_extent);
+	}
+
+	void AddContactPoint(ContactResult& result, const Vec4& position, float depth)
+	{
+		if (result.m_PointCount < 8)
+		{
+			result.m_Positions[result.m_PointCount] = position;
+			result.m_Depths[result.m_PointCount] = depth;
+			result.m_PointCount++;
+		}
+	}
+
+	bool CollideSpheres(const RigidBody& sphereA, const RigidBody& sphereB, ContactResult& result)
+	{
+		auto l_delta = sphereB.m_Position - sphereA.m_Position;
+		auto l_distance = Length3(l_delta);
+		auto l_depth = sphereA.m_Radius + sphereB.m_Radius - l_distance;
+
+		if (l_depth < -m_ContactMargin)
+		{
+			return false;
+		}
+
+		result.m_Normal = l_distance > FLT_EPSILON ? l_delta * (1.0f / l_distance) : Vector(0.0f, 1.0f, 0.0f);
+		auto l_pointA = sphereA.m_Position + result.m_Normal * sphereA.m_Radius;
+		auto l_pointB = sphereB.m_Position - result.m_Normal * sphereB.m_Radius;
+		AddContactPoint(result, (l_pointA + l_pointB) * 0.5f, l_depth);
+
+		return true;
+	}
+
+	bool CollideBoxSphere(const RigidBody& box, const RigidBody& sphere, ContactResult& result)
+	{
+		auto l_centerLS = InverseRotate(box, sphere.m_Position - box.m_Position);
+		auto l_closestLS = Vector(
+			std::max(-box.m_HalfExtents.x, std::min(l_centerLS.x, box.m_HalfExtents.x)),
+			std::max(-box.m_HalfExtents.y, std::min(l_centerLS.y, box.m_HalfExtents.y)),
+			std::max(-box.m_HalfExtents.z, std::min(l_centerLS.z, box.m_HalfExtents.z)));
+		auto l_delta = l_centerLS - l_closestLS;
+		auto l_distance = Length3(l_delta);
+		Vec4 l_normalLS;
+		float l_depth;
+
+		if (l_distance > FLT_EPSILON)
+		{
+			l_depth = sphere.m_Radius - l_distance;
+			l_normalLS = l_delta * (1.0f / l_distance);
+		}
+		else
+		{
+			// The center is inside of the box, push it out through the nearest face
+			uint32_t l_axis = 0;
+			auto l_minDistance = FLT_MAX;
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				auto l_faceDistance = GetComponent(box.m_HalfExtents, i) - std::abs(GetComponent(l_centerLS, i));
+				if (l_faceDistance < l_minDistance)
+				{
+					l_minDistance = l_faceDistance;
+					l_axis = i;
+				}
+			}
+			auto l_sign = GetComponent(l_centerLS, l_axis) >= 0.0f ? 1.0f : -1.0f;
+			l_normalLS = Vector(l_axis == 0 ? l_sign : 0.0f, l_axis == 1 ? l_sign : 0.0f, l_axis == 2 ? l_sign : 0.0f);
+			l_closestLS = l_centerLS + l_normalLS * l_minDistance;
+			l_depth = sphere.m_Radius + l_minDistance;
+		}
+
+		if (l_depth < -m_ContactMargin)
+		{
+			return false;
+		}
+
+		result.m_Normal = Rotate(box, l_normalLS);
+		auto l_pointA = box.m_Position + Rotate(box, l_closestLS);
+		auto l_pointB = sphere.m_Position - result.m_Normal * sphere.m_Radius;
+		AddContactPoint(result, (l_pointA + l_pointB) * 0.5f, l_depth);
+
+		return true;
+	}
+
+	// Sutherland-Hodgman clipping of the polygon against the plane Dot3(normal, p) <= distance
+	uint32_t ClipPolygon(const Vec4* input, uint32_t inputCount, const Vec4& normal, float distance, Vec4* output)
+	{
+		uint32_t l_outputCount = 0;
+
+		for (uint32_t i = 0; i < inputCount; i++)
+		{
+			auto& l_current = input[i];
+			auto& l_next = input[(i + 1) % inputCount];
+			auto l_currentDistance = Dot3(normal, l_current) - distance;
+			auto l_nextDistance = Dot3(normal, l_next) - distance;
+
+			if (l_currentDistance <= 0.0f)
+			{
+				output[l_outputCount++] = l_current;
+			}
+			if ((l_currentDistance <= 0.0f) != (l_nextDistance <= 0.0f))
+			{
+				auto l_t = l_currentDistance / (l_currentDistance - l_nextDistance);
+				output[l_outputCount++] = l_current + (l_next - l_current) * l_t;
+			}
+		}
+
+		return l_outputCount;
+	}
+
+	// The SAT test of the 15 axes, then the incident face is clipped by the reference face for the face contacts
+	bool CollideBoxes(const RigidBody& boxA, const RigidBody& boxB, ContactResult& result)
+	{
+		auto l_delta = boxB.m_Position - boxA.m_Position;
+
+		auto l_bestFaceSeparation = -FLT_MAX;
+		uint32_t l_bestFaceAxis = 0;
+		Vec4 l_bestFaceNormal;
+		auto l_bestEdgeSeparation = -FLT_MAX;
+		uint32_t l_bestEdgeAxis = 0;
+		Vec4 l_bestEdgeNormal;
+
+		for (uint32_t i = 0; i < 15; i++)
+		{
+			Vec4 l_axis;
+			if (i < 3)
+			{
+				l_axis = boxA.m_Axes[i];
+			}
+			else if (i < 6)
+			{
+				l_axis = boxB.m_Axes[i - 3];
+			}
+			else
+			{
+				l_axis = boxA.m_Axes[(i - 6) / 3].cross(boxB.m_Axes[(i - 6) % 3]);
+				auto l_length = Length3(l_axis);
+				// Parallel edges are covered by the face axes
+				if (l_length < 1e-4f)
+				{
+					continue;
+				}
+				l_axis = l_axis * (1.0f / l_length);
+			}
+
+			auto l_radiusA = std::abs(Dot3(l_axis, boxA.m_Axes[0])) * boxA.m_HalfExtents.x + std::abs(Dot3(l_axis, boxA.m_Axes[1])) * boxA.m_HalfExtents.y + std::abs(Dot3(l_axis, boxA.m_Axes[2])) * boxA.m_HalfExtents.z;
+			auto l_radiusB = std::abs(Dot3(l_axis, boxB.m_Axes[0])) * boxB.m_HalfExtents.x + std::abs(Dot3(l_axis, boxB.m_Axes[1])) * boxB.m_HalfExtents.y + std::abs(Dot3(l_axis, boxB.m_Axes[2])) * boxB.m_HalfExtents.z;
+			auto l_distance = Dot3(l_axis, l_delta);
+			auto l_separation = std::abs(l_distance) - l_radiusA - l_radiusB;
+
+			if (l_separation > m_ContactMargin)
+			{
+				return false;
+			}
+
+			auto l_normal = l_distance < 0.0f ? l_axis * -1.0f : l_axis;
+
+			if (i < 6)
+			{
+				// Prefer the faces of A for the stable reference faces between the steps
+				if (i < 3 ? l_separation > l_bestFaceSeparation : l_separation > 0.95f * l_bestFaceSeparation + 0.005f)
+				{
+					l_bestFaceSeparation = l_separation;
+					l_bestFaceAxis = i;
+					l_bestFaceNormal = l_normal;
+				}
+			}
+			else if (l_separation > l_bestEdgeSeparation)
+			{
+				l_bestEdgeSeparation = l_separation;
+				l_bestEdgeAxis = i - 6;
+				l_bestEdgeNormal = l_normal;
+			}
+		}
+
+		if (l_bestEdgeSeparation > 0.95f * l_bestFaceSeparation + 0.01f)
+		{
+			result.m_Normal = l_bestEdgeNormal;
+
+			auto l_edgeA = l_bestEdgeAxis / 3;
+			auto l_edgeB = l_bestEdgeAxis % 3;
+			auto l_pointA = boxA.m_Position;
+			auto l_pointB = boxB.m_Position;
+
+			for (uint32_t i = 0; i < 3; i++)
+			{
+				if (i != l_edgeA)
+				{
+					auto l_halfExtent = GetComponent(boxA.m_HalfExtents, i);
+					l_pointA = l_pointA + boxA.m_Axes[i] * (Dot3(boxA.m_Axes[i], result.m_Normal) > 0.0f ? l_halfExtent : -l_halfExtent);
+				}
+				if (i != l_edgeB)
+				{
+					auto l_halfExtent = GetComponent(boxB.m_HalfExtents, i);
+					l_pointB = l_pointB + boxB.m_Axes[i] * (Dot3(boxB.m_Axes[i], result.m_Normal) > 0.0f ? -l_halfExtent : l_halfExtent);
+				}
+			}
+
+			// The closest points of the two edge lines, clamped to the edges
+			auto& l_directionA = boxA.m_Axes[l_edgeA];
+			auto& l_directionB = boxB.m_Axes[l_edgeB];
+			auto l_r = l_pointA - l_pointB;
+			auto b = Dot3(l_directionA, l_directionB);
+			auto c = Dot3(l_directionA, l_r);
+			auto f = Dot3(l_directionB, l_r);
+			auto l_denominator = std::max(1.0f - b * b, FLT_EPSILON);
+			auto l_halfExtentA = GetComponent(boxA.m_HalfExtents, l_edgeA);
+			auto l_halfExtentB = GetComponent(boxB.m_HalfExtents, l_edgeB);
+			auto s = std::max(-l_halfExtentA, std::min((b * f - c) / l_denominator, l_halfExtentA));
+			auto t = std::max(-l_halfExtentB, std::min((f - b * c) / l_denominator, l_halfExtentB));
+
+			AddContactPoint(result, (l_pointA + l_directionA * s + l_pointB + l_directionB * t) * 0.5f, -l_bestEdgeSeparation);
+
+			return true;
+		}
+
+		// The normal is from the reference box to the incident box
+		auto l_isReferenceA = l_bestFaceAxis < 3;
+		auto& l_reference = l_isReferenceA ? boxA : boxB;
+		auto& l_incident = l_isReferenceA ? boxB : boxA;
+		auto l_referenceNormal = l_isReferenceA ? l_bestFaceNormal : l_bestFaceNormal * -1.0f;
+		auto l_referenceAxis = l_bestFaceAxis % 3;
+		auto l_referenceCenter = l_reference.m_Position + l_referenceNormal * GetComponent(l_reference.m_HalfExtents, l_referenceAxis);
+
+		uint32_t l_incidentAxis = 0;
+		auto l_maxDot = -1.0f;
+		for (uint32_t i = 0; i < 3; i++)
+		{
+			auto l_dot = std::abs(Dot3(l_incident.m_Axes[i], l_referenceNormal));
+			if (l_dot > l_maxDot)
+			{
+				l_maxDot = l_dot;
+				l_incidentAxis = i;
+			}
+		}
+
+		auto l_incidentSign = Dot3(l_incident.m_Axes[l_incidentAxis], l_referenceNormal) > 0.0f ? -1.0f : 1.0f;
+		auto l_incidentCenter = l_incident.m_Position + l_incident.m_Axes[l_incidentAxis] * (l_incidentSign * GetComponent(l_incident.m_HalfExtents, l_incidentAxis));
+		auto l_incidentU = (l_incidentAxis + 1) % 3;
+		auto l_incidentV = (l_incidentAxis + 2) % 3;
+		auto l_u = l_incident.m_Axes[l_incidentU] * GetComponent(l_incident.m_HalfExtents, l_incidentU);
+		auto l_v = l_incident.m_Axes[l_incidentV] * GetComponent(l_incident.m_HalfExtents, l_incidentV);
+
+		Vec4 l_polygon[2][16];
+		l_polygon[0][0] = l_incidentCenter + l_u + l_v;
+		l_polygon[0][1] = l_incidentCenter - l_u + l_v;
+		l_polygon[0][2] = l_incidentCenter - l_u - l_v;
+		l_polygon[0][3] = l_incidentCenter + l_u - l_v;
+		uint32_t l_polygonCount = 4;
+		uint32_t l_current = 0;
+
+		for (uint32_t i = 1; i < 3; i++)
+		{
+			auto l_sideAxis = (l_referenceAxis + i) % 3;
+			auto& l_sideNormal = l_reference.m_Axes[l_sideAxis];
+			auto l_sideOffset = Dot3(l_sideNormal, l_reference.m_Position);
+			auto l_halfExtent = GetComponent(l_reference.m_HalfExtents, l_sideAxis);
+
+			l_polygonCount = ClipPolygon(l_polygon[l_current], l_polygonCount, l_sideNormal, l_sideOffset + l_halfExtent, l_polygon[l_current ^ 1]);
+			l_current ^= 1;
+			l_polygonCount = ClipPolygon(l_polygon[l_current], l_polygonCount, l_sideNormal * -1.0f, -l_sideOffset + l_halfExtent, l_polygon[l_current ^ 1]);
+			l_current ^= 1;
+		}
+
+		result.m_Normal = l_bestFaceNormal;
+
+		for (uint32_t i = 0; i < l_polygonCount; i++)
+		{
+			auto l_separation = Dot3(l_referenceNormal, l_polygon[l_current][i] - l_referenceCenter);
+			if (l_separation <= m_ContactMargin)
+			{
+				AddContactPoint(result, l_polygon[l_current][i] - l_referenceNormal * (l_separation * 0.5f), -l_separation);
+			}
+		}
+
+		return result.m_PointCount > 0;
+	}
+
+	SupportPoint GetMinkowskiSupport(const RigidBodyWorld& world, const RigidBody& bodyA, const RigidBody& bodyB, const Vec4& direction)
+	{
+		SupportPoint l_result;
+
+		l_result.m_SupportA = GetSupport(world, bodyA, direction);
+		l_result.m_SupportB = GetSupport(world, bodyB, direction * -1.0f);
+		l_result.m_Point = l_result.m_SupportA - l_result.m_SupportB;
+		l_result.m_Point.w = 0.0f;
+
+		return l_result;
+	}
+
+	Vec4 GetPerpendicular(const Vec4& rhs)
+	{
+		return std::abs(rhs.x) < 0.57f ? rhs.cross(Vector(1.0f, 0.0f, 0.0f)) : rhs.cross(Vector(0.0f, 1.0f, 0.0f));
+	}
+
+	// The simplex is ordered from the oldest to the newest point, return true if it encloses the origin
+	bool UpdateSimplex(SupportPoint* simplex, uint32_t& count, Vec4& direction)
+	{
+		auto l_a = simplex[count - 1];
+		auto l_ao = l_a.m_Point * -1.0f;
+
+		if (count == 2)
+		{
+			auto l_ab = simplex[0].m_Point - l_a.m_Point;
+			if (Dot3(l_ab, l_ao) > 0.0f)
+			{
+				direction = l_ab.cross(l_ao).cross(l_ab);
+				if (Dot3(direction, direction) < FLT_EPSILON)
+				{
+					direction = GetPerpendicular(l_ab);
+				}
+			}
+			else
+			{
+				simplex[0] = l_a;
+				count = 1;
+				direction = l_ao;
+			}
+			return false;
+		}
+
+		if (count == 3)
+		{
+			auto l_b = simplex[1];
+			auto l_c = simplex[0];
+			auto l_ab = l_b.m_Point - l_a.m_Point;
+			auto l_ac = l_c.m_Point - l_a.m_Point;
+			auto l_abc = l_ab.cross(l_ac);
+
+			if (Dot3(l_abc.cross(l_ac), l_ao) > 0.0f)
+			{
+				if (Dot3(l_ac, l_ao) > 0.0f)
+				{
+					simplex[0] = l_c;
+					simplex[1] = l_a;
+					count = 2;
+					direction = l_ac.cross(l_ao).cross(l_ac);
+					return false;
+				}
+				simplex[0] = l_b;
+				simplex[1] = l_a;
+				count = 2;
+				return UpdateSimplex(simplex, count, direction);
+			}
+
+			if (Dot3(l_ab.cross(l_abc), l_ao) > 0.0f)
+			{
+				simplex[0] = l_b;
+				simplex[1] = l_a;
+				count = 2;
+				return UpdateSimplex(simplex, count, direction);
+			}
+
+			if (Dot3(l_abc, l_ao) > 0.0f)
+			{
+				direction = l_abc;
+			}
+			else
+			{
+				// Keep the origin above the triangle for the tetrahedron case
+				simplex[0] = l_b;
+				simplex[1] = l_c;
+				direction = l_abc * -1.0f;
+			}
+			return false;
+		}
+
+		// The tetrahedron, only the faces sharing the newest point could have the origin outside
+		const uint32_t l_faces[3][3] = { { 2, 1, 0 }, { 1, 0, 2 }, { 0, 2, 1 } };
+		SupportPoint l_tetrahedron[4] = { simplex[0], simplex[1], simplex[2], l_a };
+
+		for (auto& i : l_faces)
+		{
+			auto& l_b = l_tetrahedron[i[0]];
+			auto& l_c = l_tetrahedron[i[1]];
+			auto& l_opposite = l_tetrahedron[i[2]];
+			auto l_normal = (l_b.m_Point - l_a.m_Point).cross(l_c.m_Point - l_a.m_Point);
+
+			if (Dot3(l_normal, l_opposite.m_Point - l_a.m_Point) > 0.0f)
+			{
+				l_normal = l_normal * -1.0f;
+			}
+			if (Dot3(l_normal, l_ao) > 0.0f)
+			{
+				simplex[0] = l_c;
+				simplex[1] = l_b;
+				simplex[2] = l_a;
+				count = 3;
+				return UpdateSimplex(simplex, count, direction);
+			}
+		}
+
+		return true;
+	}
+
+	bool GJK(const RigidBodyWorld& world, const RigidBody& bodyA, const RigidBody& bodyB, SupportPoint* simplex)
+	{
+		auto l_direction = bodyB.m_Position - bodyA.m_Position;
+		if (Dot3(l_direction, l_direction) < FLT_EPSILON)
+		{
+			l_direction = Vector(1.0f, 0.0f, 0.0f);
+		}
+
+		simplex[0] = GetMinkowskiSupport(world, bodyA, bodyB, l_direction);
+		uint32_t l_count = 1;
+		l_direction = simplex[0].m_Point * -1.0f;
+
+		for (uint32_t i = 0; i < m_MaxGJKIterationCount; i++)
+		{
+			if (Dot3(l_direction, l_direction) < FLT_EPSILON)
+			{
+				return false;
+			}
+
+			auto l_support = GetMinkowskiSupport(world, bodyA, bodyB, l_direction);
+			if (Dot3(l_support.m_Point, l_direction) <= 0.0f)
+			{
+				return false;
+			}
+
+			simplex[l_count++] = l_support;
+			if (UpdateSimplex(simplex, l_count, l_direction))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	struct EPAFace
+	{
+		uint32_t m_Indices[3];
+		Vec4 m_Normal;
+		float m_Distance;
+	};
+
+	bool MakeEPAFace(const SupportPoint* vertices, uint32_t a, uint32_t b, uint32_t c, EPAFace& face)
+	{
+		auto l_normal = (vertices[b].m_Point - vertices[a].m_Point).cross(vertices[c].m_Point - vertices[a].m_Point);
+		auto l_length = Length3(l_normal);
+
+		if (l_length < FLT_EPSILON)
+		{
+			return false;
+		}
+
+		face.m_Indices[0] = a;
+		face.m_Indices[1] = b;
+		face.m_Indices[2] = c;
+		face.m_Normal = l_normal * (1.0f / l_length);
+		face.m_Distance = Dot3(face.m_Normal, vertices[a].m_Point);
+
+		return true;
+	}
+
+	// Expand the GJK tetrahedron to the face of the Minkowski difference closest to the origin
+	bool EPA(const RigidBodyWorld& world, const RigidBody& bodyA, const RigidBody& bodyB, const SupportPoint* simplex, ContactResult& result)
+	{
+		SupportPoint l_vertices[m_MaxEPAVertexCount];
+		EPAFace l_faces[m_MaxEPAFaceCount];
+		uint32_t l_edges[m_MaxEPAFaceCount * 3][2];
+		uint32_t l_vertexCount = 4;
+		uint32_t l_faceCount = 0;
+
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			l_vertices[i] = simplex[i];
+		}
+
+		auto l_centroid = (l_vertices[0].m_Point + l_vertices[1].m_Point + l_vertices[2].m_Point + l_vertices[3].m_Point) * 0.25f;
+		const uint32_t l_tetrahedronFaces[4][3] = { { 0, 1, 2 }, { 0, 3, 1 }, { 0, 2, 3 }, { 1, 3, 2 } };
+
+		for (auto& i : l_tetrahedronFaces)
+		{
+			EPAFace l_face;
+			if (!MakeEPAFace(l_vertices, i[0], i[1], i[2], l_face))
+			{
+				return false;
+			}
+			if (Dot3(l_face.m_Normal, l_vertices[i[0]].m_Point - l_centroid) < 0.0f)
+			{
+				MakeEPAFace(l_vertices, i[0], i[2], i[1], l_face);
+			}
+			l_faces[l_faceCount++] = l_face;
+		}
+
+		uint32_t l_closestFace = 0;
+
+		for (uint32_t l_iteration = 0; l_iteration < m_MaxEPAIterationCount; l_iteration++)
+		{
+			l_closestFace = 0;
+			for (uint32_t i = 1; i < l_faceCount; i++)
+			{
+				if (l_faces[i].m_Distance < l_faces[l_closestFace].m_Distance)
+				{
+					l_closestFace = i;
+				}
+			}
+
+			auto l_face = l_faces[l_closestFace];
+			auto l_support = GetMinkowskiSupport(world, bodyA, bodyB, l_face.m_Normal);
+
+			if (Dot3(l_support.m_Point, l_face.m_Normal) - l_face.m_Distance < m_EPATolerance || l_vertexCount == m_MaxEPAVertexCount)
+			{
+				break;
+			}
+
+			// Remove the faces visible from the new point and keep their boundary edges
+			uint32_t l_edgeCount = 0;
+			uint32_t l_remainingFaceCount = 0;
+
+			for (uint32_t i = 0; i < l_faceCount; i++)
+			{
+				auto& l_currentFace = l_faces[i];
+				if (Dot3(l_currentFace.m_Normal, l_support.m_Point - l_vertices[l_currentFace.m_Indices[0]].m_Point) > 0.0f)
+				{
+					for (uint32_t j = 0; j < 3; j++)
+					{
+						auto l_edgeBegin = l_currentFace.m_Indices[j];
+						auto l_edgeEnd = l_currentFace.m_Indices[(j + 1) % 3];
+						auto l_isShared = false;
+
+						// An edge shared by two removed faces is inside of the hole
+						for (uint32_t k = 0; k < l_edgeCount; k++)
+						{
+							if (l_edges[k][0] == l_edgeEnd && l_edges[k][1] == l_edgeBegin)
+							{
+								l_edges[k][0] = l_edges[l_edgeCount - 1][0];
+								l_edges[k][1] = l_edges[l_edgeCount - 1][1];
+								l_edgeCount--;
+								l_isShared = true;
+								break;
+							}
+						}
+						if (!l_isShared)
+						{
+							l_edges[l_edgeCount][0] = l_edgeBegin;
+							l_edges[l_edgeCount][1] = l_edgeEnd;
+							l_edgeCount++;
+						}
+					}
+				}
+				else
+				{
+					l_faces[l_remainingFaceCount++] = l_currentFace;
+				}
+			}
+
+			l_faceCount = l_remainingFaceCount;
+
+			if (l_faceCount + l_edgeCount > m_MaxEPAFaceCount)
+			{
+				return false;
+			}
+
+			l_vertices[l_vertexCount] = l_support;
+			for (uint32_t i = 0; i < l_edgeCount; i++)
+			{
+				EPAFace l_newFace;
+				if (MakeEPAFace(l_vertices, l_edges[i][0], l_edges[i][1], l_vertexCount, l_newFace))
+				{
+					l_faces[l_faceCount++] = l_newFace;
+				}
+			}
+			l_vertexCount++;
+
+			if (l_faceCount == 0)
+			{
+				return false;
+			}
+		}
+
+		auto& l_face = l_faces[l_closestFace];
+		auto& l_a = l_vertices[l_face.m_Indices[0]];
+		auto& l_b = l_vertices[l_face.m_Indices[1]];
+		auto& l_c = l_vertices[l_face.m_Indices[2]];
+
+		// The barycentric coordinates of the origin projected onto the face
+		auto l_point = l_face.m_Normal * l_face.m_Distance;
+		auto l_v0 = l_b.m_Point - l_a.m_Point;
+		auto l_v1 = l_c.m_Point - l_a.m_Point;
+		auto l_v2 = l_point - l_a.m_Point;
+		auto d00 = Dot3(l_v0, l_v0);
+		auto d01 = Dot3(l_v0, l_v1);
+		auto d11 = Dot3(l_v1, l_v1);
+		auto d20 = Dot3(l_v2, l_v0);
+		auto d21 = Dot3(l_v2, l_v1);
+		auto l_denominator = d00 * d11 - d01 * d01;
+
+		if (std::abs(l_denominator) < FLT_EPSILON)
+		{
+			return false;
+		}
+
+		auto v = (d11 * d20 - d01 * d21) / l_denominator;
+		auto w = (d00 * d21 - d01 * d20) / l_denominator;
+		auto u = 1.0f - v - w;
+
+		auto l_pointA = l_a.m_SupportA * u + l_b.m_SupportA * v + l_c.m_SupportA * w;
+		auto l_pointB = l_a.m_SupportB * u + l_b.m_SupportB * v + l_c.m_SupportB * w;
+
+		result.m_Normal = l_face.m_Normal;
+		AddContactPoint(result, (l_pointA + l_pointB) * 0.5f, l_face.m_Distance);
+
+		return true;
+	}
+
+	bool CollideConvex(const RigidBodyWorld& world, const RigidBody& bodyA, const RigidBody& bodyB, ContactResult& result)
+	{
+		SupportPoint l_simplex[4];
+
+		if (!GJK(world, bodyA, bodyB, l_simplex))
+		{
+			return false;
+		}
+
+		return EPA(world, bodyA, bodyB, l_simplex, result);
+	}
+
+	bool Collide(const RigidBodyWorld& world, const RigidBody& bodyA, const RigidBody& bodyB, ContactResult& result)
+	{
+		auto l_shapeA = bodyA.m_ShapeType;
+		auto l_shapeB = bodyB.m_ShapeType;
+
+		if (l_shapeA == RigidBodyShapeType::Sphere && l_shapeB == RigidBodyShapeType::Sphere)
+		{
+			return CollideSpheres(bodyA, bodyB, result);
+		}
+		if (l_shapeA == RigidBodyShapeType::Box && l_shapeB == RigidBodyShapeType::Box)
+		{
+			return CollideBoxes(bodyA, bodyB, result);
+		}
+		if (l_shapeA == RigidBodyShapeType::Box && l_shapeB == RigidBodyShapeType::Sphere)
+		{
+			return CollideBoxSphere(bodyA, bodyB, result);
+		}
+		if (l_shapeA == RigidBodyShapeType::Sphere && l_shapeB == RigidBodyShapeType::Box)
+		{
+			auto l_result = CollideBoxSphere(bodyB, bodyA, result);
+			result.m_Normal = result.m_Normal * -1.0f;
+			return l_result;
+		}
+
+		return CollideConvex(world, bodyA, bodyB, result);
+	}
+
+	// Keep the deepest point, the farthest one from it, then the two spanning the largest area on both sides
+	uint32_t ReduceContactPoints(const Vec4& normal, Vec4* positions, float* depths, uint32_t count)
+	{
+		if (count <= 4)
+		{
+			return count;
+		}
+
+		uint32_t l_selected[4] = { 0, 0, 0, 0 };
+
+		for (uint32_t i = 1; i < count; i++)
+		{
+			if (depths[i] > depths[l_selected[0]])
+			{
+				l_selected[0] = i;
+			}
+		}
+
+		auto l_maxDistance = -1.0f;
+		for (uint32_t i = 0; i < count; i++)
+		{
+			auto l_delta = positions[i] - positions[l_selected[0]];
+			auto l_distance = Dot3(l_delta, l_delta);
+			if (l_distance > l_maxDistance)
+			{
+				l_maxDistance = l_distance;
+				l_selected[1] = i;
+			}
+		}
+
+		auto l_maxArea = -FLT_MAX;
+		auto l_minArea = FLT_MAX;
+		auto l_edge = positions[l_selected[1]] - positions[l_selected[0]];
+		for (uint32_t i = 0; i < count; i++)
+		{
+			auto l_area = Dot3(l_edge.cross(positions[i] - positions[l_selected[0]]), normal);
+			if (l_area > l_maxArea)
+			{
+				l_maxArea = l_area;
+				l_selected[2] = i;
+			}
+			if (l_area < l_minArea)
+			{
+				l_minArea = l_area;
+				l_selected[3] = i;
+			}
+		}
+
+		Vec4 l_positions[4];
+		float l_depths[4];
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			l_positions[i] = positions[l_selected[i]];
+			l_depths[i] = depths[l_selected[i]];
+		}
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			positions[i] = l_positions[i];
+			depths[i] = l_depths[i];
+		}
+
+		return 4;
+	}
+
+	bool GenerateManifold(const RigidBodyWorld& world, uint32_t bodyIndexA, uint32_t bodyIndexB, RigidBodyContactManifold& manifold)
+	{
+		auto& l_bodyA = world.m_Bodies[bodyIndexA];
+		auto& l_bodyB = world.m_Bodies[bodyIndexB];
+
+		manifold.m_BodyA = bodyIndexA;
+		manifold.m_BodyB = bodyIndexB;
+		manifold.m_PointCount = 0;
+
+		ContactResult l_contact;
+		if (!Collide(world, l_bodyA, l_bodyB, l_contact))
+		{
+			return false;
+		}
+
+		auto l_previousManifold = world.m_ManifoldMap.find(GetPairKey(bodyIndexA, bodyIndexB));
+		auto l_hasPreviousManifold = l_previousManifold != world.m_ManifoldMap.end();
+
+		// The GJK pairs only produce one point per step, so the still touching points of the previous step are kept to build a stable manifold
+		auto l_isPersistent = l_contact.m_PointCount == 1 && l_hasPreviousManifold && (l_bodyA.m_ShapeType == RigidBodyShapeType::Convex || l_bodyB.m_ShapeType == RigidBodyShapeType::Convex);
+		if (l_isPersistent)
+		{
+			auto& l_previous = world.m_Manifolds[l_previousManifold->second];
+			for (uint32_t i = 0; i < l_previous.m_PointCount; i++)
+			{
+				auto& l_point = l_previous.m_Points[i];
+				auto l_pointA = l_bodyA.m_Position + Rotate(l_bodyA, l_point.m_LocalPositionA);
+				auto l_pointB = l_bodyB.m_Position + Rotate(l_bodyB, l_point.m_LocalPositionB);
+				auto l_delta = l_pointA - l_pointB;
+				auto l_depth = Dot3(l_delta, l_contact.m_Normal);
+				auto l_drift = l_delta - l_contact.m_Normal * l_depth;
+				auto l_newDelta = (l_pointA + l_pointB) * 0.5f - l_contact.m_Positions[0];
+
+				if (l_depth > -m_LinearSlop && Dot3(l_drift, l_drift) < m_ContactMatchDistance * m_ContactMatchDistance && Dot3(l_newDelta, l_newDelta) > m_ContactMatchDistance * m_ContactMatchDistance)
+				{
+					AddContactPoint(l_contact, (l_pointA + l_pointB) * 0.5f, l_depth);
+				}
+			}
+		}
+
+		manifold.m_Normal = l_contact.m_Normal;
+		manifold.m_PointCount = ReduceContactPoints(l_contact.m_Normal, l_contact.m_Positions, l_contact.m_Depths, l_contact.m_PointCount);
+
+		for (uint32_t i = 0; i < manifold.m_PointCount; i++)
+		{
+			auto& l_point = manifold.m_Points[i];
+			l_point = RigidBodyContactPoint();
+			l_point.m_Position = l_contact.m_Positions[i];
+			l_point.m_Depth = l_contact.m_Depths[i];
+			l_point.m_LocalPositionA = InverseRotate(l_bodyA, l_point.m_Position - l_bodyA.m_Position);
+			l_point.m_LocalPositionB = InverseRotate(l_bodyB, l_point.m_Position - l_bodyB.m_Position);
+		}
+
+		// Warm start from the matching points of the previous step
+		if (l_hasPreviousManifold)
+		{
+			auto& l_previous = world.m_Manifolds[l_previousManifold->second];
+			for (uint32_t i = 0; i < manifold.m_PointCount; i++)
+			{
+				auto& l_point = manifold.m_Points[i];
+				for (uint32_t j = 0; j < l_previous.m_PointCount; j++)
+				{
+					auto l_delta = l_point.m_LocalPositionA - l_previous.m_Points[j].m_LocalPositionA;
+					if (Dot3(l_delta, l_delta) < m_ContactMatchDistance * m_ContactMatchDistance)
+					{
+						l_point.m_NormalImpulse = l_previous.m_Points[j].m_NormalImpulse;
+						l_point.m_TangentImpulse[0] = l_previous.m_Points[j].m_TangentImpulse[0];
+						l_point.m_TangentImpulse[1] = l_previous.m_Points[j].m_TangentImpulse[1];
+						break;
+					}
+				}
+			}
+
+			// The tangent impulses are only meaningful in the same tangent basis
+			manifold.m_Tangents[0] = l_previous.m_Tangents[0] - manifold.m_Normal * Dot3(l_previous.m_Tangents[0], manifold.m_Normal);
+			auto l_length = Length3(manifold.m_Tangents[0]);
+			if (l_length > 1e-3f)
+			{
+				manifold.m_Tangents[0] = manifold.m_Tangents[0] * (1.0f / l_length);
+			}
+			else
+			{
+				manifold.m_Tangents[0] = GetPerpendicular(manifold.m_Normal).normalize();
+			}
+		}
+		else
+		{
+			manifold.m_Tangents[0] = GetPerpendicular(manifold.m_Normal).normalize();
+		}
+		manifold.m_Tangents[1] = manifold.m_Normal.cross(manifold.m_Tangents[0]);
+
+		manifold.m_Friction = std::sqrt(l_bodyA.m_Friction * l_bodyB.m_Friction);
+		manifold.m_Restitution = std::max(l_bodyA.m_Restitution, l_bodyB.m_Restitution);
+
+		return manifold.m_PointCount > 0;
+	}
+
+	void UpdateBroadphase(RigidBodyWorld& world)
+	{
+		auto& l_bodies = world.m_Bodies;
+		auto& l_sorted = world.m_SortedBodyIndices;
+
+		if (l_sorted.size() != l_bodies.size())
+		{
+			l_sorted.resize(l_bodies.size());
+			for (uint32_t i = 0; i < l_sorted.size(); i++)
+			{
+				l_sorted[i] = i;
+			}
+		}
+
+		// The order of the previous step is almost sorted, so the insertion sort is close to linear
+		for (size_t i = 1; i < l_sorted.size(); i++)
+		{
+			auto l_index = l_sorted[i];
+			auto l_key = l_bodies[l_index].m_AABBWS.m_boundMin.x;
+			auto j = i;
+			while (j > 0 && l_bodies[l_sorted[j - 1]].m_AABBWS.m_boundMin.x > l_key)
+			{
+				l_sorted[j] = l_sorted[j - 1];
+				j--;
+			}
+			l_sorted[j] = l_index;
+		}
+
+		world.m_Pairs.clear();
+
+		for (size_t i = 0; i < l_sorted.size(); i++)
+		{
+			auto& l_bodyA = l_bodies[l_sorted[i]];
+
+			for (size_t j = i + 1; j < l_sorted.size(); j++)
+			{
+				auto& l_bodyB = l_bodies[l_sorted[j]];
+				if (l_bodyB.m_AABBWS.m_boundMin.x > l_bodyA.m_AABBWS.m_boundMax.x)
+				{
+					break;
+				}
+				if (l_bodyA.m_InvMass == 0.0f && l_bodyB.m_InvMass == 0.0f)
+				{
+					continue;
+				}
+				if (l_bodyA.m_AABBWS.m_boundMin.y > l_bodyB.m_AABBWS.m_boundMax.y || l_bodyB.m_AABBWS.m_boundMin.y > l_bodyA.m_AABBWS.m_boundMax.y
+					|| l_bodyA.m_AABBWS.m_boundMin.z > l_bodyB.m_AABBWS.m_boundMax.z || l_bodyB.m_AABBWS.m_boundMin.z > l_bodyA.m_AABBWS.m_boundMax.z)
+				{
+					continue;
+				}
+
+				world.m_Pairs.emplace_back(std::min(l_sorted[i], l_sorted[j]), std::max(l_sorted[i], l_sorted[j]));
+			}
+		}
+	}
+
+	void UpdateNarrowphase(RigidBodyWorld& world)
+	{
+		auto l_pairCount = world.m_Pairs.size();
+		world.m_PairManifolds.resize(l_pairCount);
+
+		InnoTaskScheduler::ParallelFor("RigidBodyNarrowphaseTask", l_pairCount, m_ParallelGrainSize, [&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				GenerateManifold(world, world.m_Pairs[i].first, world.m_Pairs[i].second, world.m_PairManifolds[i]);
+			}
+		});
+
+		world.m_Manifolds.clear();
+		world.m_ManifoldMap.clear();
+
+		for (auto& i : world.m_PairManifolds)
+		{
+			if (i.m_PointCount)
+			{
+				world.m_ManifoldMap.emplace(GetPairKey(i.m_BodyA, i.m_BodyB), (uint32_t)world.m_Manifolds.size());
+				world.m_Manifolds.emplace_back(i);
+			}
+		}
+	}
+
+	uint32_t FindIslandRoot(std::vector<uint32_t>& parents, uint32_t index)
+	{
+		while (parents[index] != index)
+		{
+			parents[index] = parents[parents[index]];
+			index = parents[index];
+		}
+		return index;
+	}
+
+	// The dynamic bodies connected by the contacts form an island, the static bodies are only read by the solver so they don't join the islands
+	void UpdateIslands(RigidBodyWorld& world)
+	{
+		auto& l_bodies = world.m_Bodies;
+		auto& l_parents = world.m_IslandParents;
+
+		l_parents.resize(l_bodies.size());
+		for (uint32_t i = 0; i < l_parents.size(); i++)
+		{
+			l_parents[i] = i;
+		}
+
+		for (auto& i : world.m_Manifolds)
+		{
+			if (l_bodies[i.m_BodyA].m_InvMass > 0.0f && l_bodies[i.m_BodyB].m_InvMass > 0.0f)
+			{
+				auto l_rootA = FindIslandRoot(l_parents, i.m_BodyA);
+				auto l_rootB = FindIslandRoot(l_parents, i.m_BodyB);
+				l_parents[std::max(l_rootA, l_rootB)] = std::min(l_rootA, l_rootB);
+			}
+		}
+
+		// Number the islands in the body order, so the result is deterministic
+		const auto l_invalidIsland = std::numeric_limits<uint32_t>::max();
+		for (auto& i : l_bodies)
+		{
+			i.m_IslandIndex = l_invalidIsland;
+		}
+
+		uint32_t l_islandCount = 0;
+		for (uint32_t i = 0; i < l_bodies.size(); i++)
+		{
+			if (l_bodies[i].m_InvMass > 0.0f)
+			{
+				auto& l_root = l_bodies[FindIslandRoot(l_parents, i)];
+				if (l_root.m_IslandIndex == l_invalidIsland)
+				{
+					l_root.m_IslandIndex = l_islandCount++;
+				}
+				l_bodies[i].m_IslandIndex = l_root.m_IslandIndex;
+			}
+		}
+
+		// Counting sort of the manifolds by their islands
+		world.m_IslandManifoldOffsets.assign(l_islandCount + 1, 0);
+		for (auto& i : world.m_Manifolds)
+		{
+			auto l_dynamicBody = l_bodies[i.m_BodyA].m_InvMass > 0.0f ? i.m_BodyA : i.m_BodyB;
+			world.m_IslandManifoldOffsets[l_bodies[l_dynamicBody].m_IslandIndex + 1]++;
+		}
+		for (uint32_t i = 0; i < l_islandCount; i++)
+		{
+			world.m_IslandManifoldOffsets[i + 1] += world.m_IslandManifoldOffsets[i];
+		}
+
+		world.m_IslandManifoldIndices.resize(world.m_Manifolds.size());
+		auto l_cursors = world.m_IslandManifoldOffsets;
+		for (uint32_t i = 0; i < world.m_Manifolds.size(); i++)
+		{
+			auto& l_manifold = world.m_Manifolds[i];
+			auto l_dynamicBody = l_bodies[l_manifold.m_BodyA].m_InvMass > 0.0f ? l_manifold.m_BodyA : l_manifold.m_BodyB;
+			world.m_IslandManifoldIndices[l_cursors[l_bodies[l_dynamicBody].m_IslandIndex]++] = i;
+		}
+	}
+
+	// The static bodies are shared by the islands, so they are never written
+	inline void ApplyImpulse(RigidBody& bodyA, RigidBody& bodyB, const Vec4& rA, const Vec4& rB, const Vec4& impulse)
+	{
+		if (bodyA.m_InvMass > 0.0f)
+		{
+			bodyA.m_LinearVelocity = bodyA.m_LinearVelocity - impulse * bodyA.m_InvMass;
+			bodyA.m_AngularVelocity = bodyA.m_AngularVelocity - ApplyInvInertia(bodyA, rA.cross(impulse));
+		}
+		if (bodyB.m_InvMass > 0.0f)
+		{
+			bodyB.m_LinearVelocity = bodyB.m_LinearVelocity + impulse * bodyB.m_InvMass;
+			bodyB.m_AngularVelocity = bodyB.m_AngularVelocity + ApplyInvInertia(bodyB, rB.cross(impulse));
+		}
+	}
+
+	inline Vec4 GetRelativeVelocity(const RigidBody& bodyA, const RigidBody& bodyB, const Vec4& rA, const Vec4& rB)
+	{
+		return bodyB.m_LinearVelocity + bodyB.m_AngularVelocity.cross(rB) - bodyA.m_LinearVelocity - bodyA.m_AngularVelocity.cross(rA);
+	}
+
+	inline float GetEffectiveMass(const RigidBody& bodyA, const RigidBody& bodyB, const Vec4& rA, const Vec4& rB, const Vec4& direction)
+	{
+		auto l_rnA = rA.cross(direction);
+		auto l_rnB = rB.cross(direction);
+		auto l_k = bodyA.m_InvMass + bodyB.m_InvMass + Dot3(ApplyInvInertia(bodyA, l_rnA), l_rnA) + Dot3(ApplyInvInertia(bodyB, l_rnB), l_rnB);
+
+		return l_k > 0.0f ? 1.0f / l_k : 0.0f;
+	}
+
+	void SolveIsland(RigidBodyWorld& world, uint32_t islandIndex, float deltaTime)
+	{
+		auto& l_bodies = world.m_Bodies;
+		auto l_begin = world.m_IslandManifoldOffsets[islandIndex];
+		auto l_end = world.m_IslandManifoldOffsets[islandIndex + 1];
+
+		for (auto i = l_begin; i < l_end; i++)
+		{
+			auto& l_manifold = world.m_Manifolds[world.m_IslandManifoldIndices[i]];
+			auto& l_bodyA = l_bodies[l_manifold.m_BodyA];
+			auto& l_bodyB = l_bodies[l_manifold.m_BodyB];
+
+			for (uint32_t j = 0; j < l_manifold.m_PointCount; j++)
+			{
+				auto& l_point = l_manifold.m_Points[j];
+				l_point.m_RA = l_point.m_Position - l_bodyA.m_Position;
+				l_point.m_RB = l_point.m_Position - l_bodyB.m_Position;
+				l_point.m_NormalMass = GetEffectiveMass(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB, l_manifold.m_Normal);
+				l_point.m_TangentMass[0] = GetEffectiveMass(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB, l_manifold.m_Tangents[0]);
+				l_point.m_TangentMass[1] = GetEffectiveMass(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB, l_manifold.m_Tangents[1]);
+
+				// A separated point only stops the bodies from closing more than the gap in this step (speculative contact)
+				// Otherwise the Baumgarte stabilization resolves the penetration beyond the slop, and the restitution works for the fast approaching contacts
+				if (l_point.m_Depth < 0.0f)
+				{
+					l_point.m_VelocityBias = l_point.m_Depth / deltaTime;
+				}
+				else
+				{
+					l_point.m_VelocityBias = m_BaumgarteFactor / deltaTime * std::max(l_point.m_Depth - m_LinearSlop, 0.0f);
+				}
+				auto l_normalVelocity = Dot3(GetRelativeVelocity(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB), l_manifold.m_Normal);
+				if (l_normalVelocity < -m_RestitutionThreshold)
+				{
+					l_point.m_VelocityBias = std::max(l_point.m_VelocityBias, -l_manifold.m_Restitution * l_normalVelocity);
+				}
+
+				auto l_impulse = l_manifold.m_Normal * l_point.m_NormalImpulse + l_manifold.m_Tangents[0] * l_point.m_TangentImpulse[0] + l_manifold.m_Tangents[1] * l_point.m_TangentImpulse[1];
+				ApplyImpulse(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB, l_impulse);
+			}
+		}
+
+		for (uint32_t l_iteration = 0; l_iteration < world.m_SolverIterationCount; l_iteration++)
+		{
+			for (auto i = l_begin; i < l_end; i++)
+			{
+				auto& l_manifold = world.m_Manifolds[world.m_IslandManifoldIndices[i]];
+				auto& l_bodyA = l_bodies[l_manifold.m_BodyA];
+				auto& l_bodyB = l_bodies[l_manifold.m_BodyB];
+
+				for (uint32_t j = 0; j < l_manifold.m_PointCount; j++)
+				{
+					auto& l_point = l_manifold.m_Points[j];
+
+					// Friction first, clamped by the normal impulse of the last iteration
+					auto l_maxFriction = l_manifold.m_Friction * l_point.m_NormalImpulse;
+					for (uint32_t k = 0; k < 2; k++)
+					{
+						auto l_tangentVelocity = Dot3(GetRelativeVelocity(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB), l_manifold.m_Tangents[k]);
+						auto l_oldImpulse = l_point.m_TangentImpulse[k];
+						l_point.m_TangentImpulse[k] = std::max(-l_maxFriction, std::min(l_oldImpulse - l_point.m_TangentMass[k] * l_tangentVelocity, l_maxFriction));
+						ApplyImpulse(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB, l_manifold.m_Tangents[k] * (l_point.m_TangentImpulse[k] - l_oldImpulse));
+					}
+
+					auto l_normalVelocity = Dot3(GetRelativeVelocity(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB), l_manifold.m_Normal);
+					auto l_oldImpulse = l_point.m_NormalImpulse;
+					l_point.m_NormalImpulse = std::max(l_oldImpulse + l_point.m_NormalMass * (l_point.m_VelocityBias - l_normalVelocity), 0.0f);
+					ApplyImpulse(l_bodyA, l_bodyB, l_point.m_RA, l_point.m_RB, l_manifold.m_Normal * (l_point.m_NormalImpulse - l_oldImpulse));
+				}
+			}
+		}
+	}
+
+	// An awake body touching a sleeping island wakes the whole island up
+	void WakeUpIslands(RigidBodyWorld& world)
+	{
+		auto l_islandCount = world.m_IslandManifoldOffsets.size() - 1;
+		world.m_IslandAwakes.assign(l_islandCount, 0);
+
+		for (auto& i : world.m_Bodies)
+		{
+			if (i.m_InvMass > 0.0f && !i.m_Sleeping)
+			{
+				world.m_IslandAwakes[i.m_IslandIndex] = 1;
+			}
+		}
+
+		for (auto& i : world.m_Bodies)
+		{
+			if (i.m_InvMass > 0.0f && world.m_IslandAwakes[i.m_IslandIndex])
+			{
+				i.m_Sleeping = false;
+			}
+		}
+	}
+
+	void UpdateSleeping(RigidBodyWorld& world, float deltaTime)
+	{
+		world.m_IslandStillTimes.assign(world.m_IslandAwakes.size(), FLT_MAX);
+
+		for (auto& i : world.m_Bodies)
+		{
+			if (i.m_InvMass == 0.0f || i.m_Sleeping)
+			{
+				continue;
+			}
+
+			if (Dot3(i.m_LinearVelocity, i.m_LinearVelocity) > m_SleepLinearVelocity * m_SleepLinearVelocity || Dot3(i.m_AngularVelocity, i.m_AngularVelocity) > m_SleepAngularVelocity * m_SleepAngularVelocity)
+			{
+				i.m_StillTime = 0.0f;
+			}
+			else
+			{
+				i.m_StillTime += deltaTime;
+			}
+
+			world.m_IslandStillTimes[i.m_IslandIndex] = std::min(world.m_IslandStillTimes[i.m_IslandIndex], i.m_StillTime);
+		}
+
+		for (auto& i : world.m_Bodies)
+		{
+			if (i.m_InvMass > 0.0f && !i.m_Sleeping && world.m_IslandStillTimes[i.m_IslandIndex] >= m_TimeToSleep)
+			{
+				i.m_Sleeping = true;
+				i.m_StillTime = 0.0f;
+				i.m_LinearVelocity = Vec4();
+				i.m_AngularVelocity = Vec4();
+			}
+		}
+	}
+
+	void IntegrateVelocities(RigidBodyWorld& world, float deltaTime)
+	{
+		auto l_linearDamping = 1.0f / (1.0f + deltaTime * m_LinearDamping);
+		auto l_angularDamping = 1.0f / (1.0f + deltaTime * m_AngularDamping);
+
+		InnoTaskScheduler::ParallelFor("RigidBodyVelocityTask", world.m_Bodies.size(), m_ParallelGrainSize * 4, [&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				auto& l_body = world.m_Bodies[i];
+				if (l_body.m_InvMass > 0.0f && !l_body.m_Sleeping)
+				{
+					l_body.m_LinearVelocity = (l_body.m_LinearVelocity + world.m_Gravity * deltaTime) * l_linearDamping;
+					l_body.m_AngularVelocity = l_body.m_AngularVelocity * l_angularDamping;
+				}
+			}
+		});
+	}
+
+	void IntegratePositions(RigidBodyWorld& world, float deltaTime)
+	{
+		InnoTaskScheduler::ParallelFor("RigidBodyPositionTask", world.m_Bodies.size(), m_ParallelGrainSize * 4, [&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				auto& l_body = world.m_Bodies[i];
+				if (l_body.m_InvMass == 0.0f || l_body.m_Sleeping)
+				{
+					continue;
+				}
+
+				l_body.m_Position = l_body.m_Position + l_body.m_LinearVelocity * deltaTime;
+
+				// dq/dt = 0.5 * (w, 0) * q
+				auto& q = l_body.m_Rotation;
+				auto w = l_body.m_AngularVelocity * (0.5f * deltaTime);
+				q = Vec4(
+					q.x + w.x * q.w + w.y * q.z - w.z * q.y,
+					q.y - w.x * q.z + w.y * q.w + w.z * q.x,
+					q.z + w.x * q.y - w.y * q.x + w.z * q.w,
+					q.w - w.x * q.x - w.y * q.y - w.z * q.z).normalize();
+
+				UpdateAxes(l_body);
+				UpdateAABB(world, l_body);
+			}
+		});
+	}
+
+	// Keep the extreme vertices along the directions evenly distributed on a Fibonacci sphere, which drops the interior and the duplicated vertices too
+	std::vector<Vec4> ReduceConvexVertices(const std::vector<Vec4>& vertices)
+	{
+		const float l_goldenAngle = PI<float> * (3.0f - std::sqrt(5.0f));
+
+		std::vector<size_t> l_indices;
+		l_indices.reserve(m_ConvexSupportDirectionCount);
+
+		for (size_t i = 0; i < m_ConvexSupportDirectionCount; i++)
+		{
+			auto l_y = 1.0f - 2.0f * ((float)i + 0.5f) / (float)m_ConvexSupportDirectionCount;
+			auto l_radius = std::sqrt(1.0f - l_y * l_y);
+			auto l_theta = l_goldenAngle * (float)i;
+			auto l_direction = Vector(std::cos(l_theta) * l_radius, l_y, std::sin(l_theta) * l_radius);
+
+			size_t l_bestIndex = 0;
+			auto l_bestDot = Dot3(vertices[0], l_direction);
+			for (size_t j = 1; j < vertices.size(); j++)
+			{
+				auto l_dot = Dot3(vertices[j], l_direction);
+				if (l_dot > l_bestDot)
+				{
+					l_bestDot = l_dot;
+					l_bestIndex = j;
+				}
+			}
+			l_indices.emplace_back(l_bestIndex);
+		}
+
+		std::sort(l_indices.begin(), l_indices.end());
+		l_indices.erase(std::unique(l_indices.begin(), l_indices.end()), l_indices.end());
+
+		std::vector<Vec4> l_result;
+		l_result.reserve(l_indices.size());
+		for (auto i : l_indices)
+		{
+			l_result.emplace_back(vertices[i]);
+		}
+
+		return l_result;
+	}
+}
+
+using namespace InnoRigidBodyDynamicsNS;
+
+uint32_t InnoRigidBodyDynamics::AddRigidBody(RigidBodyWorld& world, const RigidBodyDesc& desc)
+{
+	RigidBody l_body;
+
+	l_body.m_ShapeType = desc.m_ShapeType;
+	l_body.m_Position = desc.m_Position;
+	l_body.m_Position.w = 1.0f;
+	l_body.m_Rotation = desc.m_Rotation.normalize();
+	l_body.m_HalfExtents = Vector(desc.m_HalfExtents.x, desc.m_HalfExtents.y, desc.m_HalfExtents.z);
+	l_body.m_Radius = desc.m_Radius;
+	l_body.m_Friction = desc.m_Friction;
+	l_body.m_Restitution = desc.m_Restitution;
+	l_body.m_UserData = desc.m_UserData;
+
+	if (desc.m_ShapeType == RigidBodyShapeType::Convex)
+	{
+		if (desc.m_ConvexVertices.empty())
+		{
+			InnoLogger::Log(LogLevel::Error, "InnoRigidBodyDynamics: Convex shape has no vertex!");
+			l_body.m_ShapeType = RigidBodyShapeType::Sphere;
+		}
+		else
+		{
+			l_body.m_ConvexShapeIndex = (uint32_t)world.m_ConvexShapes.size();
+			world.m_ConvexShapes.emplace_back(ReduceConvexVertices(desc.m_ConvexVertices));
+
+			// The inertia of the convex shape is approximated by its bounding box
+			auto l_boundMax = InnoMath::minVec4<float>;
+			auto l_boundMin = InnoMath::maxVec4<float>;
+			for (auto& i : world.m_ConvexShapes[l_body.m_ConvexShapeIndex])
+			{
+				l_boundMax = InnoMath::elementWiseMax(i, l_boundMax);
+				l_boundMin = InnoMath::elementWiseMin(i, l_boundMin);
+			}
+			l_body.m_HalfExtents = (l_boundMax - l_boundMin) * 0.5f;
+			l_body.m_HalfExtents.w = 0.0f;
+		}
+	}
+
+	if (desc.m_Mass > 0.0f)
+	{
+		l_body.m_InvMass = 1.0f / desc.m_Mass;
+
+		if (l_body.m_ShapeType == RigidBodyShapeType::Sphere)
+		{
+			auto l_inertia = 0.4f * desc.m_Mass * l_body.m_Radius * l_body.m_Radius;
+			l_body.m_InvInertiaLS = Vector(1.0f / l_inertia, 1.0f / l_inertia, 1.0f / l_inertia);
+		}
+		else
+		{
+			auto& h = l_body.m_HalfExtents;
+			auto l_factor = desc.m_Mass / 3.0f;
+			l_body.m_InvInertiaLS = Vector(1.0f / (l_factor * (h.y * h.y + h.z * h.z)), 1.0f / (l_factor * (h.x * h.x + h.z * h.z)), 1.0f / (l_factor * (h.x * h.x + h.y * h.y)));
+		}
+	}
+
+	UpdateAxes(l_body);
+	UpdateAABB(world, l_body);
+
+	world.m_Bodies.emplace_back(l_body);
+
+	return (uint32_t)(world.m_Bodies.size() - 1);
+}
+
+void InnoRigidBodyDynamics::Clear(RigidBodyWorld& world)
+{
+	world.m_Bodies.clear();
+	world.m_ConvexShapes.clear();
+	world.m_SortedBodyIndices.clear();
+	world.m_Pairs.clear();
+	world.m_PairManifolds.clear();
+	world.m_Manifolds.clear();
+	world.m_ManifoldMap.clear();
+	world.m_IslandManifoldOffsets.clear();
+	world.m_IslandManifoldIndices.clear();
+	world.m_IslandAwakes.clear();
+	world.m_IslandStillTimes.clear();
+}
+
+void InnoRigidBodyDynamics::Step(RigidBodyWorld& world, float deltaTime)
+{
+	if (deltaTime <= 0.0f)
+	{
+		return;
+	}
+
+	IntegrateVelocities(world, deltaTime);
+	UpdateBroadphase(world);
+	UpdateNarrowphase(world);
+	UpdateIslands(world);
+	WakeUpIslands(world);
+
+	// Every island only writes its own dynamic bodies and manifolds, the sleeping islands keep their warm starting impulses
+	auto l_islandCount = GetIslandCount(world);
+	InnoTaskScheduler::ParallelFor("RigidBodySolverTask", l_islandCount, 1, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			if (world.m_IslandAwakes[i])
+			{
+				SolveIsland(world, (uint32_t)i, deltaTime);
+			}
+		}
+	});
+
+	UpdateSleeping(world, deltaTime);
+	IntegratePositions(world, deltaTime);
+}
+
+size_t InnoRigidBodyDynamics::GetIslandCount(const RigidBodyWorld& world)
+{
+	return world.m_IslandManifoldOffsets.empty() ? 0 : world.m_IslandManifoldOffsets.size() - 1;
+}
+
+size_t InnoRigidBodyDynamics::GetContactPointCount(const RigidBodyWorld& world)
+{
+	size_t l_result = 0;
+
+	for (auto& i : world.m_Manifolds)
+	{
+		l_result += i.m_PointCount;
+	}
+
+	return l_result;
+}
+
+size_t InnoRigidBodyDynamics::GetSleepingBodyCount(const RigidBodyWorld& world)
+{
+	size_t l_result = 0;
+
+	for (auto& i : world.m_Bodies)
+	{
+		l_result += i.m_Sleeping ? 1 : 0;
+	}
+
+	return l_result;
+}
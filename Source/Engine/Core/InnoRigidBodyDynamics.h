@@ -0,0 +1,116 @@
+#pragma once
+#include "../Common/InnoMathHelper.h"
+
+enum class RigidBodyShapeType { Sphere, Box, Convex };
+
+struct RigidBodyDesc
+{
+	RigidBodyShapeType m_ShapeType = RigidBodyShapeType::Box;
+	Vec4 m_Position = Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	Vec4 m_Rotation = Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	// Used by the box shape
+	Vec4 m_HalfExtents = Vec4(0.5f, 0.5f, 0.5f, 0.0f);
+	// Used by the sphere shape
+	float m_Radius = 0.5f;
+	// Used by the convex shape, in the local space, the hull of these points is the shape
+	std::vector<Vec4> m_ConvexVertices;
+	// 0 means a static body
+	float m_Mass = 1.0f;
+	float m_Friction = 0.5f;
+	float m_Restitution = 0.0f;
+	void* m_UserData = nullptr;
+};
+
+struct RigidBody
+{
+	RigidBodyShapeType m_ShapeType = RigidBodyShapeType::Box;
+	// The position has w = 1, all the other vectors have w = 0
+	Vec4 m_Position;
+	Vec4 m_Rotation;
+	Vec4 m_LinearVelocity;
+	Vec4 m_AngularVelocity;
+	// The columns of the rotation matrix, updated after every integration
+	Vec4 m_Axes[3];
+	Vec4 m_HalfExtents;
+	float m_Radius = 0.0f;
+	uint32_t m_ConvexShapeIndex = 0;
+	float m_InvMass = 0.0f;
+	// The diagonal of the inverse inertia tensor in the local space
+	Vec4 m_InvInertiaLS;
+	float m_Friction = 0.5f;
+	float m_Restitution = 0.0f;
+	AABB m_AABBWS;
+	uint32_t m_IslandIndex = 0;
+	// How long the body has been almost still, an island falls asleep when all its bodies are still long enough
+	float m_StillTime = 0.0f;
+	bool m_Sleeping = false;
+	void* m_UserData = nullptr;
+};
+
+struct RigidBodyContactPoint
+{
+	Vec4 m_Position;
+	// The contact point in the local spaces of the two bodies, used to match the points of the previous step
+	Vec4 m_LocalPositionA;
+	Vec4 m_LocalPositionB;
+	float m_Depth = 0.0f;
+	// The accumulated impulses, kept between the steps for the warm starting
+	float m_NormalImpulse = 0.0f;
+	float m_TangentImpulse[2] = { 0.0f, 0.0f };
+	// Solver data
+	Vec4 m_RA;
+	Vec4 m_RB;
+	float m_NormalMass = 0.0f;
+	float m_TangentMass[2] = { 0.0f, 0.0f };
+	float m_VelocityBias = 0.0f;
+};
+
+struct RigidBodyContactManifold
+{
+	uint32_t m_BodyA = 0;
+	uint32_t m_BodyB = 0;
+	// From A to B
+	Vec4 m_Normal;
+	Vec4 m_Tangents[2];
+	float m_Friction = 0.0f;
+	float m_Restitution = 0.0f;
+	uint32_t m_PointCount = 0;
+	RigidBodyContactPoint m_Points[4];
+};
+
+struct RigidBodyWorld
+{
+	std::vector<RigidBody> m_Bodies;
+	std::vector<std::vector<Vec4>> m_ConvexShapes;
+	Vec4 m_Gravity = Vec4(0.0f, -9.81f, 0.0f, 0.0f);
+	uint32_t m_SolverIterationCount = 10;
+
+	// The body indices sorted by the AABB minimum on X, kept between the steps so the sort is almost linear
+	std::vector<uint32_t> m_SortedBodyIndices;
+	std::vector<std::pair<uint32_t, uint32_t>> m_Pairs;
+	std::vector<RigidBodyContactManifold> m_PairManifolds;
+	std::vector<RigidBodyContactManifold> m_Manifolds;
+	// The manifolds of the previous step indexed by the body pair
+	std::unordered_map<uint64_t, uint32_t> m_ManifoldMap;
+
+	std::vector<uint32_t> m_IslandParents;
+	// The manifolds of the island i are m_IslandManifoldIndices[m_IslandManifoldOffsets[i]] to m_IslandManifoldIndices[m_IslandManifoldOffsets[i + 1] - 1]
+	std::vector<uint32_t> m_IslandManifoldOffsets;
+	std::vector<uint32_t> m_IslandManifoldIndices;
+	// An island is awake if any of its bodies is awake, then all of them are woken up
+	std::vector<uint8_t> m_IslandAwakes;
+	std::vector<float> m_IslandStillTimes;
+};
+
+class InnoRigidBodyDynamics
+{
+public:
+	// Return the index of the body, which never changes until Clear
+	static uint32_t AddRigidBody(RigidBodyWorld& world, const RigidBodyDesc& desc);
+	static void Clear(RigidBodyWorld& world);
+	// Broadphase, narrowphase, then the sequential impulse solver on every island, the stages and the islands run in parallel on the task scheduler
+	static void Step(RigidBodyWorld& world, float deltaTime);
+	static size_t GetIslandCount(const RigidBodyWorld& world);
+	static size_t GetContactPointCount(const RigidBodyWorld& world);
+	static size_t GetSleepingBodyCount(const RigidBodyWorld& world);
+};
@@ -0,0 +1,44 @@
+#include "InnoSceneQuery.h"
+#include <algorithm>
+
+std::shared_ptr<IInnoTask> InnoSceneQuery::Submit(SceneQueryContext& context, const char* name, const std::function<void()>& query)
+{
+	using PackagedTask = std::packaged_task<void()>;
+	using TaskType = InnoTask<PackagedTask>;
+
+	PackagedTask l_task{ [&context, query]()
+	{
+		std::shared_lock<std::shared_mutex> lock{ context.m_Mutex };
+		query();
+	} };
+
+	auto l_result = InnoTaskScheduler::AddTaskImpl(std::make_unique<TaskType>(std::move(l_task), name, nullptr), -1);
+
+	std::lock_guard<std::mutex> lock{ context.m_TaskMutex };
+
+	context.m_Tasks.erase(std::remove_if(context.m_Tasks.begin(), context.m_Tasks.end(), [](const std::shared_ptr<IInnoTask>& task)
+	{
+		return task->IsFinished();
+	}), context.m_Tasks.end());
+
+	context.m_Tasks.emplace_back(l_result);
+
+	return l_result;
+}
+
+void InnoSceneQuery::WaitAll(SceneQueryContext& context)
+{
+	std::lock_guard<std::mutex> lock{ context.m_TaskMutex };
+
+	for (auto& i : context.m_Tasks)
+	{
+		i->Wait();
+	}
+	context.m_Tasks.clear();
+}
+
+size_t InnoSceneQuery::GetTaskCount(SceneQueryContext& context)
+{
+	std::lock_guard<std::mutex> lock{ context.m_TaskMutex };
+	return context.m_Tasks.size();
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <shared_mutex>
+#include <mutex>
+#include <vector>
+#include "InnoTaskScheduler.h"
+
+// The scene queries run in tasks under the shared side of the mutex, the updates of the data they read take the exclusive side
+struct SceneQueryContext
+{
+	std::shared_mutex m_Mutex;
+	// Only the unfinished query tasks are kept, they're waited before the data they read is destroyed
+	std::vector<std::shared_ptr<IInnoTask>> m_Tasks;
+	std::mutex m_TaskMutex;
+};
+
+class InnoSceneQuery
+{
+public:
+	// The finished tasks are dropped when a new one is submitted
+	static std::shared_ptr<IInnoTask> Submit(SceneQueryContext& context, const char* name, const std::function<void()>& query);
+	static void WaitAll(SceneQueryContext& context);
+	static size_t GetTaskCount(SceneQueryContext& context);
+};
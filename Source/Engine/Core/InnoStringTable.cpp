@@ -0,0 +1,141 @@
+#include "InnoStringTable.h"
+#include "../Common/InnoInternedString.h"
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <string_view>
+#include <shared_mutex>
+#include <mutex>
+#include <atomic>
+#include "InnoLogger.h"
+
+namespace InnoStringTableNS
+{
+	const std::size_t m_PageSize = 64 * 1024;
+
+	// The interning is serialized by the mutex, the lookups by ID don't lock
+	std::shared_mutex m_Mutex;
+	std::vector<std::unique_ptr<char[]>> m_Pages;
+	std::size_t m_CurrentPageOffset = m_PageSize;
+	std::atomic<std::size_t> m_TotalSize = 0;
+
+	// The string pointers are in fixed-size chunks which never move, a slot is written before the count is increased to publish it
+	const std::size_t m_StringChunkSize = 4096;
+	const std::size_t m_MaxStringChunkCount = 4096;
+	std::unique_ptr<const char*[]> m_StringChunks[m_MaxStringChunkCount];
+	std::atomic<uint32_t> m_StringCount = 1;
+
+	std::unordered_map<std::string_view, uint32_t> m_IDs;
+
+	char* AllocateString(std::size_t length);
+}
+
+char* InnoStringTableNS::AllocateString(std::size_t length)
+{
+	auto l_size = length + 1;
+
+	// Oversized strings have their own page, the current page remains available for the following ones
+	if (l_size > m_PageSize)
+	{
+		m_Pages.emplace_back(std::make_unique<char[]>(l_size));
+		return m_Pages.back().get();
+	}
+
+	if (m_CurrentPageOffset + l_size > m_PageSize)
+	{
+		m_Pages.emplace_back(std::make_unique<char[]>(m_PageSize));
+		m_CurrentPageOffset = 0;
+	}
+
+	auto l_result = m_Pages.back().get() + m_CurrentPageOffset;
+	m_CurrentPageOffset += l_size;
+
+	return l_result;
+}
+
+uint32_t InnoStringTable::Intern(const char* content, std::size_t length)
+{
+	if (!length)
+	{
+		return 0;
+	}
+
+	std::string_view l_key(content, length);
+
+	{
+		std::shared_lock<std::shared_mutex> lock{ InnoStringTableNS::m_Mutex };
+		auto l_result = InnoStringTableNS::m_IDs.find(l_key);
+		if (l_result != InnoStringTableNS::m_IDs.end())
+		{
+			return l_result->second;
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> lock{ InnoStringTableNS::m_Mutex };
+
+	// Another thread might have interned the same content between the two locks
+	auto l_result = InnoStringTableNS::m_IDs.find(l_key);
+	if (l_result != InnoStringTableNS::m_IDs.end())
+	{
+		return l_result->second;
+	}
+
+	auto l_ID = InnoStringTableNS::m_StringCount.load(std::memory_order_relaxed);
+	auto l_chunkIndex = l_ID / InnoStringTableNS::m_StringChunkSize;
+
+	if (l_chunkIndex >= InnoStringTableNS::m_MaxStringChunkCount)
+	{
+		InnoLogger::Log(LogLevel::Error, "InnoStringTable: Reach the maximum string count!");
+		return 0;
+	}
+
+	auto& l_chunk = InnoStringTableNS::m_StringChunks[l_chunkIndex];
+	if (!l_chunk)
+	{
+		l_chunk = std::make_unique<const char*[]>(InnoStringTableNS::m_StringChunkSize);
+	}
+
+	auto l_string = InnoStringTableNS::AllocateString(length);
+	std::memcpy(l_string, content, length);
+	l_string[length] = '\0';
+
+	l_chunk[l_ID % InnoStringTableNS::m_StringChunkSize] = l_string;
+	InnoStringTableNS::m_IDs.emplace(std::string_view(l_string, length), l_ID);
+	InnoStringTableNS::m_TotalSize += length + 1;
+
+	InnoStringTableNS::m_StringCount.store(l_ID + 1, std::memory_order_release);
+
+	return l_ID;
+}
+
+const char* InnoStringTable::GetString(uint32_t ID)
+{
+	// Pairs with the release in Intern(), so the slot and the string are visible
+	if (!ID || ID >= InnoStringTableNS::m_StringCount.load(std::memory_order_acquire))
+	{
+		return "";
+	}
+
+	return InnoStringTableNS::m_StringChunks[ID / InnoStringTableNS::m_StringChunkSize][ID % InnoStringTableNS::m_StringChunkSize];
+}
+
+std::size_t InnoStringTable::GetStringCount()
+{
+	return InnoStringTableNS::m_StringCount - 1;
+}
+
+std::size_t InnoStringTable::GetTotalSize()
+{
+	return InnoStringTableNS::m_TotalSize;
+}
+
+InternedString::InternedString(const char* content)
+{
+	auto l_sizeOfContent = strlen(content);
+	m_ID = l_sizeOfContent > 1 ? InnoStringTable::Intern(content, l_sizeOfContent - 1) : 0;
+}
+
+const char* InternedString::c_str() const
+{
+	return InnoStringTable::GetString(m_ID);
+}
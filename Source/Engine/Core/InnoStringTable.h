@@ -0,0 +1,14 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+
+class InnoStringTable
+{
+public:
+	// Return the ID of the content, it would be copied into the table at the first time it's seen; ID 0 is reserved for the empty string
+	static uint32_t Intern(const char* content, std::size_t length);
+	// The returned pointer is stable until the process exits
+	static const char* GetString(uint32_t ID);
+	static std::size_t GetStringCount();
+	static std::size_t GetTotalSize();
+};
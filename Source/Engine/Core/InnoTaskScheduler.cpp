@@ -51,10 +51,23 @@ private:
 	RingBuffer<InnoTaskReport, true> m_TaskReport;
 };
 
+struct ParallelForContext
+{
+	std::function<void(size_t, size_t)> m_Func;
+	size_t m_Count;
+	size_t m_GrainSize;
+	size_t m_ChunkCount;
+	std::atomic_size_t m_NextChunk = 0;
+	std::atomic_size_t m_FinishedChunkCount = 0;
+};
+
 namespace InnoTaskSchedulerNS
 {
 	std::atomic_size_t m_NumThreads = 0;
 	std::vector<std::unique_ptr<InnoThread>> m_Threads;
+	std::atomic_size_t m_NextHelperThread = 0;
+
+	void ExecuteParallelForChunks(ParallelForContext* context);
 }
 
 using namespace InnoTaskSchedulerNS;
@@ -133,6 +146,65 @@ std::shared_ptr<IInnoTask> InnoTaskScheduler::AddTaskImpl(std::unique_ptr<IInnoT
 	return m_Threads[l_ThreadIndex]->AddTask(std::move(task));
 }
 
+void InnoTaskSchedulerNS::ExecuteParallelForChunks(ParallelForContext* context)
+{
+	while (true)
+	{
+		auto l_chunk = context->m_NextChunk++;
+		if (l_chunk >= context->m_ChunkCount)
+		{
+			return;
+		}
+
+		auto l_begin = l_chunk * context->m_GrainSize;
+		auto l_end = std::min(l_begin + context->m_GrainSize, context->m_Count);
+		context->m_Func(l_begin, l_end);
+
+		context->m_FinishedChunkCount++;
+	}
+}
+
+void InnoTaskScheduler::ParallelFor(const char* name, size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func)
+{
+	if (!count)
+	{
+		return;
+	}
+
+	grainSize = std::max<size_t>(grainSize, 1);
+	auto l_chunkCount = (count + grainSize - 1) / grainSize;
+
+	if (l_chunkCount == 1 || !m_NumThreads)
+	{
+		func(0, count);
+		return;
+	}
+
+	// The helper tasks might be executed after this function returned, they only share the context and never wait for each other, so a helper queued on the calling thread can't deadlock
+	auto l_context = std::make_shared<ParallelForContext>();
+	l_context->m_Func = func;
+	l_context->m_Count = count;
+	l_context->m_GrainSize = grainSize;
+	l_context->m_ChunkCount = l_chunkCount;
+
+	auto l_helperCount = std::min<size_t>(l_chunkCount, m_NumThreads) - 1;
+
+	for (size_t i = 0; i < l_helperCount; i++)
+	{
+		auto l_helper = [=]() { ExecuteParallelForChunks(l_context.get()); };
+		using TaskType = InnoTask<std::function<void()>>;
+		auto l_threadIndex = (int32_t)(m_NextHelperThread++ % m_NumThreads);
+		AddTaskImpl(std::make_unique<TaskType>(std::function<void()>(l_helper), name, nullptr), l_threadIndex);
+	}
+
+	ExecuteParallelForChunks(l_context.get());
+
+	while (l_context->m_FinishedChunkCount != l_chunkCount)
+	{
+		std::this_thread::yield();
+	}
+}
+
 size_t InnoTaskScheduler::GetTotalThreadsNumber()
 {
 	return m_NumThreads;
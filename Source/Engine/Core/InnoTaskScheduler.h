@@ -2,6 +2,7 @@
 #include <memory>
 #include <type_traits>
 #include <future>
+#include <functional>
 #include "../Common/InnoContainer.h"
 
 class IInnoTask
@@ -88,6 +89,8 @@ public:
 	static void WaitSync();
 
 	static std::shared_ptr<IInnoTask> AddTaskImpl(std::unique_ptr<IInnoTask>&& task, int32_t threadID);
+	// Split [0, count) into chunks of grainSize elements, the calling thread and the worker threads process them together and it returns after all chunks are finished
+	static void ParallelFor(const char* name, size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func);
 	static size_t GetTotalThreadsNumber();
 
 	static const RingBuffer<InnoTaskReport, true>& GetTaskReport(int32_t threadID);
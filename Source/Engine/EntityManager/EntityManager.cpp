@@ -11,20 +11,71 @@ namespace EntityManagerNS
 	IObjectPool* m_EntityPool;
 	ThreadSafeVector<InnoEntity*> m_Entities;
 
+	// The spawn order resolves duplicated names to the earliest spawned entity, like the linear search did
+	struct EntityNameIndexEntry
+	{
+		uint64_t m_SpawnOrder;
+		InnoEntity* m_Entity;
+	};
+
+	// Keys are views into the names and IDs stored inside the pooled entities
+	std::shared_mutex m_IndexMutex;
+	std::atomic<uint64_t> m_NextSpawnOrder = 0;
+	std::unordered_multimap<std::string_view, EntityNameIndexEntry> m_EntityNameIndex;
+	std::unordered_map<std::string_view, InnoEntity*> m_EntityIDIndex;
+
 	std::function<void()> f_SceneLoadingStartCallback;
+
+	void AddToIndex(InnoEntity* entity, uint64_t spawnOrder);
+	uint64_t RemoveFromIndex(InnoEntity* entity);
 }
 
 using namespace EntityManagerNS;
 
+void EntityManagerNS::AddToIndex(InnoEntity* entity, uint64_t spawnOrder)
+{
+	std::unique_lock<std::shared_mutex> lock{ m_IndexMutex };
+
+	m_EntityNameIndex.emplace(std::string_view(entity->m_EntityName.c_str()), EntityNameIndexEntry{ spawnOrder, entity });
+	m_EntityIDIndex.emplace(std::string_view(entity->m_EntityID.c_str()), entity);
+}
+
+uint64_t EntityManagerNS::RemoveFromIndex(InnoEntity* entity)
+{
+	std::unique_lock<std::shared_mutex> lock{ m_IndexMutex };
+
+	uint64_t l_spawnOrder = 0;
+
+	auto l_range = m_EntityNameIndex.equal_range(std::string_view(entity->m_EntityName.c_str()));
+	for (auto it = l_range.first; it != l_range.second; it++)
+	{
+		if (it->second.m_Entity == entity)
+		{
+			l_spawnOrder = it->second.m_SpawnOrder;
+			m_EntityNameIndex.erase(it);
+			break;
+		}
+	}
+
+	m_EntityIDIndex.erase(std::string_view(entity->m_EntityID.c_str()));
+
+	return l_spawnOrder;
+}
+
 bool InnoEntityManager::Setup()
 {
 	m_EntityPool = InnoMemory::CreateObjectPool<InnoEntity>(m_MaxEntity);
 
+	m_Entities.reserve(m_MaxEntity);
+	m_EntityNameIndex.reserve(m_MaxEntity);
+	m_EntityIDIndex.reserve(m_MaxEntity);
+
 	f_SceneLoadingStartCallback = [&]() {
 		for (auto i : m_Entities)
 		{
 			if (i->m_ObjectOwnership == ObjectOwnership::Client)
 			{
+				RemoveFromIndex(i);
 				i->m_ObjectStatus = ObjectStatus::Terminated;
 				m_EntityPool->Destroy(i);
 			}
@@ -37,7 +88,11 @@ bool InnoEntityManager::Setup()
 		}), m_Entities.end());
 	};
 
-	g_pModuleManager->getFileSystem()->addSceneLoadingStartCallback(&f_SceneLoadingStartCallback);
+	// The standalone tests run the entity manager without the module manager
+	if (g_pModuleManager)
+	{
+		g_pModuleManager->getFileSystem()->addSceneLoadingStartCallback(&f_SceneLoadingStartCallback);
+	}
 
 	return true;
 }
@@ -72,38 +127,122 @@ InnoEntity * InnoEntityManager::Spawn(ObjectSource objectSource, ObjectOwnership
 		l_Entity->m_ObjectSource = objectSource;
 		l_Entity->m_ObjectOwnership = objectUsage;
 		l_Entity->m_ObjectStatus = ObjectStatus::Activated;
+
+		AddToIndex(l_Entity, m_NextSpawnOrder++);
 	}
 
 	InnoLogger::Log(LogLevel::Verbose, "EntityManager: Entity ", l_Entity->m_EntityName.c_str(), " has been created.");
 	return l_Entity;
 }
 
+std::vector<InnoEntity*> InnoEntityManager::SpawnBatch(uint32_t count, ObjectSource objectSource, ObjectOwnership objectUsage, const char* entityNamePrefix)
+{
+	if (!count)
+	{
+		return {};
+	}
+
+	std::vector<InnoEntity*> l_Entities(count);
+
+	if (!InnoMemory::SpawnBatch<InnoEntity>(m_EntityPool, l_Entities.data(), count))
+	{
+		InnoLogger::Log(LogLevel::Error, "EntityManager: Can't spawn ", count, " entities with prefix ", entityNamePrefix, "!");
+		return {};
+	}
+
+	// "[prefix][index]/", the trailing slash is trimmed by EntityName
+	char l_entityName[128];
+	auto l_prefixLength = std::min(strlen(entityNamePrefix), sizeof(l_entityName) - 13);
+	std::memcpy(l_entityName, entityNamePrefix, l_prefixLength);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		auto l_Entity = l_Entities[i];
+
+		auto l_indexBegin = l_entityName + l_prefixLength;
+		u32toa_countlut(i, l_indexBegin);
+		auto l_indexEnd = l_indexBegin + CountDecimalDigit32(i);
+		*l_indexEnd = '/';
+		*(l_indexEnd + 1) = '\0';
+
+		l_Entity->m_EntityID = InnoMath::createEntityID();
+		l_Entity->m_EntityName = l_entityName;
+		l_Entity->m_ObjectSource = objectSource;
+		l_Entity->m_ObjectOwnership = objectUsage;
+		l_Entity->m_ObjectStatus = ObjectStatus::Activated;
+	}
+
+	m_Entities.insert(m_Entities.end(), l_Entities.begin(), l_Entities.end());
+
+	{
+		std::unique_lock<std::shared_mutex> lock{ m_IndexMutex };
+
+		auto l_spawnOrder = m_NextSpawnOrder.fetch_add(count);
+
+		for (auto i : l_Entities)
+		{
+			m_EntityNameIndex.emplace(std::string_view(i->m_EntityName.c_str()), EntityNameIndexEntry{ l_spawnOrder++, i });
+			m_EntityIDIndex.emplace(std::string_view(i->m_EntityID.c_str()), i);
+		}
+	}
+
+	InnoLogger::Log(LogLevel::Verbose, "EntityManager: ", count, " entities with prefix ", entityNamePrefix, " have been created.");
+	return l_Entities;
+}
+
 bool InnoEntityManager::Destroy(InnoEntity * entity)
 {
+	RemoveFromIndex(entity);
 	m_Entities.eraseByValue(entity);
 	InnoLogger::Log(LogLevel::Verbose, "EntityManager: Entity ", entity->m_EntityName.c_str(), " has been removed.");
 	m_EntityPool->Destroy(entity);
 	return true;
 }
 
+bool InnoEntityManager::Rename(InnoEntity * entity, const char * entityName)
+{
+	auto l_spawnOrder = RemoveFromIndex(entity);
+	entity->m_EntityName = entityName;
+	AddToIndex(entity, l_spawnOrder);
+	return true;
+}
+
 std::optional<InnoEntity*> InnoEntityManager::Find(const char * entityName)
 {
-	auto l_FindResult = std::find_if(
-		m_Entities.begin(),
-		m_Entities.end(),
-		[&](auto val) -> bool {
-		return val->m_EntityName == entityName;
-	});
-
-	if (l_FindResult != m_Entities.end())
 	{
-		return *l_FindResult;
+		std::shared_lock<std::shared_mutex> lock{ m_IndexMutex };
+
+		auto l_range = m_EntityNameIndex.equal_range(std::string_view(entityName));
+
+		if (l_range.first != l_range.second)
+		{
+			auto l_FindResult = std::min_element(l_range.first, l_range.second, [](auto& lhs, auto& rhs) {
+				return lhs.second.m_SpawnOrder < rhs.second.m_SpawnOrder;
+			});
+
+			return l_FindResult->second.m_Entity;
+		}
 	}
-	else
+
+	InnoLogger::Log(LogLevel::Warning, "EntityManager: Can't find entity by name ", entityName, "!");
+	return std::nullopt;
+}
+
+std::optional<InnoEntity*> InnoEntityManager::Find(const EntityID & entityID)
+{
 	{
-		InnoLogger::Log(LogLevel::Warning, "EntityManager: Can't find entity by name ", entityName, "!");
-		return std::nullopt;
+		std::shared_lock<std::shared_mutex> lock{ m_IndexMutex };
+
+		auto l_FindResult = m_EntityIDIndex.find(std::string_view(entityID.c_str()));
+
+		if (l_FindResult != m_EntityIDIndex.end())
+		{
+			return l_FindResult->second;
+		}
 	}
+
+	InnoLogger::Log(LogLevel::Warning, "EntityManager: Can't find entity by ID ", entityID.c_str(), "!");
+	return std::nullopt;
 }
 
 const std::vector<InnoEntity*>&  InnoEntityManager::GetEntities()
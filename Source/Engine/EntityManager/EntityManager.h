@@ -11,8 +11,11 @@ public:
 	bool Simulate() override;
 	bool Terminate() override;
 	InnoEntity* Spawn(ObjectSource objectSource, ObjectOwnership objectUsage, const char* entityName) override;
+	std::vector<InnoEntity*> SpawnBatch(uint32_t count, ObjectSource objectSource, ObjectOwnership objectUsage, const char* entityNamePrefix) override;
 	bool Destroy(InnoEntity* entity) override;
 	const std::vector<InnoEntity*>& GetEntities() override;
+	bool Rename(InnoEntity* entity, const char* entityName) override;
 	std::optional<InnoEntity*> Find(const char* entityName) override;
+	std::optional<InnoEntity*> Find(const EntityID& entityID) override;
 	uint64_t AcquireUUID() override;
 };
\ No newline at end of file
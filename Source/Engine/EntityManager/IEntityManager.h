@@ -14,8 +14,12 @@ public:
 	virtual bool Simulate() = 0;
 	virtual bool Terminate() = 0;
 	virtual InnoEntity* Spawn(ObjectSource objectSource, ObjectOwnership objectUsage, const char* entityName = "") = 0;
+	virtual std::vector<InnoEntity*> SpawnBatch(uint32_t count, ObjectSource objectSource, ObjectOwnership objectUsage, const char* entityNamePrefix = "") = 0;
 	virtual bool Destroy(InnoEntity* entity) = 0;
+	virtual bool Rename(InnoEntity* entity, const char* entityName) = 0;
+	// Returns the earliest spawned entity when several entities share the name
 	virtual std::optional<InnoEntity*> Find(const char* entityName) = 0;
+	virtual std::optional<InnoEntity*> Find(const EntityID& entityID) = 0;
 	virtual const std::vector<InnoEntity*>& GetEntities() = 0;
 	virtual uint64_t AcquireUUID() = 0;
 };
\ No newline at end of file
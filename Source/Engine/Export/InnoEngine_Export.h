@@ -0,0 +1 @@
+#define INNO_ENGINE_API
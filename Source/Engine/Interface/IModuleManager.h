@@ -31,6 +31,29 @@ struct InitConfig
 	EngineMode engineMode = EngineMode::Host;
 	RenderingServer renderingServer = RenderingServer::GL;
 	LogLevel logLevel = LogLevel::Success;
+	// How many frames could be in flight at the same time, 1 or 2, the logic and the culling of the next frame run during the rendering of the current one if it's 2
+	// The rendering frontend output is a single set which the next frame waits for the previous one to consume, so a third frame couldn't run ahead
+	uint32_t frameInFlightCount = 2;
+	// Run without any window or GPU, the frames are still simulated, culled and prepared by the rendering frontend
+	bool headless = false;
+	// The headless mode stops after these frames, 0 means it never stops
+	uint32_t headlessFrameCount = 0;
+};
+
+// All the times are the CPU times in milliseconds
+struct FrameStatistics
+{
+	uint64_t frameCount = 0;
+	uint64_t simulationStepCount = 0;
+	// From the start of a frame to the start of the next one
+	float lastFrameTime = 0.0f;
+	float averageFrameTime = 0.0f;
+	float minFrameTime = 0.0f;
+	float maxFrameTime = 0.0f;
+	// The stages of the last finished frame
+	float simulationTime = 0.0f;
+	float cullingTime = 0.0f;
+	float renderingFrontendTime = 0.0f;
 };
 
 class IModuleManager
@@ -65,6 +88,11 @@ public:
 	INNO_ENGINE_API virtual InitConfig getInitConfig() = 0;
 
 	INNO_ENGINE_API virtual float getTickTime() = 0;
+	// The time step of the simulation in milliseconds, it's fixed so the result doesn't depend on the frame rate
+	INNO_ENGINE_API virtual float getFixedTimeStep() = 0;
+	// Where the rendering is between the previous and the current simulation step, from 0 to 1
+	INNO_ENGINE_API virtual float getInterpolationFactor() = 0;
+	INNO_ENGINE_API virtual FrameStatistics getFrameStatistics() = 0;
 
 	INNO_ENGINE_API virtual const FixedSizeString<128>& getApplicationName() = 0;
 };
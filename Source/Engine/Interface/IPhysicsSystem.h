@@ -4,6 +4,7 @@
 #include "../Common/InnoClassTemplate.h"
 #include "../Component/VisibleComponent.h"
 #include "../Component/MeshDataComponent.h"
+#include "../Core/InnoTaskScheduler.h"
 
 enum class CullingDataChannel {
 	Shadow = 1, MainCamera = 2, All = Shadow | MainCamera
@@ -12,6 +13,7 @@ enum class CullingDataChannel {
 struct CullingData
 {
 	Mat4 m;
+	// The transformation the object was rendered with in the previous frame
 	Mat4 m_prev;
 	Mat4 normalMat;
 	MeshDataComponent* mesh;
@@ -19,19 +21,47 @@ struct CullingData
 	VisibilityType visibilityType;
 	MeshUsageType meshUsageType;
 	CullingDataChannel cullingDataChannel;
+	// Bit i is set if the object casts shadow into the sun's cascade i
+	uint32_t shadowCascadeMask;
 	uint64_t UUID;
+	// Stable across the frames until the scene is reloaded, so it could identify the object
+	PhysicsDataComponent* PDC;
 };
 
-struct BVHNode
+// A read-only view of the culling results of one frame, the physics system never reuses the results before all of their views are released
+using CullingDataView = std::shared_ptr<const std::vector<CullingData>>;
+
+struct SceneRaycastQuery
+{
+	Vec4 m_Origin;
+	// Doesn't need to be normalized, the distances are in the unit of its length
+	Vec4 m_Direction;
+	float m_MaxDistance = 1000.0f;
+	// The full size of the AABB swept along the ray, zero for a ray
+	Vec4 m_Extent;
+	// Refine the hits against the mesh triangles, only used by the rays
+	bool m_TestTriangles = true;
+};
+
+struct SceneRaycastResult
 {
-	BVHNode* parentNode = 0;
-	BVHNode* leftChildNode = 0;
-	BVHNode* rightChildNode = 0;
+	bool m_IsHit = false;
+	float m_Distance = 0.0f;
+	Vec4 m_Position;
+	VisibleComponent* m_VisibleComponent = nullptr;
+	PhysicsDataComponent* m_PDC = nullptr;
+};
 
-	size_t depth = 0;
+// The queries are answered in parallel, the results are valid after the task of the batch is finished
+struct SceneQueryBatch
+{
+	std::vector<SceneRaycastQuery> m_Raycasts;
+	std::vector<AABB> m_Overlaps;
 
-	PhysicsDataComponent* intermediatePDC;
-	std::vector<PhysicsDataComponent*> childrenPDCs;
+	std::vector<SceneRaycastResult> m_RaycastResults;
+	// The hits of the overlap i are m_OverlapResults[m_OverlapResultOffsets[i]] to m_OverlapResults[m_OverlapResultOffsets[i + 1] - 1]
+	std::vector<size_t> m_OverlapResultOffsets;
+	std::vector<PhysicsDataComponent*> m_OverlapResults;
 };
 
 class IPhysicsSystem
@@ -51,9 +81,10 @@ public:
 	virtual bool generatePhysicsProxy(VisibleComponent* VC) = 0;
 	virtual void updateBVH() = 0;
 	virtual void updateCulling() = 0;
-	virtual const std::vector<CullingData>& getCullingData() = 0;
+	virtual CullingDataView getCullingData() = 0;
 	virtual AABB getVisibleSceneAABB() = 0;
 	virtual AABB getStaticSceneAABB() = 0;
 	virtual AABB getTotalSceneAABB() = 0;
-	virtual BVHNode* getRootBVHNode() = 0;
+	// The batch should be kept alive until the returned task is finished, the BVH isn't updated before that
+	virtual std::shared_ptr<IInnoTask> submitSceneQueries(const std::shared_ptr<SceneQueryBatch>& batch) = 0;
 };
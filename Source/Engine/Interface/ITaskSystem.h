@@ -19,6 +19,7 @@ public:
 
 	virtual const RingBuffer<InnoTaskReport, true>& GetTaskReport(int32_t threadID) = 0;
 	virtual size_t GetTotalThreadsNumber() = 0;
+	virtual void parallelFor(const char* name, size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func) = 0;
 
 	template <typename Func, typename... Args>
 	std::shared_ptr<IInnoTask> submit(const char* name, int32_t threadID, const std::shared_ptr<IInnoTask>& upstreamTask, Func&& func, Args&&... args)
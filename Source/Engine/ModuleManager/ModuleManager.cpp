@@ -17,6 +17,7 @@
 #include "../SubSystem/EventSystem.h"
 #include "../RenderingFrontend/RenderingFrontend.h"
 #include "../RenderingFrontend/GUISystem.h"
+#include "../RenderingServer/Null/NullRenderingServer.h"
 
 #if defined INNO_PLATFORM_WIN
 #include "../Platform/WinWindow/WinWindowSystem.h"
@@ -125,6 +126,33 @@ namespace InnoModuleManagerNS
 
 	InitConfig m_initConfig;
 
+	// The tasks of a frame, the frame is in flight until its rendering server execute task is finished
+	struct FrameResource
+	{
+		uint64_t m_FrameIndex = 0;
+		// The last simulation step of the frame, the frame may have none
+		std::shared_ptr<IInnoTask> m_SimulationStepTask;
+		std::shared_ptr<IInnoTask> m_PhysicsSystemCullingTask;
+		std::shared_ptr<IInnoTask> m_RenderingFrontendUpdateTask;
+		std::shared_ptr<IInnoTask> m_RenderingServerPrepareTask;
+		std::shared_ptr<IInnoTask> m_RenderingServerExecuteTask;
+		uint64_t m_RenderingStartTime = 0;
+	};
+
+	// The rendering frontend output isn't buffered per frame, so only the next frame could overlap the current one
+	static const uint32_t m_maxFrameInFlightCount = 2;
+	FrameResource m_frameResources[m_maxFrameInFlightCount];
+	std::mutex m_frameResourcesMutex;
+	uint64_t m_frameIndex = 0;
+
+	FrameResource& getFrameResource(uint64_t frameIndex);
+	// A frame ends with its rendering server execute task, including the headless ones, the frames which aren't rendered have none
+	std::shared_ptr<IInnoTask> getLastTask(const FrameResource& frameResource);
+	void waitForFrame(FrameResource& frameResource);
+	void waitForPreviousFrames();
+
+	std::function<void()> f_SceneLoadingStartCallback;
+
 	std::unique_ptr<ITimeSystem> m_TimeSystem;
 	std::unique_ptr<ILogSystem> m_LogSystem;
 	std::unique_ptr<IMemorySystem> m_MemorySystem;
@@ -162,9 +190,25 @@ namespace InnoModuleManagerNS
 	std::function<void()> f_PhysicsSystemUpdateBVHJob;
 	std::function<void()> f_PhysicsSystemCullingJob;
 	std::function<void()> f_RenderingFrontendUpdateJob;
-	std::function<void()> f_RenderingServerUpdateJob;
+	std::function<void(FrameResource*)> f_RenderingServerPrepareJob;
+	std::function<void(FrameResource*)> f_RenderingServerExecuteJob;
 
-	float m_tickTime = 0;
+	std::atomic<float> m_tickTime = 0.0f;
+
+	const float m_fixedTimeStep = 1000.0f / 60.0f;
+	// The time beyond these steps is dropped, otherwise a slow frame makes the next frames even slower
+	const uint32_t m_maxSimulationStepCount = 4;
+	// Start with one step so the first frame has a simulated state
+	float m_simulationTimeAccumulator = m_fixedTimeStep;
+	uint64_t m_lastFrameStartTime = 0;
+	float m_interpolationFactor = 0.0f;
+
+	FrameStatistics m_frameStatistics;
+	std::mutex m_frameStatisticsMutex;
+	std::atomic<float> m_cullingTime = 0.0f;
+	std::atomic<float> m_renderingFrontendTime = 0.0f;
+
+	void updateFrameStatistics(float frameTime, float simulationTime, uint32_t simulationStepCount);
 }
 
 using namespace InnoModuleManagerNS;
@@ -295,6 +339,42 @@ InitConfig InnoModuleManagerNS::parseInitConfig(const std::string& arg)
 		}
 	}
 
+	auto l_frameInFlightArgPos = arg.find("frames");
+	if (l_frameInFlightArgPos != std::string::npos)
+	{
+		std::string l_frameInFlightArguments = arg.substr(l_frameInFlightArgPos + 7);
+		l_frameInFlightArguments = l_frameInFlightArguments.substr(0, 1);
+
+		if (l_frameInFlightArguments == "1" || l_frameInFlightArguments == "2")
+		{
+			l_result.frameInFlightCount = (uint32_t)std::stoi(l_frameInFlightArguments);
+			InnoLogger::Log(LogLevel::Success, "ModuleManager: Launch with ", l_result.frameInFlightCount, " frame(s) in flight.");
+		}
+		else
+		{
+			InnoLogger::Log(LogLevel::Warning, "ModuleManager: Unsupported frame in flight count, use default ", l_result.frameInFlightCount, " frames in flight.");
+		}
+	}
+
+	auto l_headlessArgPos = arg.find("headless");
+	if (l_headlessArgPos != std::string::npos)
+	{
+		l_result.headless = true;
+
+		std::string l_headlessArguments = arg.substr(l_headlessArgPos + 8);
+		auto l_frameCountPos = l_headlessArguments.find_first_not_of(' ');
+
+		if (l_frameCountPos != std::string::npos && std::isdigit(l_headlessArguments[l_frameCountPos]))
+		{
+			l_result.headlessFrameCount = (uint32_t)std::stoul(l_headlessArguments.substr(l_frameCountPos));
+			InnoLogger::Log(LogLevel::Success, "ModuleManager: Launch in headless mode for ", l_result.headlessFrameCount, " frame(s).");
+		}
+		else
+		{
+			InnoLogger::Log(LogLevel::Success, "ModuleManager: Launch in headless mode.");
+		}
+	}
+
 	return l_result;
 }
 
@@ -319,30 +399,33 @@ bool InnoModuleManagerNS::createSubSystemInstance(void* appHook, void* extraHook
 	createSubSystemInstanceDefi(PhysicsSystem);
 	createSubSystemInstanceDefi(EventSystem);
 
-	std::string l_windowArguments = pScmdline;
+	std::string l_windowArguments = pScmdline ? pScmdline : "";
 	m_initConfig = parseInitConfig(l_windowArguments);
 
-#if defined INNO_PLATFORM_WIN
-	m_WindowSystem = std::make_unique<WinWindowSystem>();
-	if (!m_WindowSystem.get())
+	if (!m_initConfig.headless)
 	{
-		return false;
-	}
+#if defined INNO_PLATFORM_WIN
+		m_WindowSystem = std::make_unique<WinWindowSystem>();
+		if (!m_WindowSystem.get())
+		{
+			return false;
+		}
 #endif
 #if defined INNO_PLATFORM_MAC
-	m_WindowSystem = std::make_unique<MacWindowSystem>();
-	if (!m_WindowSystem.get())
-	{
-		return false;
-	}
+		m_WindowSystem = std::make_unique<MacWindowSystem>();
+		if (!m_WindowSystem.get())
+		{
+			return false;
+		}
 #endif
 #if defined INNO_PLATFORM_LINUX
-	m_WindowSystem = std::make_unique<LinuxWindowSystem>();
-	if (!m_WindowSystem.get())
-	{
-		return false;
-	}
+		m_WindowSystem = std::make_unique<LinuxWindowSystem>();
+		if (!m_WindowSystem.get())
+		{
+			return false;
+		}
 #endif
+	}
 
 	m_RenderingFrontend = std::make_unique<InnoRenderingFrontend>();
 	if (!m_RenderingFrontend.get())
@@ -356,6 +439,17 @@ bool InnoModuleManagerNS::createSubSystemInstance(void* appHook, void* extraHook
 		return false;
 	}
 
+	if (m_initConfig.headless)
+	{
+		m_RenderingServer = std::make_unique<NullRenderingServer>();
+		if (!m_RenderingServer.get())
+		{
+			return false;
+		}
+
+		return true;
+	}
+
 	switch (m_initConfig.renderingServer)
 	{
 	case RenderingServer::GL:
@@ -447,11 +541,14 @@ bool InnoModuleManagerNS::setup(void* appHook, void* extraHook, char* pScmdline,
 
 	subSystemSetup(TestSystem);
 
-	if (!m_WindowSystem->setup(appHook, extraHook))
+	if (!m_initConfig.headless)
 	{
-		return false;
+		if (!m_WindowSystem->setup(appHook, extraHook))
+		{
+			return false;
+		}
+		InnoLogger::Log(LogLevel::Success, "WindowSystem setup finished.");
 	}
-	InnoLogger::Log(LogLevel::Success, "WindowSystem setup finished.");
 
 	subSystemSetup(AssetSystem);
 	subSystemSetup(FileSystem);
@@ -482,11 +579,14 @@ bool InnoModuleManagerNS::setup(void* appHook, void* extraHook, char* pScmdline,
 	}
 	InnoLogger::Log(LogLevel::Success, "RenderingFrontend setup finished.");
 
-	if (!m_GUISystem->setup())
+	if (!m_initConfig.headless)
 	{
-		return false;
+		if (!m_GUISystem->setup())
+		{
+			return false;
+		}
+		InnoLogger::Log(LogLevel::Success, "GUISystem setup finished.");
 	}
-	InnoLogger::Log(LogLevel::Success, "GUISystem setup finished.");
 
 	if (!m_RenderingServer->Setup())
 	{
@@ -506,28 +606,52 @@ bool InnoModuleManagerNS::setup(void* appHook, void* extraHook, char* pScmdline,
 
 	f_LogicClientUpdateJob = [&]() {m_LogicClient->update(); };
 	f_PhysicsSystemUpdateBVHJob = [&]() {m_PhysicsSystem->updateBVH(); };
-	f_PhysicsSystemCullingJob = [&]() {m_PhysicsSystem->updateCulling(); };
-	f_RenderingFrontendUpdateJob = [&]() {m_RenderingFrontend->update(); };
-	f_RenderingServerUpdateJob = [&]() {
-		auto l_tickStartTime = m_TimeSystem->getCurrentTimeFromEpoch();
+	f_PhysicsSystemCullingJob = [&]() {
+		auto l_startTime = m_TimeSystem->getCurrentTimeFromEpoch();
+
+		m_PhysicsSystem->updateCulling();
+
+		m_cullingTime = float(m_TimeSystem->getCurrentTimeFromEpoch() - l_startTime) / 1000.0f;
+	};
+	f_RenderingFrontendUpdateJob = [&]() {
+		auto l_startTime = m_TimeSystem->getCurrentTimeFromEpoch();
+
+		m_RenderingFrontend->update();
+
+		m_renderingFrontendTime = float(m_TimeSystem->getCurrentTimeFromEpoch() - l_startTime) / 1000.0f;
+	};
+	// The command lists are recorded from the frontend data, so the next frame's frontend update only waits for this part
+	f_RenderingServerPrepareJob = [&](FrameResource* frameResource) {
+		frameResource->m_RenderingStartTime = m_TimeSystem->getCurrentTimeFromEpoch();
 
 		m_RenderingFrontend->transferDataToGPU();
 
 		m_RenderingClient->PrepareCommandList();
-
+	};
+	f_RenderingServerExecuteJob = [&](FrameResource* frameResource) {
 		m_RenderingClient->ExecuteCommandList();
 
-		m_GUISystem->render();
+		if (!m_initConfig.headless)
+		{
+			m_GUISystem->render();
+		}
 
 		m_RenderingServer->Present();
 
-		g_pModuleManager->getWindowSystem()->getWindowSurface()->swapBuffer();
+		if (!m_initConfig.headless)
+		{
+			g_pModuleManager->getWindowSystem()->getWindowSurface()->swapBuffer();
+		}
 
 		auto l_tickEndTime = m_TimeSystem->getCurrentTimeFromEpoch();
 
-		m_tickTime = float(l_tickEndTime - l_tickStartTime) / 1000.0f;
+		m_tickTime = float(l_tickEndTime - frameResource->m_RenderingStartTime) / 1000.0f;
 	};
 
+	// The scene data is destroyed when a new scene starts to load, so the frames in flight should be finished before that
+	f_SceneLoadingStartCallback = [&]() { waitForPreviousFrames(); };
+	m_FileSystem->addSceneLoadingStartCallback(&f_SceneLoadingStartCallback, 0);
+
 	m_ObjectStatus = ObjectStatus::Created;
 	InnoLogger::Log(LogLevel::Success, "Engine setup finished.");
 
@@ -562,12 +686,20 @@ bool InnoModuleManagerNS::initialize()
 	subSystemInit(AssetSystem);
 	subSystemInit(PhysicsSystem);
 	subSystemInit(EventSystem);
-	subSystemInit(WindowSystem);
+
+	if (!m_initConfig.headless)
+	{
+		subSystemInit(WindowSystem);
+	}
 
 	m_RenderingServer->Initialize();
 
 	subSystemInit(RenderingFrontend);
-	subSystemInit(GUISystem);
+
+	if (!m_initConfig.headless)
+	{
+		subSystemInit(GUISystem);
+	}
 
 	if (!m_RenderingClient->Initialize())
 	{
@@ -588,11 +720,89 @@ bool InnoModuleManagerNS::initialize()
 	return true;
 }
 
+InnoModuleManagerNS::FrameResource& InnoModuleManagerNS::getFrameResource(uint64_t frameIndex)
+{
+	return m_frameResources[frameIndex % m_maxFrameInFlightCount];
+}
+
+std::shared_ptr<IInnoTask> InnoModuleManagerNS::getLastTask(const FrameResource& frameResource)
+{
+	return frameResource.m_RenderingServerExecuteTask;
+}
+
+void InnoModuleManagerNS::waitForFrame(FrameResource& frameResource)
+{
+	auto l_lastTask = getLastTask(frameResource);
+
+	if (l_lastTask)
+	{
+		l_lastTask->Wait();
+	}
+}
+
+// Wait for the frames which are fully submitted, the current frame is skipped since its logic task might be the caller
+void InnoModuleManagerNS::waitForPreviousFrames()
+{
+	std::vector<std::shared_ptr<IInnoTask>> l_tasks;
+
+	{
+		std::lock_guard<std::mutex> lock{ m_frameResourcesMutex };
+
+		for (auto& i : m_frameResources)
+		{
+			auto l_lastTask = getLastTask(i);
+
+			if (i.m_FrameIndex < m_frameIndex && l_lastTask)
+			{
+				l_tasks.emplace_back(l_lastTask);
+			}
+		}
+	}
+
+	for (auto& i : l_tasks)
+	{
+		i->Wait();
+	}
+}
+
 bool InnoModuleManagerNS::update()
 {
+	auto l_frameInFlightCount = std::min(std::max(m_initConfig.frameInFlightCount, 1u), m_maxFrameInFlightCount);
+
 	while (1)
 	{
-		auto l_LogicClientUpdateTask = g_pModuleManager->getTaskSystem()->submit("LogicClientUpdateTask", 0, nullptr, f_LogicClientUpdateJob);
+		// The oldest frame in flight should be presented before a new one starts, it also frees its frame resource
+		if (m_frameIndex >= l_frameInFlightCount)
+		{
+			waitForFrame(getFrameResource(m_frameIndex - l_frameInFlightCount));
+		}
+
+		if (l_frameInFlightCount == 1)
+		{
+			m_TaskSystem->waitAllTasksToFinish();
+		}
+
+		// The previous frame's frontend reads the transforms and the interpolation factor, they could only be changed after it's finished
+		if (m_frameIndex > 0)
+		{
+			auto& l_previousFrameResource = getFrameResource(m_frameIndex - 1);
+
+			if (l_previousFrameResource.m_RenderingFrontendUpdateTask)
+			{
+				l_previousFrameResource.m_RenderingFrontendUpdateTask->Wait();
+
+				std::lock_guard<std::mutex> lock{ m_frameResourcesMutex };
+				l_previousFrameResource.m_RenderingFrontendUpdateTask = nullptr;
+			}
+		}
+
+		auto& l_frameResource = getFrameResource(m_frameIndex);
+
+		{
+			std::lock_guard<std::mutex> lock{ m_frameResourcesMutex };
+			l_frameResource = FrameResource();
+			l_frameResource.m_FrameIndex = m_frameIndex;
+		}
 
 		subSystemUpdate(TimeSystem);
 		subSystemUpdate(LogSystem);
@@ -607,7 +817,41 @@ bool InnoModuleManagerNS::update()
 			return false;
 		}
 
-		ComponentManagerUpdate(TransformComponent);
+		auto l_frameStartTime = m_TimeSystem->getCurrentTimeFromEpoch();
+		auto l_frameTime = m_lastFrameStartTime ? float(l_frameStartTime - m_lastFrameStartTime) / 1000.0f : 0.0f;
+
+		m_simulationTimeAccumulator += l_frameTime;
+		m_lastFrameStartTime = l_frameStartTime;
+
+		m_simulationTimeAccumulator = std::min(m_simulationTimeAccumulator, m_fixedTimeStep * m_maxSimulationStepCount);
+
+		uint32_t l_simulationStepCount = 0;
+
+		// The simulation advances in fixed steps, a frame could run several of them or none
+		while (m_simulationTimeAccumulator >= m_fixedTimeStep)
+		{
+			// The state before the step is kept for the rendering to interpolate from
+			m_TransformComponentManager->SaveCurrentFrameTransform();
+
+			g_pModuleManager->getTaskSystem()->submit("LogicClientUpdateTask", 0, nullptr, f_LogicClientUpdateJob);
+
+			// The rigid bodies are stepped before the transforms, so the global transforms of the step include their results
+			subSystemUpdate(PhysicsSystem);
+
+			ComponentManagerUpdate(TransformComponent);
+
+			// The tasks of the thread 0 run in order, so this finishes after the logic client, the physics and the transforms of the step
+			l_frameResource.m_SimulationStepTask = g_pModuleManager->getTaskSystem()->submit("SimulationStepTask", 0, nullptr, []() {});
+			l_frameResource.m_SimulationStepTask->Wait();
+
+			m_simulationTimeAccumulator -= m_fixedTimeStep;
+			l_simulationStepCount++;
+		}
+
+		m_interpolationFactor = m_simulationTimeAccumulator / m_fixedTimeStep;
+
+		updateFrameStatistics(l_frameTime, float(m_TimeSystem->getCurrentTimeFromEpoch() - l_frameStartTime) / 1000.0f, l_simulationStepCount);
+
 		ComponentManagerUpdate(VisibleComponent);
 		ComponentManagerUpdate(LightComponent);
 		ComponentManagerUpdate(CameraComponent);
@@ -616,26 +860,48 @@ bool InnoModuleManagerNS::update()
 
 		f_PhysicsSystemUpdateBVHJob();
 
-		subSystemUpdate(PhysicsSystem);
-
-		auto l_PhysicsSystemCullingTask = g_pModuleManager->getTaskSystem()->submit("PhysicsSystemCullingTask", 1, l_LogicClientUpdateTask, f_PhysicsSystemCullingJob);
+		l_frameResource.m_PhysicsSystemCullingTask = g_pModuleManager->getTaskSystem()->submit("PhysicsSystemCullingTask", 1, nullptr, f_PhysicsSystemCullingJob);
 
-		subSystemUpdate(EventSystem);
+		if (!m_initConfig.headless)
+		{
+			subSystemUpdate(EventSystem);
+		}
 
 		if (!m_FileSystem->isLoadingScene())
 		{
-			if (m_WindowSystem->getStatus() == ObjectStatus::Activated)
+			if (m_initConfig.headless || m_WindowSystem->getStatus() == ObjectStatus::Activated)
 			{
-				m_WindowSystem->update();
-
-				auto l_RenderingFrontendUpdateTask = g_pModuleManager->getTaskSystem()->submit("RenderingFrontendUpdateTask", 1, l_PhysicsSystemCullingTask, f_RenderingFrontendUpdateJob);
-
-				m_GUISystem->update();
-
-				auto l_RenderingServerTask = g_pModuleManager->getTaskSystem()->submit("RenderingServerTask", 2, l_RenderingFrontendUpdateTask, f_RenderingServerUpdateJob);
-				l_RenderingServerTask->Wait();
-
-				m_TransformComponentManager->SaveCurrentFrameTransform();
+				if (!m_initConfig.headless)
+				{
+					m_WindowSystem->update();
+				}
+
+				// The frontend data is a single set, so it's only rewritten after the previous frame recorded its command lists
+				if (m_frameIndex > 0)
+				{
+					auto& l_previousFrameResource = getFrameResource(m_frameIndex - 1);
+
+					if (l_previousFrameResource.m_RenderingServerPrepareTask)
+					{
+						l_previousFrameResource.m_RenderingServerPrepareTask->Wait();
+					}
+
+					// The GUI state is updated here with the rest of the game state, but it shouldn't change while the previous frame renders it
+					if (!m_initConfig.headless && l_previousFrameResource.m_RenderingServerExecuteTask)
+					{
+						l_previousFrameResource.m_RenderingServerExecuteTask->Wait();
+					}
+				}
+
+				if (!m_initConfig.headless)
+				{
+					m_GUISystem->update();
+				}
+
+				l_frameResource.m_RenderingFrontendUpdateTask = g_pModuleManager->getTaskSystem()->submit("RenderingFrontendUpdateTask", 1, l_frameResource.m_PhysicsSystemCullingTask, f_RenderingFrontendUpdateJob);
+
+				l_frameResource.m_RenderingServerPrepareTask = g_pModuleManager->getTaskSystem()->submit("RenderingServerPrepareTask", 2, l_frameResource.m_RenderingFrontendUpdateTask, f_RenderingServerPrepareJob, &l_frameResource);
+				l_frameResource.m_RenderingServerExecuteTask = g_pModuleManager->getTaskSystem()->submit("RenderingServerExecuteTask", 2, l_frameResource.m_RenderingServerPrepareTask, f_RenderingServerExecuteJob, &l_frameResource);
 			}
 			else
 			{
@@ -645,12 +911,68 @@ bool InnoModuleManagerNS::update()
 			}
 		}
 
-		m_TaskSystem->waitAllTasksToFinish();
+		{
+			std::lock_guard<std::mutex> lock{ m_frameResourcesMutex };
+			m_frameIndex++;
+		}
+
+		if (m_initConfig.headless && m_initConfig.headlessFrameCount && m_frameIndex >= m_initConfig.headlessFrameCount)
+		{
+			waitForPreviousFrames();
+
+			auto l_frameStatistics = g_pModuleManager->getFrameStatistics();
+			InnoLogger::Log(LogLevel::Success, "ModuleManager: Headless run finished after ", l_frameStatistics.frameCount, " frames, ", l_frameStatistics.simulationStepCount, " simulation steps.");
+			InnoLogger::Log(LogLevel::Success, "ModuleManager: Frame time average ", l_frameStatistics.averageFrameTime, "ms, min ", l_frameStatistics.minFrameTime, "ms, max ", l_frameStatistics.maxFrameTime, "ms.");
+			InnoLogger::Log(LogLevel::Success, "ModuleManager: Last frame simulation ", l_frameStatistics.simulationTime, "ms, culling ", l_frameStatistics.cullingTime, "ms, rendering frontend ", l_frameStatistics.renderingFrontendTime, "ms.");
+
+			auto l_renderPassStatistics = m_RenderingServer->GetRenderPassStatistics();
+
+			for (auto& i : l_renderPassStatistics)
+			{
+				auto l_name = i.m_Name.empty() ? "GPUBufferUpload/" : i.m_Name.c_str();
+				auto l_bindCount = i.m_CommandCount[(size_t)RenderingCommandType::ActivateResourceBinder];
+				auto l_bindBytes = i.m_Bytes[(size_t)RenderingCommandType::ActivateResourceBinder];
+				auto l_drawCallCount = i.m_CommandCount[(size_t)RenderingCommandType::DrawCall];
+				auto l_dispatchCount = i.m_CommandCount[(size_t)RenderingCommandType::DispatchCompute];
+				auto l_uploadCount = i.m_CommandCount[(size_t)RenderingCommandType::Upload];
+				auto l_uploadBytes = i.m_Bytes[(size_t)RenderingCommandType::Upload];
+
+				InnoLogger::Log(LogLevel::Success, "ModuleManager: ", l_name, " binds ", l_bindCount, " (", l_bindBytes, " bytes), draws ", l_drawCallCount, " (", i.m_InstanceCount, " instances), dispatches ", l_dispatchCount, " (", i.m_ThreadGroupCount, " thread groups), uploads ", l_uploadCount, " (", l_uploadBytes, " bytes).");
+			}
+
+			m_ObjectStatus = ObjectStatus::Suspended;
+			return true;
+		}
 	}
 }
 
+void InnoModuleManagerNS::updateFrameStatistics(float frameTime, float simulationTime, uint32_t simulationStepCount)
+{
+	std::lock_guard<std::mutex> lock{ m_frameStatisticsMutex };
+
+	m_frameStatistics.simulationStepCount += simulationStepCount;
+	m_frameStatistics.simulationTime = simulationTime;
+	m_frameStatistics.cullingTime = m_cullingTime;
+	m_frameStatistics.renderingFrontendTime = m_renderingFrontendTime;
+
+	// The first frame has no previous one to measure from
+	if (m_frameIndex == 0)
+	{
+		return;
+	}
+
+	auto& l_statistics = m_frameStatistics;
+
+	l_statistics.lastFrameTime = frameTime;
+	l_statistics.minFrameTime = l_statistics.frameCount ? std::min(l_statistics.minFrameTime, frameTime) : frameTime;
+	l_statistics.maxFrameTime = std::max(l_statistics.maxFrameTime, frameTime);
+	l_statistics.averageFrameTime = (l_statistics.averageFrameTime * l_statistics.frameCount + frameTime) / (l_statistics.frameCount + 1);
+	l_statistics.frameCount++;
+}
+
 bool InnoModuleManagerNS::terminate()
 {
+	waitForPreviousFrames();
 	m_TaskSystem->waitAllTasksToFinish();
 
 	if (!m_RenderingClient->Terminate())
@@ -671,10 +993,17 @@ bool InnoModuleManagerNS::terminate()
 		return false;
 	}
 
-	subSystemTerm(GUISystem);
+	if (!m_initConfig.headless)
+	{
+		subSystemTerm(GUISystem);
+	}
+
 	subSystemTerm(RenderingFrontend);
 
-	subSystemTerm(WindowSystem);
+	if (!m_initConfig.headless)
+	{
+		subSystemTerm(WindowSystem);
+	}
 
 	subSystemTerm(EventSystem);
 	subSystemTerm(PhysicsSystem);
@@ -797,6 +1126,22 @@ float InnoModuleManager::getTickTime()
 	return  m_tickTime;
 }
 
+float InnoModuleManager::getFixedTimeStep()
+{
+	return m_fixedTimeStep;
+}
+
+float InnoModuleManager::getInterpolationFactor()
+{
+	return m_interpolationFactor;
+}
+
+FrameStatistics InnoModuleManager::getFrameStatistics()
+{
+	std::lock_guard<std::mutex> lock{ m_frameStatisticsMutex };
+	return m_frameStatistics;
+}
+
 const FixedSizeString<128>& InnoModuleManager::getApplicationName()
 {
 	return m_applicationName;
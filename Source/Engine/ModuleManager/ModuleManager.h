@@ -32,5 +32,8 @@ public:
 
 	InitConfig getInitConfig() override;
 	float getTickTime() override;
+	float getFixedTimeStep() override;
+	float getInterpolationFactor() override;
+	FrameStatistics getFrameStatistics() override;
 	const FixedSizeString<128>& getApplicationName() override;
 };
\ No newline at end of file
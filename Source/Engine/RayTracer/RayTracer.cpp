@@ -4,6 +4,7 @@
 #include "../ComponentManager/ITransformComponentManager.h"
 #include "../ComponentManager/IVisibleComponentManager.h"
 #include "../ComponentManager/ICameraComponentManager.h"
+#include "../ComponentManager/ComponentQuery.h"
 
 #include "../Interface/IModuleManager.h"
 extern IModuleManager* g_pModuleManager;
@@ -255,14 +256,15 @@ bool ExecuteRayTracing()
 
 	RayTracingCamera l_rayTracingCamera(l_lookfrom, l_lookat, l_up, l_vfov, l_camera->m_WHRatio, 0.1f, 1000.0f);
 
-	auto l_visibleComponents = GetComponentManager(VisibleComponent)->GetAllComponents();
+	ComponentQuery<VisibleComponent, TransformComponent> l_visibleComponentQuery;
+	l_visibleComponentQuery.Update(g_pModuleManager->getSceneHierarchyManager());
 
 	std::vector<Hitable*> l_hitableListVector;
-	l_hitableListVector.reserve(l_visibleComponents.size());
+	l_hitableListVector.reserve(l_visibleComponentQuery.GetCount());
 
-	for (auto l_visibleComponent : l_visibleComponents)
+	for (auto& i : l_visibleComponentQuery.GetTuples())
 	{
-		auto l_transformComponent = GetComponent(TransformComponent, l_visibleComponent->m_ParentEntity);
+		auto [l_visibleComponent, l_transformComponent] = i;
 		if (l_visibleComponent->m_meshShapeType == MeshShapeType::Cube)
 		{
 			auto l_hitable = new HitableCube();
@@ -26,6 +26,7 @@ struct RenderingConfig
 	bool CSMFitToScene = false;
 	bool CSMAdjustDrawDistance = false;
 	bool CSMAdjustSidePlane = false;
+	bool useOcclusionCulling = true;
 };
 
 struct RenderingCapability
@@ -83,10 +84,21 @@ public:
 	virtual const std::vector<CSMConstantBuffer>& getCSMConstantBuffer() = 0;
 	virtual const std::vector<PointLightConstantBuffer>& getPointLightConstantBuffer() = 0;
 	virtual const std::vector<SphereLightConstantBuffer>& getSphereLightConstantBuffer() = 0;
+	virtual const std::vector<GPUBufferDirtyRange>& getPointLightConstantBufferDirtyRanges() = 0;
+	virtual const std::vector<GPUBufferDirtyRange>& getSphereLightConstantBufferDirtyRanges() = 0;
 
 	virtual const std::vector<DrawCallInfo>& getDrawCallInfo() = 0;
 	virtual const std::vector<PerObjectConstantBuffer>& getPerObjectConstantBuffer() = 0;
 	virtual const std::vector<MaterialConstantBuffer>& getMaterialConstantBuffer() = 0;
+	// The per-object and material constant buffers are persistent, only the dirty ranges of the current frame need to be uploaded
+	virtual const std::vector<GPUBufferDirtyRange>& getPerObjectConstantBufferDirtyRanges() = 0;
+	virtual const std::vector<GPUBufferDirtyRange>& getMaterialConstantBufferDirtyRanges() = 0;
+
+	virtual const std::vector<InstancedDrawCallInfo>& getInstancedDrawCallInfo() = 0;
+	// The per-object constant buffer indices of the instances
+	virtual const std::vector<uint32_t>& getInstanceIndices() = 0;
+	// The instance offsets of the instanced draw calls, in the same order
+	virtual const std::vector<InstanceConstantBuffer>& getInstanceConstantBuffer() = 0;
 
 	virtual const std::vector<BillboardPassDrawCallInfo>& getBillboardPassDrawCallInfo() = 0;
 	virtual const std::vector<PerObjectConstantBuffer>& getBillboardPassPerObjectConstantBuffer() = 0;
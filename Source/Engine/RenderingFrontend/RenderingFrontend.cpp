@@ -4,9 +4,11 @@
 #include "../ComponentManager/IVisibleComponentManager.h"
 #include "../ComponentManager/ILightComponentManager.h"
 #include "../ComponentManager/ICameraComponentManager.h"
+#include "../ComponentManager/ComponentQuery.h"
 
 #include "../Core/InnoLogger.h"
 #include "../Core/InnoMemory.h"
+#include "../Core/InnoRadixSort.h"
 
 #include "../Interface/IModuleManager.h"
 extern IModuleManager* g_pModuleManager;
@@ -35,10 +37,56 @@ namespace InnoRenderingFrontendNS
 	DoubleBuffer<std::vector<PointLightConstantBuffer>, true> m_pointLightCBVector;
 	DoubleBuffer<std::vector<SphereLightConstantBuffer>, true> m_sphereLightCBVector;
 
+	// The persistent GPU buffers keep their elements between the frames, only the changed elements of the current frame are uploaded
+	struct GPUBufferDirtySlots
+	{
+		std::vector<uint32_t> m_Slots;
+		std::vector<GPUBufferDirtyRange> m_Ranges;
+	};
+
+	// The dirty ranges closer than it are merged, a few clean elements are cheaper to upload than another upload call
+	const uint32_t m_dirtyRangeMergeDistance = 16;
+
+	GPUBufferDirtySlots m_pointLightCBDirtySlots;
+	GPUBufferDirtySlots m_sphereLightCBDirtySlots;
+
 	uint32_t m_drawCallCount = 0;
 	DoubleBuffer<std::vector<DrawCallInfo>, true> m_drawCallInfoVector;
 	DoubleBuffer<std::vector<PerObjectConstantBuffer>, true> m_perObjectCBVector;
 	DoubleBuffer<std::vector<MaterialConstantBuffer>, true> m_materialCBVector;
+	// Every object keeps its per-object constant buffer slot while it's output by the culling, a slot not used for these mesh data updates is released for the other objects
+	const uint64_t m_perObjectCBSlotLifetime = 120;
+	uint64_t m_meshDataUpdateIndex = 0;
+	std::unordered_map<PhysicsDataComponent*, uint32_t> m_perObjectCBSlots;
+	std::vector<PhysicsDataComponent*> m_perObjectCBSlotOwners;
+	std::vector<uint64_t> m_perObjectCBSlotLastUpdateIndices;
+	std::vector<uint32_t> m_perObjectCBFreeSlots;
+	GPUBufferDirtySlots m_perObjectCBDirtySlots;
+	// One material constant buffer per unique material and mesh usage type, kept between the frames
+	std::unordered_map<MaterialDataComponent*, uint32_t> m_materialCBIndices[3];
+	GPUBufferDirtySlots m_materialCBDirtySlots;
+
+	// How the per-object constant buffer slot of a culling data is written in the parallel mesh data update
+	enum class PerObjectCBWriteMode : uint8_t { None, IfChanged, Always };
+
+	struct MeshDataSlot
+	{
+		uint32_t perObjectCBSlot = UINT32_MAX;
+		uint32_t materialCBIndex = UINT32_MAX;
+		PerObjectCBWriteMode writeMode = PerObjectCBWriteMode::None;
+	};
+
+	// One element per culling data, the mesh data chunks write to their own elements, so they don't need any synchronization
+	const size_t m_meshDataGrainSize = 512;
+	std::vector<MeshDataSlot> m_meshDataSlots;
+	std::vector<DrawCallInfo> m_meshDataDrawCallInfo;
+	std::vector<uint8_t> m_meshDataPerObjectCBDirtyFlags;
+	// Whether a slot is already written by another culling data of the current frame
+	std::vector<uint8_t> m_perObjectCBSlotClaimed;
+
+	DoubleBuffer<std::vector<InstancedDrawCallInfo>, true> m_instancedDrawCallInfoVector;
+	DoubleBuffer<std::vector<uint32_t>, true> m_instanceIndices;
+	DoubleBuffer<std::vector<InstanceConstantBuffer>, true> m_instanceCBVector;
 
 	DoubleBuffer<std::vector<PerObjectConstantBuffer>, true> m_directionalLightPerObjectCB;
 	DoubleBuffer<std::vector<PerObjectConstantBuffer>, true> m_pointLightPerObjectCB;
@@ -46,15 +94,28 @@ namespace InnoRenderingFrontendNS
 
 	DoubleBuffer<std::vector<BillboardPassDrawCallInfo>, true> m_billboardPassDrawCallInfoVector;
 	DoubleBuffer<std::vector<PerObjectConstantBuffer>, true> m_billboardPassPerObjectCB;
+	ComponentQuery<LightComponent, TransformComponent> m_lightComponentQuery;
 
 	DoubleBuffer<std::vector<DebugPassDrawCallInfo>, true> m_debugPassDrawCallInfoVector;
 	DoubleBuffer<std::vector<PerObjectConstantBuffer>, true> m_debugPassPerObjectCB;
 
-	std::vector<CullingData> m_cullingData;
+	// Shared with the physics system without copying, it's valid until the next frame replaces it
+	CullingDataView m_cullingData;
+
+	// The draw calls are radix sorted by their keys, the scratch arrays keep their capacity between frames
+	std::vector<uint64_t> m_drawCallSortKeys;
+	std::vector<uint64_t> m_drawCallSortKeysScratch;
+	std::vector<uint32_t> m_drawCallSortIndices;
+	std::vector<uint32_t> m_drawCallSortIndicesScratch;
+	std::vector<DrawCallInfo> m_unsortedDrawCallInfo;
 
 	std::vector<Vec2> m_haltonSampler;
 	int32_t m_currentHaltonStep = 0;
 
+	// The camera motion is between the rendered frames, not the simulation steps
+	Mat4 m_lastViewMatrix;
+	bool m_hasLastViewMatrix = false;
+
 	std::function<void()> f_sceneLoadingStartCallback;
 	std::function<void()> f_sceneLoadingFinishCallback;
 
@@ -90,6 +151,18 @@ namespace InnoRenderingFrontendNS
 	bool updatePerFrameConstantBuffer();
 	bool updateLightData();
 
+	uint16_t getSortKeyID(uint64_t UUID);
+	uint64_t generateSortKey(const DrawCallInfo& drawCallInfo, uint32_t textureSlotMask, float depth);
+	void sortDrawCalls(std::vector<DrawCallInfo>& drawCallInfo);
+	template<typename T>
+	void writeGPUBufferSlot(std::vector<T>& GPUBuffer, uint32_t slot, const T& value, size_t comparedSize, GPUBufferDirtySlots& dirtySlots);
+	void generateDirtyRanges(GPUBufferDirtySlots& dirtySlots);
+	uint32_t updateMaterialConstantBuffer(MaterialDataComponent* material, MeshUsageType meshUsageType, std::vector<MaterialConstantBuffer>& materialCBVector);
+	uint32_t getPerObjectConstantBufferSlot(PhysicsDataComponent* PDC, bool& isNewSlot);
+	void releaseUnusedPerObjectConstantBufferSlots();
+	void resolveMeshDataSlots(std::vector<PerObjectConstantBuffer>& perObjectCBVector, std::vector<MaterialConstantBuffer>& materialCBVector);
+	void generateMeshData(size_t begin, size_t end, const PerFrameConstantBuffer& perFrameCB, std::vector<PerObjectConstantBuffer>& perObjectCBVector, const std::vector<MaterialConstantBuffer>& materialCBVector);
+	void generateInstancedDrawCalls(const std::vector<DrawCallInfo>& drawCallInfo);
 	bool updateMeshData();
 	bool updateBillboardPassData();
 	bool updateDebuggerPassData();
@@ -160,6 +233,10 @@ bool InnoRenderingFrontendNS::setup(IRenderingServer* renderingServer)
 	m_perObjectCBVector.Reserve(m_renderingCapability.maxMeshes);
 	m_materialCBVector.Reserve(m_renderingCapability.maxMaterials);
 
+	m_instancedDrawCallInfoVector.Reserve(m_renderingCapability.maxMeshes);
+	m_instanceIndices.Reserve(m_renderingCapability.maxMeshes);
+	m_instanceCBVector.Reserve(m_renderingCapability.maxMeshes);
+
 	m_pointLightCBVector.Reserve(m_renderingCapability.maxPointLights);
 	m_sphereLightCBVector.Reserve(m_renderingCapability.maxSphereLights);
 
@@ -169,7 +246,19 @@ bool InnoRenderingFrontendNS::setup(IRenderingServer* renderingServer)
 	m_billboardPassPerObjectCB.Reserve(8192);
 
 	f_sceneLoadingStartCallback = [&]() {
-		m_cullingData.clear();
+		m_cullingData.reset();
+
+		m_perObjectCBSlots.clear();
+		m_perObjectCBSlotOwners.clear();
+		m_perObjectCBSlotLastUpdateIndices.clear();
+		m_perObjectCBFreeSlots.clear();
+		m_perObjectCBVector.GetValue().clear();
+
+		for (auto& i : m_materialCBIndices)
+		{
+			i.clear();
+		}
+		m_materialCBVector.GetValue().clear();
 
 		m_drawCallCount = 0;
 	};
@@ -354,24 +443,34 @@ bool InnoRenderingFrontendNS::updatePerFrameConstantBuffer()
 		l_currentHaltonStep += 1;
 	}
 
-	auto r =
-		InnoMath::getInvertRotationMatrix(
-			l_mainCameraTransformComponent->m_globalTransformVector.m_rot
-		);
+	auto l_cameraTransformMatrix = InnoMath::interpolateTransformMatrix(l_mainCameraTransformComponent->m_globalTransformMatrix_prev, l_mainCameraTransformComponent->m_globalTransformMatrix, g_pModuleManager->getInterpolationFactor());
 
-	auto t =
-		InnoMath::getInvertTranslationMatrix(
-			l_mainCameraTransformComponent->m_globalTransformVector.m_pos
-		);
+	auto r = l_cameraTransformMatrix.m_rotationMat.inverse();
+	auto t = l_cameraTransformMatrix.m_translationMat.inverse();
 
-	l_PerFrameCB.camera_posWS = l_mainCameraTransformComponent->m_globalTransformVector.m_pos;
+#ifdef USE_COLUMN_MAJOR_MEMORY_LAYOUT
+	l_PerFrameCB.camera_posWS = Vec4(l_cameraTransformMatrix.m_translationMat.m30, l_cameraTransformMatrix.m_translationMat.m31, l_cameraTransformMatrix.m_translationMat.m32, 1.0f);
+#endif
+#ifdef USE_ROW_MAJOR_MEMORY_LAYOUT
+	l_PerFrameCB.camera_posWS = Vec4(l_cameraTransformMatrix.m_translationMat.m03, l_cameraTransformMatrix.m_translationMat.m13, l_cameraTransformMatrix.m_translationMat.m23, 1.0f);
+#endif
 
 	l_PerFrameCB.v = r * t;
 
-	auto r_prev = l_mainCameraTransformComponent->m_globalTransformMatrix_prev.m_rotationMat.inverse();
-	auto t_prev = l_mainCameraTransformComponent->m_globalTransformMatrix_prev.m_translationMat.inverse();
+	if (m_hasLastViewMatrix)
+	{
+		l_PerFrameCB.v_prev = m_lastViewMatrix;
+	}
+	else
+	{
+		auto r_prev = l_mainCameraTransformComponent->m_globalTransformMatrix_prev.m_rotationMat.inverse();
+		auto t_prev = l_mainCameraTransformComponent->m_globalTransformMatrix_prev.m_translationMat.inverse();
+
+		l_PerFrameCB.v_prev = r_prev * t_prev;
+	}
 
-	l_PerFrameCB.v_prev = r_prev * t_prev;
+	m_lastViewMatrix = l_PerFrameCB.v;
+	m_hasLastViewMatrix = true;
 
 	l_PerFrameCB.zNear = l_mainCamera->m_zNear;
 	l_PerFrameCB.zFar = l_mainCamera->m_zFar;
@@ -433,8 +532,12 @@ bool InnoRenderingFrontendNS::updateLightData()
 	auto& l_PointLightCB = m_pointLightCBVector.GetValue();
 	auto& l_SphereLightCB = m_sphereLightCBVector.GetValue();
 
-	l_PointLightCB.clear();
-	l_SphereLightCB.clear();
+	m_pointLightCBDirtySlots.m_Slots.clear();
+	m_sphereLightCBDirtySlots.m_Slots.clear();
+
+	// The lights keep their order between the frames, so only the moved or changed ones are dirty
+	uint32_t l_pointLightCount = 0;
+	uint32_t l_sphereLightCount = 0;
 
 	auto& l_lightComponents = GetComponentManager(LightComponent)->GetAllComponents();
 	auto l_lightComponentCount = l_lightComponents.size();
@@ -452,7 +555,7 @@ bool InnoRenderingFrontendNS::updateLightData()
 					l_data.pos = l_transformCompoent->m_globalTransformVector.m_pos;
 					l_data.luminance = l_lightComponents[i]->m_RGBColor * l_lightComponents[i]->m_LuminousFlux;
 					l_data.luminance.w = l_lightComponents[i]->m_Shape.x;
-					l_PointLightCB.emplace_back(l_data);
+					writeGPUBufferSlot(l_PointLightCB, l_pointLightCount++, l_data, sizeof(PointLightConstantBuffer), m_pointLightCBDirtySlots);
 				}
 				else if (l_lightComponents[i]->m_LightType == LightType::Sphere)
 				{
@@ -460,15 +563,393 @@ bool InnoRenderingFrontendNS::updateLightData()
 					l_data.pos = l_transformCompoent->m_globalTransformVector.m_pos;
 					l_data.luminance = l_lightComponents[i]->m_RGBColor * l_lightComponents[i]->m_LuminousFlux;
 					l_data.luminance.w = l_lightComponents[i]->m_Shape.x;
-					l_SphereLightCB.emplace_back(l_data);
+					writeGPUBufferSlot(l_SphereLightCB, l_sphereLightCount++, l_data, sizeof(SphereLightConstantBuffer), m_sphereLightCBDirtySlots);
 				}
 			}
 		}
 	}
 
+	l_PointLightCB.resize(l_pointLightCount);
+	l_SphereLightCB.resize(l_sphereLightCount);
+
+	generateDirtyRanges(m_pointLightCBDirtySlots);
+	generateDirtyRanges(m_sphereLightCBDirtySlots);
+
 	return true;
 }
 
+// Fold the UUID to 16 bits, a collision only makes two materials or meshes share a group in the sorted draw calls
+uint16_t InnoRenderingFrontendNS::getSortKeyID(uint64_t UUID)
+{
+	return (uint16_t)(UUID ^ (UUID >> 16) ^ (UUID >> 32) ^ (UUID >> 48));
+}
+
+// From the most significant bits:
+// Opaque and the others: pass (4) | shader (8) | material (16) | mesh (16) | channel (2) | depth (18), the state changes are minimized and the draws with the same states go front to back
+// Transparent: pass (4) | inverted depth (24) | shader (8) | material (16) | mesh (12), the draws go back to front
+// The pass is the visibility type, the shader is the texture slot mask which selects the sampling path of the opaque pass, the depth is the distance to the camera relative to the far plane
+// The channel is the culling channels, so the draws which could be instanced together are always adjacent
+uint64_t InnoRenderingFrontendNS::generateSortKey(const DrawCallInfo& drawCallInfo, uint32_t textureSlotMask, float depth)
+{
+	auto l_pass = (uint64_t)drawCallInfo.visibilityType & 0xF;
+	auto l_shader = (uint64_t)textureSlotMask & 0xFF;
+	auto l_material = (uint64_t)getSortKeyID(drawCallInfo.material->m_UUID);
+	auto l_mesh = (uint64_t)getSortKeyID(drawCallInfo.mesh->m_UUID);
+	auto l_channel = (uint64_t)(drawCallInfo.visibleInMainCamera ? 1 : 0) | (uint64_t)(drawCallInfo.castSunShadow ? 2 : 0);
+	auto l_depth = std::max(std::min(depth, 1.0f), 0.0f);
+
+	if (drawCallInfo.visibilityType == VisibilityType::Transparent)
+	{
+		auto l_invertedDepth = (uint64_t)((1.0f - l_depth) * (float)0xFFFFFF);
+		return (l_pass << 60) | (l_invertedDepth << 36) | (l_shader << 28) | (l_material << 12) | (l_mesh & 0xFFF);
+	}
+	else
+	{
+		auto l_quantizedDepth = (uint64_t)(l_depth * (float)0x3FFFF);
+		return (l_pass << 60) | (l_shader << 52) | (l_material << 36) | (l_mesh << 20) | (l_channel << 18) | l_quantizedDepth;
+	}
+}
+
+// The draw calls keep their constant buffer indices, so only the draw call list is reordered
+void InnoRenderingFrontendNS::sortDrawCalls(std::vector<DrawCallInfo>& drawCallInfo)
+{
+	auto l_drawCallCount = drawCallInfo.size();
+
+	m_drawCallSortKeys.resize(l_drawCallCount);
+	m_drawCallSortKeysScratch.resize(l_drawCallCount);
+	m_drawCallSortIndices.resize(l_drawCallCount);
+	m_drawCallSortIndicesScratch.resize(l_drawCallCount);
+
+	for (size_t i = 0; i < l_drawCallCount; i++)
+	{
+		m_drawCallSortKeys[i] = drawCallInfo[i].sortKey;
+		m_drawCallSortIndices[i] = (uint32_t)i;
+	}
+
+	InnoRadixSort::Sort(m_drawCallSortKeys.data(), m_drawCallSortIndices.data(), l_drawCallCount, m_drawCallSortKeysScratch.data(), m_drawCallSortIndicesScratch.data());
+
+	m_unsortedDrawCallInfo.swap(drawCallInfo);
+	drawCallInfo.resize(l_drawCallCount);
+
+	for (size_t i = 0; i < l_drawCallCount; i++)
+	{
+		drawCallInfo[i] = m_unsortedDrawCallInfo[m_drawCallSortIndices[i]];
+	}
+}
+
+// Write the value to the slot of the persistent GPU buffer, the slot is dirty if it's new or the first comparedSize bytes changed
+// The slot should be either an existing one or the next one at the end of the buffer
+template<typename T>
+void InnoRenderingFrontendNS::writeGPUBufferSlot(std::vector<T>& GPUBuffer, uint32_t slot, const T& value, size_t comparedSize, GPUBufferDirtySlots& dirtySlots)
+{
+	if (slot == GPUBuffer.size())
+	{
+		GPUBuffer.emplace_back(value);
+		dirtySlots.m_Slots.emplace_back(slot);
+	}
+	else if (std::memcmp(&GPUBuffer[slot], &value, comparedSize) != 0)
+	{
+		GPUBuffer[slot] = value;
+		dirtySlots.m_Slots.emplace_back(slot);
+	}
+}
+
+void InnoRenderingFrontendNS::generateDirtyRanges(GPUBufferDirtySlots& dirtySlots)
+{
+	dirtySlots.m_Ranges.clear();
+
+	if (dirtySlots.m_Slots.empty())
+	{
+		return;
+	}
+
+	std::sort(dirtySlots.m_Slots.begin(), dirtySlots.m_Slots.end());
+
+	GPUBufferDirtyRange l_range = { dirtySlots.m_Slots[0], 1 };
+
+	for (size_t i = 1; i < dirtySlots.m_Slots.size(); i++)
+	{
+		auto l_slot = dirtySlots.m_Slots[i];
+		auto l_rangeEnd = l_range.startOffset + l_range.elementCount;
+
+		if (l_slot < l_rangeEnd + m_dirtyRangeMergeDistance)
+		{
+			l_range.elementCount = std::max(l_rangeEnd, l_slot + 1) - l_range.startOffset;
+		}
+		else
+		{
+			dirtySlots.m_Ranges.emplace_back(l_range);
+			l_range = { l_slot, 1 };
+		}
+	}
+
+	dirtySlots.m_Ranges.emplace_back(l_range);
+}
+
+// Return the index of the material constant buffer, a new one is added for an unseen material, or UINT32_MAX if there is no space left
+uint32_t InnoRenderingFrontendNS::updateMaterialConstantBuffer(MaterialDataComponent* material, MeshUsageType meshUsageType, std::vector<MaterialConstantBuffer>& materialCBVector)
+{
+	MaterialConstantBuffer l_materialCB;
+
+	for (size_t i = 0; i < 8; i++)
+	{
+		uint32_t l_writeMask = material->m_TextureSlots[i].m_Activate ? 0x00000001 : 0x00000000;
+		l_writeMask = l_writeMask << i;
+		l_materialCB.textureSlotMask |= l_writeMask;
+	}
+	l_materialCB.materialType = int32_t(meshUsageType);
+	l_materialCB.customMaterial = material->m_meshCustomMaterial;
+
+	auto& l_materialCBIndices = m_materialCBIndices[(size_t)meshUsageType];
+	auto l_result = l_materialCBIndices.find(material);
+	uint32_t l_index;
+
+	if (l_result != l_materialCBIndices.end())
+	{
+		l_index = l_result->second;
+	}
+	else
+	{
+		if (materialCBVector.size() >= m_renderingCapability.maxMaterials)
+		{
+			InnoLogger::Log(LogLevel::Warning, "RenderingFrontend: Material constant buffer is full, the draw call is skipped!");
+			return UINT32_MAX;
+		}
+
+		l_index = (uint32_t)materialCBVector.size();
+		l_materialCBIndices.emplace(material, l_index);
+	}
+
+	writeGPUBufferSlot(materialCBVector, l_index, l_materialCB, offsetof(MaterialConstantBuffer, padding1), m_materialCBDirtySlots);
+
+	return l_index;
+}
+
+// Return the persistent slot of the object, a released or a new one is taken for an unseen object, or UINT32_MAX if there is no space left
+uint32_t InnoRenderingFrontendNS::getPerObjectConstantBufferSlot(PhysicsDataComponent* PDC, bool& isNewSlot)
+{
+	auto l_result = m_perObjectCBSlots.find(PDC);
+
+	if (l_result != m_perObjectCBSlots.end())
+	{
+		isNewSlot = false;
+		m_perObjectCBSlotLastUpdateIndices[l_result->second] = m_meshDataUpdateIndex;
+		return l_result->second;
+	}
+
+	uint32_t l_slot;
+
+	if (!m_perObjectCBFreeSlots.empty())
+	{
+		l_slot = m_perObjectCBFreeSlots.back();
+		m_perObjectCBFreeSlots.pop_back();
+	}
+	else if (m_perObjectCBSlotOwners.size() < m_renderingCapability.maxMeshes)
+	{
+		l_slot = (uint32_t)m_perObjectCBSlotOwners.size();
+		m_perObjectCBSlotOwners.emplace_back(nullptr);
+		m_perObjectCBSlotLastUpdateIndices.emplace_back(0);
+	}
+	else
+	{
+		InnoLogger::Log(LogLevel::Warning, "RenderingFrontend: Per-object constant buffer is full, the draw call is skipped!");
+		return UINT32_MAX;
+	}
+
+	isNewSlot = true;
+	m_perObjectCBSlots.emplace(PDC, l_slot);
+	m_perObjectCBSlotOwners[l_slot] = PDC;
+	m_perObjectCBSlotLastUpdateIndices[l_slot] = m_meshDataUpdateIndex;
+
+	return l_slot;
+}
+
+// The destroyed objects are never output again, so their slots are released after the lifetime as well
+void InnoRenderingFrontendNS::releaseUnusedPerObjectConstantBufferSlots()
+{
+	if (m_meshDataUpdateIndex < m_perObjectCBSlotLifetime)
+	{
+		return;
+	}
+
+	auto l_lastValidUpdateIndex = m_meshDataUpdateIndex - m_perObjectCBSlotLifetime;
+
+	for (uint32_t i = 0; i < (uint32_t)m_perObjectCBSlotOwners.size(); i++)
+	{
+		auto l_owner = m_perObjectCBSlotOwners[i];
+
+		if (l_owner && m_perObjectCBSlotLastUpdateIndices[i] < l_lastValidUpdateIndex)
+		{
+			m_perObjectCBSlots.erase(l_owner);
+			m_perObjectCBSlotOwners[i] = nullptr;
+			m_perObjectCBFreeSlots.emplace_back(i);
+		}
+	}
+}
+
+// Merge the adjacent sorted opaque draw calls with the same mesh, material and culling channels, and gather their per-object constant buffer slots in the draw order
+void InnoRenderingFrontendNS::generateInstancedDrawCalls(const std::vector<DrawCallInfo>& drawCallInfo)
+{
+	auto& l_instancedDrawCallInfoVector = m_instancedDrawCallInfoVector.GetValue();
+	auto& l_instanceIndices = m_instanceIndices.GetValue();
+	auto& l_instanceCBVector = m_instanceCBVector.GetValue();
+
+	l_instancedDrawCallInfoVector.clear();
+	l_instanceIndices.clear();
+	l_instanceCBVector.clear();
+
+	InstancedDrawCallInfo* l_currentDrawCall = nullptr;
+
+	for (auto& i : drawCallInfo)
+	{
+		if (i.visibilityType != VisibilityType::Opaque)
+		{
+			continue;
+		}
+
+		// The material constant buffer is shared by the same material and mesh usage type, so its index identifies both
+		auto l_canMerge = l_currentDrawCall != nullptr
+			&& l_currentDrawCall->mesh == i.mesh
+			&& l_currentDrawCall->materialConstantBufferIndex == i.materialConstantBufferIndex
+			&& l_currentDrawCall->visibleInMainCamera == i.visibleInMainCamera
+			&& l_currentDrawCall->castSunShadow == i.castSunShadow;
+
+		if (l_canMerge)
+		{
+			l_currentDrawCall->instanceCount++;
+			l_currentDrawCall->sunShadowCascadeMask |= i.sunShadowCascadeMask;
+		}
+		else
+		{
+			InstancedDrawCallInfo l_instancedDrawCallInfo;
+
+			l_instancedDrawCallInfo.mesh = i.mesh;
+			l_instancedDrawCallInfo.material = i.material;
+			l_instancedDrawCallInfo.instanceConstantBufferOffset = (uint32_t)l_instanceIndices.size();
+			l_instancedDrawCallInfo.instanceCount = 1;
+			l_instancedDrawCallInfo.materialConstantBufferIndex = i.materialConstantBufferIndex;
+			l_instancedDrawCallInfo.visibleInMainCamera = i.visibleInMainCamera;
+			l_instancedDrawCallInfo.castSunShadow = i.castSunShadow;
+			l_instancedDrawCallInfo.sunShadowCascadeMask = i.sunShadowCascadeMask;
+
+			l_instancedDrawCallInfoVector.emplace_back(l_instancedDrawCallInfo);
+			l_currentDrawCall = &l_instancedDrawCallInfoVector.back();
+
+			InstanceConstantBuffer l_instanceCB = {};
+			l_instanceCB.instanceOffset = l_instancedDrawCallInfo.instanceConstantBufferOffset;
+			l_instanceCBVector.emplace_back(l_instanceCB);
+		}
+
+		l_instanceIndices.emplace_back(i.meshConstantBufferIndex);
+	}
+}
+
+// Find the per-object and material constant buffer slots of every culling data, the lookup tables are not thread-safe so it runs before the parallel part
+void InnoRenderingFrontendNS::resolveMeshDataSlots(std::vector<PerObjectConstantBuffer>& perObjectCBVector, std::vector<MaterialConstantBuffer>& materialCBVector)
+{
+	auto l_cullingDataSize = m_cullingData->size();
+
+	m_meshDataUpdateIndex++;
+	releaseUnusedPerObjectConstantBufferSlots();
+
+	m_meshDataSlots.resize(l_cullingDataSize);
+	m_perObjectCBSlotClaimed.assign(m_renderingCapability.maxMeshes, 0);
+
+	for (size_t i = 0; i < l_cullingDataSize; i++)
+	{
+		auto& l_cullingData = (*m_cullingData)[i];
+		auto& l_meshDataSlot = m_meshDataSlots[i];
+
+		l_meshDataSlot = MeshDataSlot();
+
+		if (l_cullingData.mesh == nullptr || l_cullingData.material == nullptr)
+		{
+			continue;
+		}
+		if (l_cullingData.mesh->m_ObjectStatus != ObjectStatus::Activated)
+		{
+			continue;
+		}
+
+		bool l_isNewPerObjectCBSlot = false;
+		auto l_perObjectCBSlot = getPerObjectConstantBufferSlot(l_cullingData.PDC, l_isNewPerObjectCBSlot);
+		auto l_materialCBIndex = updateMaterialConstantBuffer(l_cullingData.material, l_cullingData.meshUsageType, materialCBVector);
+		if (l_perObjectCBSlot == UINT32_MAX || l_materialCBIndex == UINT32_MAX)
+		{
+			continue;
+		}
+
+		l_meshDataSlot.perObjectCBSlot = l_perObjectCBSlot;
+		l_meshDataSlot.materialCBIndex = l_materialCBIndex;
+
+		// Only the first culling data of the object writes the slot, the others are still drawn with it, a new or reused slot holds nothing of the object yet
+		if (!m_perObjectCBSlotClaimed[l_perObjectCBSlot])
+		{
+			m_perObjectCBSlotClaimed[l_perObjectCBSlot] = 1;
+			l_meshDataSlot.writeMode = l_isNewPerObjectCBSlot ? PerObjectCBWriteMode::Always : PerObjectCBWriteMode::IfChanged;
+		}
+	}
+
+	perObjectCBVector.resize(m_perObjectCBSlotOwners.size());
+}
+
+void InnoRenderingFrontendNS::generateMeshData(size_t begin, size_t end, const PerFrameConstantBuffer& perFrameCB, std::vector<PerObjectConstantBuffer>& perObjectCBVector, const std::vector<MaterialConstantBuffer>& materialCBVector)
+{
+	auto l_invZFar = perFrameCB.zFar > 0.0f ? 1.0f / perFrameCB.zFar : 0.0f;
+
+	for (auto i = begin; i < end; i++)
+	{
+		auto& l_cullingData = (*m_cullingData)[i];
+		auto& l_meshDataSlot = m_meshDataSlots[i];
+		auto& l_drawCallInfo = m_meshDataDrawCallInfo[i];
+
+		m_meshDataPerObjectCBDirtyFlags[i] = 0;
+
+		if (l_meshDataSlot.perObjectCBSlot == UINT32_MAX)
+		{
+			l_drawCallInfo.mesh = nullptr;
+			continue;
+		}
+
+		l_drawCallInfo.mesh = l_cullingData.mesh;
+		l_drawCallInfo.material = l_cullingData.material;
+		l_drawCallInfo.visibleInMainCamera = ((uint32_t)l_cullingData.cullingDataChannel & (uint32_t)CullingDataChannel::MainCamera) != 0;
+		l_drawCallInfo.castSunShadow = ((uint32_t)l_cullingData.cullingDataChannel & (uint32_t)CullingDataChannel::Shadow) != 0;
+		l_drawCallInfo.sunShadowCascadeMask = l_cullingData.shadowCascadeMask;
+		l_drawCallInfo.visibilityType = l_cullingData.visibilityType;
+		l_drawCallInfo.meshConstantBufferIndex = l_meshDataSlot.perObjectCBSlot;
+		l_drawCallInfo.materialConstantBufferIndex = l_meshDataSlot.materialCBIndex;
+
+#ifdef USE_COLUMN_MAJOR_MEMORY_LAYOUT
+		auto l_position = Vec4(l_cullingData.m.m30, l_cullingData.m.m31, l_cullingData.m.m32, 1.0f);
+#endif
+#ifdef USE_ROW_MAJOR_MEMORY_LAYOUT
+		auto l_position = Vec4(l_cullingData.m.m03, l_cullingData.m.m13, l_cullingData.m.m23, 1.0f);
+#endif
+		auto l_depth = (l_position - perFrameCB.camera_posWS).length() * l_invZFar;
+		l_drawCallInfo.sortKey = generateSortKey(l_drawCallInfo, materialCBVector[l_meshDataSlot.materialCBIndex].textureSlotMask, l_depth);
+
+		if (l_meshDataSlot.writeMode == PerObjectCBWriteMode::None)
+		{
+			continue;
+		}
+
+		auto& l_slot = perObjectCBVector[l_meshDataSlot.perObjectCBSlot];
+
+		PerObjectConstantBuffer l_perObjectCB = {};
+		l_perObjectCB.m = l_cullingData.m;
+		l_perObjectCB.m_prev = l_cullingData.m_prev;
+		l_perObjectCB.normalMat = l_cullingData.normalMat;
+		l_perObjectCB.UUID = (float)l_cullingData.UUID;
+
+		if (l_meshDataSlot.writeMode == PerObjectCBWriteMode::Always || std::memcmp(&l_slot, &l_perObjectCB, offsetof(PerObjectConstantBuffer, padding)) != 0)
+		{
+			l_slot = l_perObjectCB;
+			m_meshDataPerObjectCBDirtyFlags[i] = 1;
+		}
+	}
+}
+
 bool InnoRenderingFrontendNS::updateMeshData()
 {
 	auto& l_drawCallInfoVector = m_drawCallInfoVector.GetValue();
@@ -476,55 +957,41 @@ bool InnoRenderingFrontendNS::updateMeshData()
 	auto& l_materialCBVector = m_materialCBVector.GetValue();
 
 	l_drawCallInfoVector.clear();
-	l_perObjectCBVector.clear();
-	l_materialCBVector.clear();
 
-	auto l_cullingDataSize = m_cullingData.size();
+	m_perObjectCBDirtySlots.m_Slots.clear();
+	m_materialCBDirtySlots.m_Slots.clear();
+
+	auto l_perFrameCB = m_perFrameCB.GetValue();
+	auto l_cullingDataSize = m_cullingData->size();
+
+	resolveMeshDataSlots(l_perObjectCBVector, l_materialCBVector);
+
+	m_meshDataDrawCallInfo.resize(l_cullingDataSize);
+	m_meshDataPerObjectCBDirtyFlags.resize(l_cullingDataSize);
+
+	g_pModuleManager->getTaskSystem()->parallelFor("MeshDataTask", l_cullingDataSize, m_meshDataGrainSize, [&](size_t begin, size_t end)
+	{
+		generateMeshData(begin, end, l_perFrameCB, l_perObjectCBVector, l_materialCBVector);
+	});
 
+	// Compact the results in the culling data order, so the draw calls are the same as a serial update
 	for (size_t i = 0; i < l_cullingDataSize; i++)
 	{
-		auto l_cullingData = m_cullingData[i];
-		if (l_cullingData.mesh != nullptr)
+		if (m_meshDataDrawCallInfo[i].mesh != nullptr)
 		{
-			if (l_cullingData.mesh->m_ObjectStatus == ObjectStatus::Activated)
-			{
-				if (l_cullingData.material != nullptr)
-				{
-					DrawCallInfo l_drawCallInfo;
-
-					l_drawCallInfo.mesh = l_cullingData.mesh;
-					l_drawCallInfo.material = l_cullingData.material;
-					// @TODO: use culled info
-					l_drawCallInfo.castSunShadow = true;
-					l_drawCallInfo.visibilityType = l_cullingData.visibilityType;
-					l_drawCallInfo.meshConstantBufferIndex = (uint32_t)i;
-					l_drawCallInfo.materialConstantBufferIndex = (uint32_t)i;
-
-					PerObjectConstantBuffer l_perObjectCB;
-					l_perObjectCB.m = l_cullingData.m;
-					l_perObjectCB.m_prev = l_cullingData.m_prev;
-					l_perObjectCB.normalMat = l_cullingData.normalMat;
-					l_perObjectCB.UUID = (float)l_cullingData.UUID;
-
-					MaterialConstantBuffer l_materialCB;
-
-					for (size_t i = 0; i < 8; i++)
-					{
-						uint32_t l_writeMask = l_drawCallInfo.material->m_TextureSlots[i].m_Activate ? 0x00000001 : 0x00000000;
-						l_writeMask = l_writeMask << i;
-						l_materialCB.textureSlotMask |= l_writeMask;
-					}
-					l_materialCB.materialType = int32_t(l_cullingData.meshUsageType);
-					l_materialCB.customMaterial = l_cullingData.material->m_meshCustomMaterial;
-
-					l_drawCallInfoVector.emplace_back(l_drawCallInfo);
-					l_perObjectCBVector.emplace_back(l_perObjectCB);
-					l_materialCBVector.emplace_back(l_materialCB);
-				}
-			}
+			l_drawCallInfoVector.emplace_back(m_meshDataDrawCallInfo[i]);
+		}
+		if (m_meshDataPerObjectCBDirtyFlags[i])
+		{
+			m_perObjectCBDirtySlots.m_Slots.emplace_back(m_meshDataSlots[i].perObjectCBSlot);
 		}
 	}
 
+	sortDrawCalls(l_drawCallInfoVector);
+	generateInstancedDrawCalls(l_drawCallInfoVector);
+	generateDirtyRanges(m_perObjectCBDirtySlots);
+	generateDirtyRanges(m_materialCBDirtySlots);
+
 	// @TODO: use GPU to do OIT
 
 	return true;
@@ -559,15 +1026,14 @@ bool InnoRenderingFrontendNS::updateBillboardPassData()
 	l_pointLightPerObjectCB.clear();
 	l_sphereLightPerObjectCB.clear();
 
-	for (auto i : l_lightComponents)
+	m_lightComponentQuery.Update(g_pModuleManager->getSceneHierarchyManager());
+
+	for (auto& l_tuple : m_lightComponentQuery.GetTuples())
 	{
-		PerObjectConstantBuffer l_meshCB;
+		auto [i, l_transformCompoent] = l_tuple;
 
-		auto l_transformCompoent = GetComponent(TransformComponent, i->m_ParentEntity);
-		if (l_transformCompoent != nullptr)
-		{
-			l_meshCB.m = InnoMath::toTranslationMatrix(l_transformCompoent->m_globalTransformVector.m_pos);
-		}
+		PerObjectConstantBuffer l_meshCB;
+		l_meshCB.m = InnoMath::toTranslationMatrix(l_transformCompoent->m_globalTransformVector.m_pos);
 
 		switch (i->m_LightType)
 		{
@@ -618,18 +1084,32 @@ bool InnoRenderingFrontendNS::update()
 {
 	if (m_ObjectStatus == ObjectStatus::Activated)
 	{
-		updatePerFrameConstantBuffer();
-
-		updateLightData();
-
-		// copy culling data pack for local scope
-		m_cullingData = g_pModuleManager->getPhysicsSystem()->getCullingData();
+		// The stages only read the shared scene data and write their own outputs, the mesh data needs the camera in the per-frame constant buffer
+		std::function<void()> l_stages[] =
+		{
+			[]()
+			{
+				updatePerFrameConstantBuffer();
 
-		updateMeshData();
+				m_cullingData = g_pModuleManager->getPhysicsSystem()->getCullingData();
 
-		updateBillboardPassData();
+				updateMeshData();
+			},
+			[]() { updateLightData(); },
+			[]()
+			{
+				updateBillboardPassData();
+				updateDebuggerPassData();
+			}
+		};
 
-		updateDebuggerPassData();
+		g_pModuleManager->getTaskSystem()->parallelFor("RenderingFrontendUpdateTask", 3, 1, [&](size_t begin, size_t end)
+		{
+			for (auto i = begin; i < end; i++)
+			{
+				l_stages[i]();
+			}
+		});
 
 		return true;
 	}
@@ -888,6 +1368,41 @@ const std::vector<MaterialConstantBuffer>& InnoRenderingFrontend::getMaterialCon
 	return m_materialCBVector.GetValue();
 }
 
+const std::vector<GPUBufferDirtyRange>& InnoRenderingFrontend::getPointLightConstantBufferDirtyRanges()
+{
+	return m_pointLightCBDirtySlots.m_Ranges;
+}
+
+const std::vector<GPUBufferDirtyRange>& InnoRenderingFrontend::getSphereLightConstantBufferDirtyRanges()
+{
+	return m_sphereLightCBDirtySlots.m_Ranges;
+}
+
+const std::vector<GPUBufferDirtyRange>& InnoRenderingFrontend::getPerObjectConstantBufferDirtyRanges()
+{
+	return m_perObjectCBDirtySlots.m_Ranges;
+}
+
+const std::vector<GPUBufferDirtyRange>& InnoRenderingFrontend::getMaterialConstantBufferDirtyRanges()
+{
+	return m_materialCBDirtySlots.m_Ranges;
+}
+
+const std::vector<InstancedDrawCallInfo>& InnoRenderingFrontend::getInstancedDrawCallInfo()
+{
+	return m_instancedDrawCallInfoVector.GetValue();
+}
+
+const std::vector<uint32_t>& InnoRenderingFrontend::getInstanceIndices()
+{
+	return m_instanceIndices.GetValue();
+}
+
+const std::vector<InstanceConstantBuffer>& InnoRenderingFrontend::getInstanceConstantBuffer()
+{
+	return m_instanceCBVector.GetValue();
+}
+
 const std::vector<BillboardPassDrawCallInfo>& InnoRenderingFrontend::getBillboardPassDrawCallInfo()
 {
 	return m_billboardPassDrawCallInfoVector.GetValue();
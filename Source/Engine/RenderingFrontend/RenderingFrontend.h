@@ -44,10 +44,18 @@ public:
 	const std::vector<CSMConstantBuffer>& getCSMConstantBuffer() override;
 	const std::vector<PointLightConstantBuffer>& getPointLightConstantBuffer() override;
 	const std::vector<SphereLightConstantBuffer>& getSphereLightConstantBuffer() override;
+	const std::vector<GPUBufferDirtyRange>& getPointLightConstantBufferDirtyRanges() override;
+	const std::vector<GPUBufferDirtyRange>& getSphereLightConstantBufferDirtyRanges() override;
 
 	const std::vector<DrawCallInfo>& getDrawCallInfo() override;
 	const std::vector<PerObjectConstantBuffer>& getPerObjectConstantBuffer() override;
 	const std::vector<MaterialConstantBuffer>& getMaterialConstantBuffer() override;
+	const std::vector<GPUBufferDirtyRange>& getPerObjectConstantBufferDirtyRanges() override;
+	const std::vector<GPUBufferDirtyRange>& getMaterialConstantBufferDirtyRanges() override;
+
+	const std::vector<InstancedDrawCallInfo>& getInstancedDrawCallInfo() override;
+	const std::vector<uint32_t>& getInstanceIndices() override;
+	const std::vector<InstanceConstantBuffer>& getInstanceConstantBuffer() override;
 
 	const std::vector<BillboardPassDrawCallInfo>& getBillboardPassDrawCallInfo() override;
 	const std::vector<PerObjectConstantBuffer>& getBillboardPassPerObjectConstantBuffer() override;
@@ -796,6 +796,15 @@ bool DX11RenderingServer::InitializeGPUBufferDataComponent(GPUBufferDataComponen
 	l_rhs->m_BufferDesc.MiscFlags = l_isStructuredBuffer ? D3D11_RESOURCE_MISC_BUFFER_STRUCTURED : 0;
 	l_rhs->m_BufferDesc.StructureByteStride = l_isStructuredBuffer ? (uint32_t)l_rhs->m_ElementSize : 0;
 
+	if (!l_isStructuredBuffer)
+	{
+		l_rhs->m_CPUData.resize(l_rhs->m_TotalSize);
+		if (l_rhs->m_InitialData)
+		{
+			std::memcpy(l_rhs->m_CPUData.data(), l_rhs->m_InitialData, l_rhs->m_TotalSize);
+		}
+	}
+
 	HRESULT l_HResult;
 
 	if (l_rhs->m_InitialData)
@@ -1062,7 +1071,69 @@ bool DX11RenderingServer::UploadGPUBufferDataComponentImpl(GPUBufferDataComponen
 		l_size = range * l_rhs->m_ElementSize;
 	}
 
-	std::memcpy(l_dataPtr + startOffset * l_rhs->m_ElementSize, GPUBufferValue, l_size);
+	if (l_mapMethod == D3D11_MAP_WRITE_DISCARD)
+	{
+		// The discarded buffer is a new one, the range is merged into the CPU copy and the whole content is uploaded
+		std::memcpy(l_rhs->m_CPUData.data() + startOffset * l_rhs->m_ElementSize, GPUBufferValue, l_size);
+		std::memcpy(l_dataPtr, l_rhs->m_CPUData.data(), l_rhs->m_TotalSize);
+		m_UploadedBytes += l_rhs->m_TotalSize - l_size;
+	}
+	else
+	{
+		std::memcpy(l_dataPtr + startOffset * l_rhs->m_ElementSize, GPUBufferValue, l_size);
+	}
+
+	m_deviceContext->Unmap(l_rhs->m_BufferPtr, 0);
+
+	return true;
+}
+
+bool DX11RenderingServer::UploadGPUBufferDataComponentRangesImpl(GPUBufferDataComponent* rhs, const void* GPUBufferValue, const std::vector<GPUBufferDirtyRange>& dirtyRanges)
+{
+	if (dirtyRanges.empty())
+	{
+		return true;
+	}
+
+	auto l_rhs = reinterpret_cast<DX11GPUBufferDataComponent*>(rhs);
+
+	auto l_mapMethod = l_rhs->m_GPUAccessibility == Accessibility::ReadOnly ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE;
+
+	D3D11_MAPPED_SUBRESOURCE l_MappedResource;
+
+	auto l_HResult = m_deviceContext->Map(l_rhs->m_BufferPtr, 0, l_mapMethod, 0, &l_MappedResource);
+	if (FAILED(l_HResult))
+	{
+		InnoLogger::Log(LogLevel::Error, "DX11RenderingServer: Can't lock GPU Buffer!");
+		return false;
+	}
+
+	auto l_dataPtr = (char*)l_MappedResource.pData;
+	size_t l_dirtySize = 0;
+
+	for (auto& i : dirtyRanges)
+	{
+		auto l_offset = i.startOffset * l_rhs->m_ElementSize;
+		auto l_size = i.elementCount * l_rhs->m_ElementSize;
+
+		if (l_mapMethod == D3D11_MAP_WRITE_DISCARD)
+		{
+			std::memcpy(l_rhs->m_CPUData.data() + l_offset, (const char*)GPUBufferValue + l_offset, l_size);
+		}
+		else
+		{
+			std::memcpy(l_dataPtr + l_offset, (const char*)GPUBufferValue + l_offset, l_size);
+		}
+
+		l_dirtySize += l_size;
+	}
+
+	// All the ranges are merged into the CPU copy first, so the discarded buffer is rewritten only once
+	if (l_mapMethod == D3D11_MAP_WRITE_DISCARD)
+	{
+		std::memcpy(l_dataPtr, l_rhs->m_CPUData.data(), l_rhs->m_TotalSize);
+		m_UploadedBytes += l_rhs->m_TotalSize - l_dirtySize;
+	}
 
 	m_deviceContext->Unmap(l_rhs->m_BufferPtr, 0);
 
@@ -36,6 +36,7 @@ public:
 	bool DeleteGPUBufferDataComponent(GPUBufferDataComponent * rhs) override;
 
 	bool UploadGPUBufferDataComponentImpl(GPUBufferDataComponent * rhs, const void * GPUBufferValue, size_t startOffset, size_t range) override;
+	bool UploadGPUBufferDataComponentRangesImpl(GPUBufferDataComponent* rhs, const void* GPUBufferValue, const std::vector<GPUBufferDirtyRange>& dirtyRanges) override;
 
 	bool CommandListBegin(RenderPassDataComponent * rhs, size_t frameIndex) override;
 	bool BindRenderPassDataComponent(RenderPassDataComponent * rhs) override;
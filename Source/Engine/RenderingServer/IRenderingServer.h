@@ -1,6 +1,7 @@
 #pragma once
 #include "../Common/InnoType.h"
 #include "../Common/InnoClassTemplate.h"
+#include <atomic>
 
 #include "../Component/MeshDataComponent.h"
 #include "../Component/TextureDataComponent.h"
@@ -9,6 +10,19 @@
 #include "../Component/ShaderProgramComponent.h"
 #include "../Component/SamplerDataComponent.h"
 #include "../Component/GPUBufferDataComponent.h"
+#include "../Common/GPUDataStructure.h"
+
+enum class RenderingCommandType { BindRenderPass, CleanRenderTargets, ActivateResourceBinder, DeactivateResourceBinder, DrawCall, DispatchCompute, Upload, Copy, Count };
+
+struct RenderPassStatistics
+{
+	// Empty for the GPU buffer uploads, which don't belong to any render pass
+	std::string m_Name;
+	size_t m_CommandCount[(size_t)RenderingCommandType::Count] = {};
+	size_t m_Bytes[(size_t)RenderingCommandType::Count] = {};
+	size_t m_InstanceCount = 0;
+	size_t m_ThreadGroupCount = 0;
+};
 
 class IRenderingServer
 {
@@ -47,18 +61,48 @@ public:
 
 	virtual bool UploadGPUBufferDataComponentImpl(GPUBufferDataComponent * rhs, const void * GPUBufferValue, size_t startOffset, size_t range) = 0;
 
+	// GPUBufferValue points to the data of the first uploaded element
 	template<typename T>
 	bool UploadGPUBufferDataComponent(GPUBufferDataComponent* rhs, const T* GPUBufferValue, size_t startOffset = 0, size_t range = SIZE_MAX)
 	{
+		m_UploadedBytes += (range == SIZE_MAX) ? rhs->m_TotalSize : range * rhs->m_ElementSize;
 		return UploadGPUBufferDataComponentImpl(rhs, GPUBufferValue, startOffset, range);
 	}
 
+	// The elements in [startOffset, startOffset + range) of the vector are uploaded to the same elements of the GPU buffer
 	template<typename T>
 	bool UploadGPUBufferDataComponent(GPUBufferDataComponent* rhs, const std::vector<T>& GPUBufferValue, size_t startOffset = 0, size_t range = SIZE_MAX)
 	{
-		return UploadGPUBufferDataComponentImpl(rhs, &GPUBufferValue[0], startOffset, range);
+		return UploadGPUBufferDataComponent(rhs, &GPUBufferValue[startOffset], startOffset, range);
+	}
+
+	// The elements in the dirty ranges of the vector are uploaded to the same elements of the GPU buffer, the servers which rewrite the whole buffer on every upload do it once for all the ranges
+	template<typename T>
+	bool UploadGPUBufferDataComponent(GPUBufferDataComponent* rhs, const std::vector<T>& GPUBufferValue, const std::vector<GPUBufferDirtyRange>& dirtyRanges)
+	{
+		for (auto& i : dirtyRanges)
+		{
+			m_UploadedBytes += i.elementCount * rhs->m_ElementSize;
+		}
+		return UploadGPUBufferDataComponentRangesImpl(rhs, GPUBufferValue.data(), dirtyRanges);
+	}
+
+	// GPUBufferValue points to the data of the first element of the buffer
+	virtual bool UploadGPUBufferDataComponentRangesImpl(GPUBufferDataComponent* rhs, const void* GPUBufferValue, const std::vector<GPUBufferDirtyRange>& dirtyRanges)
+	{
+		for (auto& i : dirtyRanges)
+		{
+			if (!UploadGPUBufferDataComponentImpl(rhs, (const char*)GPUBufferValue + i.startOffset * rhs->m_ElementSize, i.startOffset, i.elementCount))
+			{
+				return false;
+			}
+		}
+		return true;
 	}
 
+	// The total bytes uploaded since the start, the difference between two frames is the upload size of the frame
+	size_t GetUploadedBytes() { return m_UploadedBytes; }
+
 	virtual bool CommandListBegin(RenderPassDataComponent * rhs, size_t frameIndex) = 0;
 	virtual bool BindRenderPassDataComponent(RenderPassDataComponent * rhs) = 0;
 	virtual bool CleanRenderTargets(RenderPassDataComponent * rhs) = 0;
@@ -82,4 +126,12 @@ public:
 	virtual std::vector<Vec4> ReadTextureBackToCPU(RenderPassDataComponent* canvas, TextureDataComponent* TDC) = 0;
 
 	virtual bool Resize() = 0;
+
+	// The render passes in the execution order of the last presented frame, the uploads of the frame are the last element
+	// Only the servers which record their commands on CPU have them
+	virtual std::vector<RenderPassStatistics> GetRenderPassStatistics() { return {}; }
+
+protected:
+	// The uploads could come from the rendering frontend and the rendering server threads
+	std::atomic<size_t> m_UploadedBytes = 0;
 };
@@ -0,0 +1,633 @@
+#include "NullRenderingServer.h"
+
+#include "../../Interface/IModuleManager.h"
+
+extern IModuleManager* g_pModuleManager;
+
+#include "../../Core/InnoLogger.h"
+#include "../../Core/InnoMemory.h"
+
+namespace NullRenderingServerNS
+{
+	class NullResourceBinder : public IResourceBinder
+	{
+	public:
+		TextureDataComponent* m_Texture = 0;
+	};
+
+	template<typename T>
+	T* addComponent(IObjectPool* componentPool, const char* name, const char* typeName, ComponentType componentType, std::atomic<uint32_t>& count);
+
+	NullResourceBinder* addResourceBinder(ResourceBinderType resourceBinderType);
+
+	size_t getTextureSize(const TextureDesc& textureDesc);
+	size_t getResourceBinderSize(IResourceBinder* binder, size_t elementCount);
+	size_t getRenderTargetsSize(RenderPassDataComponent* renderPass);
+	bool record(RenderPassDataComponent* renderPass, RenderingCommandType type, size_t count, size_t bytes);
+
+	ObjectStatus m_ObjectStatus = ObjectStatus::Terminated;
+
+	IObjectPool* m_MeshDataComponentPool = 0;
+	IObjectPool* m_MaterialDataComponentPool = 0;
+	IObjectPool* m_TextureDataComponentPool = 0;
+	IObjectPool* m_RenderPassDataComponentPool = 0;
+	IObjectPool* m_ResourcesBinderPool = 0;
+	IObjectPool* m_PSOPool = 0;
+	IObjectPool* m_ShaderProgramComponentPool = 0;
+	IObjectPool* m_SamplerDataComponentPool = 0;
+	IObjectPool* m_GPUBufferDataComponentPool = 0;
+
+	std::atomic<uint32_t> m_MeshDataComponentCount = 0;
+	std::atomic<uint32_t> m_TextureDataComponentCount = 0;
+	std::atomic<uint32_t> m_MaterialDataComponentCount = 0;
+	std::atomic<uint32_t> m_RenderPassDataComponentCount = 0;
+	std::atomic<uint32_t> m_ShaderProgramComponentCount = 0;
+	std::atomic<uint32_t> m_SamplerDataComponentCount = 0;
+	std::atomic<uint32_t> m_GPUBufferDataComponentCount = 0;
+
+	// The render passes record on the rendering thread, but the uploads and the statistics queries could come from any thread
+	std::mutex m_CommandMutex;
+	std::unordered_map<RenderPassDataComponent*, std::vector<NullRenderingCommand>> m_CommandLists;
+	std::vector<NullRenderingCommand> m_UploadCommands;
+	std::vector<RenderPassStatistics> m_CurrentFrameStatistics;
+	std::vector<RenderPassStatistics> m_LastFrameStatistics;
+}
+
+using namespace NullRenderingServerNS;
+
+template<typename T>
+T* NullRenderingServerNS::addComponent(IObjectPool* componentPool, const char* name, const char* typeName, ComponentType componentType, std::atomic<uint32_t>& count)
+{
+	auto l_index = ++count;
+	auto l_result = InnoMemory::Spawn<T>(componentPool);
+
+	std::string l_name;
+	if (strcmp(name, ""))
+	{
+		l_name = name;
+	}
+	else
+	{
+		l_name = (std::string(typeName) + "_" + std::to_string(l_index) + "/");
+	}
+
+	auto l_parentEntity = g_pModuleManager->getEntityManager()->Spawn(ObjectSource::Runtime, ObjectOwnership::Engine, l_name.c_str());
+	l_result->m_ParentEntity = l_parentEntity;
+	l_result->m_ComponentName = l_name.c_str();
+	l_result->m_ObjectSource = ObjectSource::Runtime;
+	l_result->m_ObjectOwnership = ObjectOwnership::Engine;
+	l_result->m_ComponentType = componentType;
+
+	return l_result;
+}
+
+NullResourceBinder* NullRenderingServerNS::addResourceBinder(ResourceBinderType resourceBinderType)
+{
+	auto l_result = InnoMemory::Spawn<NullResourceBinder>(m_ResourcesBinderPool);
+	l_result->m_ResourceBinderType = resourceBinderType;
+
+	return l_result;
+}
+
+size_t NullRenderingServerNS::getTextureSize(const TextureDesc& textureDesc)
+{
+	size_t l_singlePixelSize = 4;
+
+	switch (textureDesc.PixelDataType)
+	{
+	case TexturePixelDataType::UBYTE:l_singlePixelSize = 1; break;
+	case TexturePixelDataType::SBYTE:l_singlePixelSize = 1; break;
+	case TexturePixelDataType::USHORT:l_singlePixelSize = 2; break;
+	case TexturePixelDataType::SSHORT:l_singlePixelSize = 2; break;
+	case TexturePixelDataType::UINT8:l_singlePixelSize = 1; break;
+	case TexturePixelDataType::SINT8:l_singlePixelSize = 1; break;
+	case TexturePixelDataType::UINT16:l_singlePixelSize = 2; break;
+	case TexturePixelDataType::SINT16:l_singlePixelSize = 2; break;
+	case TexturePixelDataType::UINT32:l_singlePixelSize = 4; break;
+	case TexturePixelDataType::SINT32:l_singlePixelSize = 4; break;
+	case TexturePixelDataType::FLOAT16:l_singlePixelSize = 2; break;
+	case TexturePixelDataType::FLOAT32:l_singlePixelSize = 4; break;
+	case TexturePixelDataType::DOUBLE:l_singlePixelSize = 8; break;
+	}
+
+	size_t l_channelSize = 4;
+	switch (textureDesc.PixelDataFormat)
+	{
+	case TexturePixelDataFormat::R:l_channelSize = 1; break;
+	case TexturePixelDataFormat::RG:l_channelSize = 2; break;
+	case TexturePixelDataFormat::RGB:l_channelSize = 3; break;
+	case TexturePixelDataFormat::RGBA:l_channelSize = 4; break;
+	case TexturePixelDataFormat::BGRA:l_channelSize = 4; break;
+	case TexturePixelDataFormat::Depth:l_channelSize = 1; break;
+	case TexturePixelDataFormat::DepthStencil:l_channelSize = 1; break;
+	}
+
+	size_t l_pixelCount = std::max(textureDesc.Width, 1u);
+
+	switch (textureDesc.SamplerType)
+	{
+	case TextureSamplerType::Sampler1D: break;
+	case TextureSamplerType::Sampler1DArray:
+	case TextureSamplerType::Sampler2D: l_pixelCount *= std::max(textureDesc.Height, 1u); break;
+	case TextureSamplerType::SamplerCubemap: l_pixelCount *= std::max(textureDesc.Height, 1u) * 6; break;
+	default: l_pixelCount *= std::max(textureDesc.Height, 1u) * std::max(textureDesc.DepthOrArraySize, 1u); break;
+	}
+
+	return l_pixelCount * l_singlePixelSize * l_channelSize;
+}
+
+size_t NullRenderingServerNS::getResourceBinderSize(IResourceBinder* binder, size_t elementCount)
+{
+	if (binder == nullptr)
+	{
+		return 0;
+	}
+
+	switch (binder->m_ResourceBinderType)
+	{
+	case ResourceBinderType::Buffer:
+		return elementCount == SIZE_MAX ? binder->m_TotalSize : std::min(elementCount * binder->m_ElementSize, binder->m_TotalSize);
+	case ResourceBinderType::Image:
+	{
+		auto l_texture = reinterpret_cast<NullResourceBinder*>(binder)->m_Texture;
+		return l_texture ? getTextureSize(l_texture->m_TextureDesc) : 0;
+	}
+	default:
+		return 0;
+	}
+}
+
+size_t NullRenderingServerNS::getRenderTargetsSize(RenderPassDataComponent* renderPass)
+{
+	size_t l_result = 0;
+
+	for (auto i : renderPass->m_RenderTargets)
+	{
+		l_result += getTextureSize(i->m_TextureDesc);
+	}
+
+	if (renderPass->m_DepthStencilRenderTarget)
+	{
+		l_result += getTextureSize(renderPass->m_DepthStencilRenderTarget->m_TextureDesc);
+	}
+
+	return l_result;
+}
+
+bool NullRenderingServerNS::record(RenderPassDataComponent* renderPass, RenderingCommandType type, size_t count, size_t bytes)
+{
+	NullRenderingCommand l_command;
+	l_command.m_Type = type;
+	l_command.m_Count = count;
+	l_command.m_Bytes = bytes;
+
+	std::lock_guard<std::mutex> lock{ m_CommandMutex };
+
+	if (renderPass)
+	{
+		m_CommandLists[renderPass].emplace_back(l_command);
+	}
+	else
+	{
+		m_UploadCommands.emplace_back(l_command);
+	}
+
+	return true;
+}
+
+std::vector<NullRenderingCommand> NullRenderingServer::GetCommands(RenderPassDataComponent * rhs)
+{
+	std::lock_guard<std::mutex> lock{ m_CommandMutex };
+
+	auto l_result = m_CommandLists.find(rhs);
+	if (l_result == m_CommandLists.end())
+	{
+		return {};
+	}
+
+	return l_result->second;
+}
+
+std::vector<RenderPassStatistics> NullRenderingServer::GetRenderPassStatistics()
+{
+	std::lock_guard<std::mutex> lock{ m_CommandMutex };
+
+	return m_LastFrameStatistics;
+}
+
+bool NullRenderingServer::Setup()
+{
+	auto l_renderingCapability = g_pModuleManager->getRenderingFrontend()->getRenderingCapability();
+
+	m_MeshDataComponentPool = InnoMemory::CreateObjectPool<MeshDataComponent>(l_renderingCapability.maxMeshes);
+	m_TextureDataComponentPool = InnoMemory::CreateObjectPool<TextureDataComponent>(l_renderingCapability.maxTextures);
+	m_MaterialDataComponentPool = InnoMemory::CreateObjectPool<MaterialDataComponent>(l_renderingCapability.maxMaterials);
+	m_RenderPassDataComponentPool = InnoMemory::CreateObjectPool<RenderPassDataComponent>(128);
+	m_ResourcesBinderPool = InnoMemory::CreateObjectPool<NullResourceBinder>(16384);
+	m_PSOPool = InnoMemory::CreateObjectPool<IPipelineStateObject>(128);
+	m_ShaderProgramComponentPool = InnoMemory::CreateObjectPool<ShaderProgramComponent>(256);
+	m_SamplerDataComponentPool = InnoMemory::CreateObjectPool<SamplerDataComponent>(256);
+	m_GPUBufferDataComponentPool = InnoMemory::CreateObjectPool<GPUBufferDataComponent>(256);
+
+	m_ObjectStatus = ObjectStatus::Created;
+	InnoLogger::Log(LogLevel::Success, "NullRenderingServer setup finished.");
+
+	return true;
+}
+
+bool NullRenderingServer::Initialize()
+{
+	if (m_ObjectStatus == ObjectStatus::Created)
+	{
+		m_ObjectStatus = ObjectStatus::Activated;
+		InnoLogger::Log(LogLevel::Success, "NullRenderingServer has been initialized.");
+	}
+
+	return true;
+}
+
+bool NullRenderingServer::Terminate()
+{
+	m_ObjectStatus = ObjectStatus::Terminated;
+	InnoLogger::Log(LogLevel::Success, "NullRenderingServer has been terminated.");
+
+	return true;
+}
+
+ObjectStatus NullRenderingServer::GetStatus()
+{
+	return m_ObjectStatus;
+}
+
+MeshDataComponent * NullRenderingServer::AddMeshDataComponent(const char * name)
+{
+	return addComponent<MeshDataComponent>(m_MeshDataComponentPool, name, "Mesh", ComponentType::MeshDataComponent, m_MeshDataComponentCount);
+}
+
+TextureDataComponent * NullRenderingServer::AddTextureDataComponent(const char * name)
+{
+	return addComponent<TextureDataComponent>(m_TextureDataComponentPool, name, "Texture", ComponentType::TextureDataComponent, m_TextureDataComponentCount);
+}
+
+MaterialDataComponent * NullRenderingServer::AddMaterialDataComponent(const char * name)
+{
+	return addComponent<MaterialDataComponent>(m_MaterialDataComponentPool, name, "Material", ComponentType::MaterialDataComponent, m_MaterialDataComponentCount);
+}
+
+RenderPassDataComponent * NullRenderingServer::AddRenderPassDataComponent(const char * name)
+{
+	return addComponent<RenderPassDataComponent>(m_RenderPassDataComponentPool, name, "RenderPass", ComponentType::RenderPassDataComponent, m_RenderPassDataComponentCount);
+}
+
+ShaderProgramComponent * NullRenderingServer::AddShaderProgramComponent(const char * name)
+{
+	return addComponent<ShaderProgramComponent>(m_ShaderProgramComponentPool, name, "ShaderProgram", ComponentType::ShaderProgramComponent, m_ShaderProgramComponentCount);
+}
+
+SamplerDataComponent * NullRenderingServer::AddSamplerDataComponent(const char * name)
+{
+	return addComponent<SamplerDataComponent>(m_SamplerDataComponentPool, name, "SamplerData", ComponentType::SamplerDataComponent, m_SamplerDataComponentCount);
+}
+
+GPUBufferDataComponent * NullRenderingServer::AddGPUBufferDataComponent(const char * name)
+{
+	return addComponent<GPUBufferDataComponent>(m_GPUBufferDataComponentPool, name, "GPUBufferData", ComponentType::GPUBufferDataComponent, m_GPUBufferDataComponentCount);
+}
+
+bool NullRenderingServer::InitializeMeshDataComponent(MeshDataComponent * rhs)
+{
+	rhs->m_ObjectStatus = ObjectStatus::Activated;
+
+	return true;
+}
+
+bool NullRenderingServer::InitializeTextureDataComponent(TextureDataComponent * rhs)
+{
+	if (rhs->m_ObjectStatus == ObjectStatus::Activated)
+	{
+		return true;
+	}
+
+	auto l_resourceBinder = addResourceBinder(ResourceBinderType::Image);
+	l_resourceBinder->m_Texture = rhs;
+
+	rhs->m_ResourceBinder = l_resourceBinder;
+	rhs->m_ObjectStatus = ObjectStatus::Activated;
+
+	return true;
+}
+
+bool NullRenderingServer::InitializeMaterialDataComponent(MaterialDataComponent * rhs)
+{
+	if (rhs->m_ObjectStatus == ObjectStatus::Activated)
+	{
+		return true;
+	}
+
+	auto l_defaultMaterial = g_pModuleManager->getRenderingFrontend()->getDefaultMaterialDataComponent();
+
+	for (size_t i = 0; i < 8; i++)
+	{
+		auto l_texture = rhs->m_TextureSlots[i].m_Texture;
+
+		if (l_texture)
+		{
+			InitializeTextureDataComponent(l_texture);
+			rhs->m_TextureSlots[i].m_Activate = true;
+		}
+		else if (l_defaultMaterial)
+		{
+			rhs->m_TextureSlots[i].m_Texture = l_defaultMaterial->m_TextureSlots[i].m_Texture;
+		}
+	}
+
+	rhs->m_ObjectStatus = ObjectStatus::Activated;
+
+	return true;
+}
+
+bool NullRenderingServer::InitializeRenderPassDataComponent(RenderPassDataComponent * rhs)
+{
+	// The render targets are only descriptions, but the render passes could still read their resource binders
+	for (size_t i = 0; i < rhs->m_RenderPassDesc.m_RenderTargetCount; i++)
+	{
+		auto l_TDC = AddTextureDataComponent((std::string(rhs->m_ComponentName.c_str()) + "_" + std::to_string(i) + "/").c_str());
+		l_TDC->m_TextureDesc = rhs->m_RenderPassDesc.m_RenderTargetDesc;
+		InitializeTextureDataComponent(l_TDC);
+
+		rhs->m_RenderTargets.emplace_back(l_TDC);
+		rhs->m_RenderTargetsResourceBinders.emplace_back(l_TDC->m_ResourceBinder);
+	}
+
+	if (rhs->m_RenderPassDesc.m_GraphicsPipelineDesc.m_DepthStencilDesc.m_UseDepthBuffer)
+	{
+		auto l_TDC = AddTextureDataComponent((std::string(rhs->m_ComponentName.c_str()) + "_DS/").c_str());
+		l_TDC->m_TextureDesc = rhs->m_RenderPassDesc.m_RenderTargetDesc;
+		l_TDC->m_TextureDesc.UsageType = TextureUsageType::DepthAttachment;
+		l_TDC->m_TextureDesc.PixelDataFormat = TexturePixelDataFormat::Depth;
+		InitializeTextureDataComponent(l_TDC);
+
+		rhs->m_DepthStencilRenderTarget = l_TDC;
+	}
+
+	rhs->m_PipelineStateObject = InnoMemory::Spawn<IPipelineStateObject>(m_PSOPool);
+
+	rhs->m_ObjectStatus = ObjectStatus::Activated;
+
+	return true;
+}
+
+bool NullRenderingServer::InitializeShaderProgramComponent(ShaderProgramComponent * rhs)
+{
+	rhs->m_ObjectStatus = ObjectStatus::Activated;
+
+	return true;
+}
+
+bool NullRenderingServer::InitializeSamplerDataComponent(SamplerDataComponent * rhs)
+{
+	rhs->m_ResourceBinder = addResourceBinder(ResourceBinderType::Sampler);
+	rhs->m_ObjectStatus = ObjectStatus::Activated;
+
+	return true;
+}
+
+bool NullRenderingServer::InitializeGPUBufferDataComponent(GPUBufferDataComponent * rhs)
+{
+	rhs->m_TotalSize = rhs->m_ElementCount * rhs->m_ElementSize;
+
+	auto l_resourceBinder = addResourceBinder(ResourceBinderType::Buffer);
+	l_resourceBinder->m_GPUAccessibility = rhs->m_GPUAccessibility;
+	l_resourceBinder->m_ElementCount = rhs->m_ElementCount;
+	l_resourceBinder->m_ElementSize = rhs->m_ElementSize;
+	l_resourceBinder->m_TotalSize = rhs->m_TotalSize;
+
+	rhs->m_ResourceBinder = l_resourceBinder;
+	rhs->m_ObjectStatus = ObjectStatus::Activated;
+
+	return true;
+}
+
+bool NullRenderingServer::DeleteMeshDataComponent(MeshDataComponent * rhs)
+{
+	m_MeshDataComponentPool->Destroy(rhs);
+
+	return true;
+}
+
+bool NullRenderingServer::DeleteTextureDataComponent(TextureDataComponent * rhs)
+{
+	if (rhs->m_ResourceBinder)
+	{
+		m_ResourcesBinderPool->Destroy(rhs->m_ResourceBinder);
+	}
+
+	m_TextureDataComponentPool->Destroy(rhs);
+
+	return true;
+}
+
+bool NullRenderingServer::DeleteMaterialDataComponent(MaterialDataComponent * rhs)
+{
+	m_MaterialDataComponentPool->Destroy(rhs);
+
+	return true;
+}
+
+bool NullRenderingServer::DeleteRenderPassDataComponent(RenderPassDataComponent * rhs)
+{
+	if (rhs->m_DepthStencilRenderTarget)
+	{
+		DeleteTextureDataComponent(rhs->m_DepthStencilRenderTarget);
+	}
+
+	// The resource binders of the render targets are owned by the textures
+	for (auto i : rhs->m_RenderTargets)
+	{
+		DeleteTextureDataComponent(i);
+	}
+
+	if (rhs->m_PipelineStateObject)
+	{
+		m_PSOPool->Destroy(rhs->m_PipelineStateObject);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ m_CommandMutex };
+		m_CommandLists.erase(rhs);
+	}
+
+	m_RenderPassDataComponentPool->Destroy(rhs);
+
+	return true;
+}
+
+bool NullRenderingServer::DeleteShaderProgramComponent(ShaderProgramComponent * rhs)
+{
+	m_ShaderProgramComponentPool->Destroy(rhs);
+
+	return true;
+}
+
+bool NullRenderingServer::DeleteSamplerDataComponent(SamplerDataComponent * rhs)
+{
+	if (rhs->m_ResourceBinder)
+	{
+		m_ResourcesBinderPool->Destroy(rhs->m_ResourceBinder);
+	}
+
+	m_SamplerDataComponentPool->Destroy(rhs);
+
+	return true;
+}
+
+bool NullRenderingServer::DeleteGPUBufferDataComponent(GPUBufferDataComponent * rhs)
+{
+	if (rhs->m_ResourceBinder)
+	{
+		m_ResourcesBinderPool->Destroy(rhs->m_ResourceBinder);
+	}
+
+	m_GPUBufferDataComponentPool->Destroy(rhs);
+
+	return true;
+}
+
+bool NullRenderingServer::UploadGPUBufferDataComponentImpl(GPUBufferDataComponent * rhs, const void * GPUBufferValue, size_t startOffset, size_t range)
+{
+	auto l_bytes = range == SIZE_MAX ? rhs->m_TotalSize : range * rhs->m_ElementSize;
+
+	return record(nullptr, RenderingCommandType::Upload, 1, l_bytes);
+}
+
+bool NullRenderingServer::CommandListBegin(RenderPassDataComponent * rhs, size_t frameIndex)
+{
+	std::lock_guard<std::mutex> lock{ m_CommandMutex };
+	m_CommandLists[rhs].clear();
+
+	return true;
+}
+
+bool NullRenderingServer::BindRenderPassDataComponent(RenderPassDataComponent * rhs)
+{
+	return record(rhs, RenderingCommandType::BindRenderPass, 1, 0);
+}
+
+bool NullRenderingServer::CleanRenderTargets(RenderPassDataComponent * rhs)
+{
+	return record(rhs, RenderingCommandType::CleanRenderTargets, 1, getRenderTargetsSize(rhs));
+}
+
+bool NullRenderingServer::ActivateResourceBinder(RenderPassDataComponent * renderPass, ShaderStage shaderStage, IResourceBinder * binder, size_t globalSlot, size_t localSlot, Accessibility accessibility, size_t startOffset, size_t elementCount)
+{
+	return record(renderPass, RenderingCommandType::ActivateResourceBinder, 1, getResourceBinderSize(binder, elementCount));
+}
+
+bool NullRenderingServer::DispatchDrawCall(RenderPassDataComponent * renderPass, MeshDataComponent* mesh, size_t instanceCount)
+{
+	auto l_bytes = mesh->m_vertices.size() * sizeof(Vertex) + mesh->m_indicesSize * sizeof(Index);
+
+	return record(renderPass, RenderingCommandType::DrawCall, instanceCount, l_bytes);
+}
+
+bool NullRenderingServer::DeactivateResourceBinder(RenderPassDataComponent * renderPass, ShaderStage shaderStage, IResourceBinder * binder, size_t globalSlot, size_t localSlot, Accessibility accessibility, size_t startOffset, size_t elementCount)
+{
+	return record(renderPass, RenderingCommandType::DeactivateResourceBinder, 1, 0);
+}
+
+bool NullRenderingServer::CommandListEnd(RenderPassDataComponent * rhs)
+{
+	return true;
+}
+
+bool NullRenderingServer::ExecuteCommandList(RenderPassDataComponent * rhs)
+{
+	RenderPassStatistics l_statistics;
+	l_statistics.m_Name = rhs->m_ComponentName.c_str();
+
+	std::lock_guard<std::mutex> lock{ m_CommandMutex };
+
+	for (auto& i : m_CommandLists[rhs])
+	{
+		l_statistics.m_CommandCount[(size_t)i.m_Type]++;
+		l_statistics.m_Bytes[(size_t)i.m_Type] += i.m_Bytes;
+
+		if (i.m_Type == RenderingCommandType::DrawCall)
+		{
+			l_statistics.m_InstanceCount += i.m_Count;
+		}
+		else if (i.m_Type == RenderingCommandType::DispatchCompute)
+		{
+			l_statistics.m_ThreadGroupCount += i.m_Count;
+		}
+	}
+
+	m_CurrentFrameStatistics.emplace_back(std::move(l_statistics));
+
+	return true;
+}
+
+bool NullRenderingServer::WaitForFrame(RenderPassDataComponent * rhs)
+{
+	return true;
+}
+
+bool NullRenderingServer::SetUserPipelineOutput(RenderPassDataComponent * rhs)
+{
+	return true;
+}
+
+bool NullRenderingServer::Present()
+{
+	RenderPassStatistics l_uploadStatistics;
+
+	std::lock_guard<std::mutex> lock{ m_CommandMutex };
+
+	for (auto& i : m_UploadCommands)
+	{
+		l_uploadStatistics.m_CommandCount[(size_t)i.m_Type]++;
+		l_uploadStatistics.m_Bytes[(size_t)i.m_Type] += i.m_Bytes;
+	}
+
+	m_UploadCommands.clear();
+
+	m_CurrentFrameStatistics.emplace_back(std::move(l_uploadStatistics));
+	m_LastFrameStatistics.swap(m_CurrentFrameStatistics);
+	m_CurrentFrameStatistics.clear();
+
+	return true;
+}
+
+bool NullRenderingServer::DispatchCompute(RenderPassDataComponent * renderPass, uint32_t threadGroupX, uint32_t threadGroupY, uint32_t threadGroupZ)
+{
+	return record(renderPass, RenderingCommandType::DispatchCompute, (size_t)threadGroupX * threadGroupY * threadGroupZ, 0);
+}
+
+bool NullRenderingServer::CopyDepthStencilBuffer(RenderPassDataComponent * src, RenderPassDataComponent * dest)
+{
+	auto l_bytes = src->m_DepthStencilRenderTarget ? getTextureSize(src->m_DepthStencilRenderTarget->m_TextureDesc) : 0;
+
+	return record(dest, RenderingCommandType::Copy, 1, l_bytes);
+}
+
+bool NullRenderingServer::CopyColorBuffer(RenderPassDataComponent * src, size_t srcIndex, RenderPassDataComponent * dest, size_t destIndex)
+{
+	auto l_bytes = srcIndex < src->m_RenderTargets.size() ? getTextureSize(src->m_RenderTargets[srcIndex]->m_TextureDesc) : 0;
+
+	return record(dest, RenderingCommandType::Copy, 1, l_bytes);
+}
+
+Vec4 NullRenderingServer::ReadRenderTargetSample(RenderPassDataComponent * rhs, size_t renderTargetIndex, size_t x, size_t y)
+{
+	return Vec4();
+}
+
+std::vector<Vec4> NullRenderingServer::ReadTextureBackToCPU(RenderPassDataComponent * canvas, TextureDataComponent * TDC)
+{
+	return std::vector<Vec4>(TDC->m_TextureDesc.Width * TDC->m_TextureDesc.Height);
+}
+
+bool NullRenderingServer::Resize()
+{
+	return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "../IRenderingServer.h"
+
+struct NullRenderingCommand
+{
+	RenderingCommandType m_Type = RenderingCommandType::BindRenderPass;
+	// The instance count of a draw call, or the thread group count of a dispatch
+	size_t m_Count = 0;
+	// The bytes the command reads or writes, the draw call counts its vertices and indices once for all the instances
+	size_t m_Bytes = 0;
+};
+
+// Keeps the resources in memory without any graphics API, for the headless mode
+// Every command is recorded with its byte count, so the rendering client could be benchmarked on CPU only
+class NullRenderingServer : public IRenderingServer
+{
+public:
+	// The commands recorded for the render pass since its last CommandListBegin
+	std::vector<NullRenderingCommand> GetCommands(RenderPassDataComponent* rhs);
+
+	// Inherited via IRenderingServer
+	bool Setup() override;
+	bool Initialize() override;
+	bool Terminate() override;
+
+	ObjectStatus GetStatus() override;
+
+	MeshDataComponent * AddMeshDataComponent(const char * name) override;
+	TextureDataComponent * AddTextureDataComponent(const char * name) override;
+	MaterialDataComponent * AddMaterialDataComponent(const char * name) override;
+	RenderPassDataComponent * AddRenderPassDataComponent(const char * name) override;
+	ShaderProgramComponent * AddShaderProgramComponent(const char * name) override;
+	SamplerDataComponent * AddSamplerDataComponent(const char * name = "") override;
+	GPUBufferDataComponent * AddGPUBufferDataComponent(const char * name) override;
+
+	bool InitializeMeshDataComponent(MeshDataComponent * rhs) override;
+	bool InitializeTextureDataComponent(TextureDataComponent * rhs) override;
+	bool InitializeMaterialDataComponent(MaterialDataComponent * rhs) override;
+	bool InitializeRenderPassDataComponent(RenderPassDataComponent * rhs) override;
+	bool InitializeShaderProgramComponent(ShaderProgramComponent * rhs) override;
+	bool InitializeSamplerDataComponent(SamplerDataComponent * rhs) override;
+	bool InitializeGPUBufferDataComponent(GPUBufferDataComponent * rhs) override;
+
+	bool DeleteMeshDataComponent(MeshDataComponent * rhs) override;
+	bool DeleteTextureDataComponent(TextureDataComponent * rhs) override;
+	bool DeleteMaterialDataComponent(MaterialDataComponent * rhs) override;
+	bool DeleteRenderPassDataComponent(RenderPassDataComponent * rhs) override;
+	bool DeleteShaderProgramComponent(ShaderProgramComponent * rhs) override;
+	bool DeleteSamplerDataComponent(SamplerDataComponent * rhs) override;
+	bool DeleteGPUBufferDataComponent(GPUBufferDataComponent * rhs) override;
+
+	bool UploadGPUBufferDataComponentImpl(GPUBufferDataComponent * rhs, const void * GPUBufferValue, size_t startOffset, size_t range) override;
+
+	bool CommandListBegin(RenderPassDataComponent * rhs, size_t frameIndex) override;
+	bool BindRenderPassDataComponent(RenderPassDataComponent * rhs) override;
+	bool CleanRenderTargets(RenderPassDataComponent * rhs) override;
+	bool ActivateResourceBinder(RenderPassDataComponent * renderPass, ShaderStage shaderStage, IResourceBinder * binder, size_t globalSlot, size_t localSlot, Accessibility accessibility, size_t startOffset, size_t elementCount) override;
+	bool DispatchDrawCall(RenderPassDataComponent * renderPass, MeshDataComponent* mesh, size_t instanceCount) override;
+	bool DeactivateResourceBinder(RenderPassDataComponent * renderPass, ShaderStage shaderStage, IResourceBinder * binder, size_t globalSlot, size_t localSlot, Accessibility accessibility, size_t startOffset, size_t elementCount) override;
+	bool CommandListEnd(RenderPassDataComponent * rhs) override;
+	bool ExecuteCommandList(RenderPassDataComponent * rhs) override;
+	bool WaitForFrame(RenderPassDataComponent * rhs) override;
+	bool SetUserPipelineOutput(RenderPassDataComponent * rhs) override;
+	bool Present() override;
+
+	bool DispatchCompute(RenderPassDataComponent * renderPass, uint32_t threadGroupX, uint32_t threadGroupY, uint32_t threadGroupZ) override;
+
+	bool CopyDepthStencilBuffer(RenderPassDataComponent * src, RenderPassDataComponent * dest) override;
+	bool CopyColorBuffer(RenderPassDataComponent * src, size_t srcIndex, RenderPassDataComponent * dest, size_t destIndex) override;
+
+	Vec4 ReadRenderTargetSample(RenderPassDataComponent * rhs, size_t renderTargetIndex, size_t x, size_t y) override;
+	std::vector<Vec4> ReadTextureBackToCPU(RenderPassDataComponent * canvas, TextureDataComponent * TDC) override;
+
+	bool Resize() override;
+
+	std::vector<RenderPassStatistics> GetRenderPassStatistics() override;
+};
\ No newline at end of file
@@ -4,7 +4,110 @@
 #include "../Common/InnoEntity.h"
 #include "../Common/InnoComponent.h"
 
-using SceneHierarchyMap = std::unordered_map<InnoEntity*, std::set<InnoComponent*>>;
+class ComponentRange
+{
+public:
+	ComponentRange() = default;
+	ComponentRange(InnoComponent* const* first, InnoComponent* const* last) : m_First(first), m_Last(last) {};
+
+	InnoComponent* const* begin() const { return m_First; }
+	InnoComponent* const* end() const { return m_Last; }
+	size_t size() const { return m_Last - m_First; }
+	bool empty() const { return m_First == m_Last; }
+
+private:
+	InnoComponent* const* m_First = nullptr;
+	InnoComponent* const* m_Last = nullptr;
+};
+
+struct SceneHierarchyRow
+{
+	uint32_t m_Offset = 0;
+	uint32_t m_Count = 0;
+	uint32_t m_Capacity = 0;
+};
+
+// CSR-style flat arrays updated in place, the components of the entity at row i are m_Components[m_Rows[i].m_Offset, m_Rows[i].m_Offset + m_Rows[i].m_Count)
+// A full row is moved to the end of the component array with a doubled capacity, the holes are compacted when they take more than half of the array
+class SceneHierarchyMap
+{
+public:
+	class Iterator
+	{
+	public:
+		Iterator(const SceneHierarchyMap* map, size_t row) : m_Map(map), m_Row(row) {};
+
+		std::pair<InnoEntity*, ComponentRange> operator*() const { return { m_Map->m_Entities[m_Row], m_Map->GetRow(m_Row) }; }
+		Iterator& operator++() { m_Row++; return *this; }
+		bool operator==(const Iterator& rhs) const { return m_Row == rhs.m_Row; }
+		bool operator!=(const Iterator& rhs) const { return m_Row != rhs.m_Row; }
+
+	private:
+		const SceneHierarchyMap* m_Map;
+		size_t m_Row;
+	};
+
+	Iterator begin() const { return Iterator(this, 0); }
+	Iterator end() const { return Iterator(this, m_Entities.size()); }
+	size_t size() const { return m_Entities.size(); }
+
+	ComponentRange GetRow(size_t row) const
+	{
+		auto l_first = m_Components.data() + m_Rows[row].m_Offset;
+		return ComponentRange(l_first, l_first + m_Rows[row].m_Count);
+	}
+
+	ComponentRange Find(const InnoEntity* entity) const;
+
+	// Increased on every successful component registration and unregistration
+	uint64_t GetVersion() const { return m_Version; }
+
+	// The slots of the component array, including the unused capacity and the holes
+	size_t GetComponentCapacity() const { return m_Components.size(); }
+
+	bool Add(InnoComponent* component);
+	bool Remove(InnoComponent* component);
+	void Reserve(size_t entityCount);
+
+private:
+	uint32_t Allocate(uint32_t capacity);
+	void Compact();
+
+	std::vector<InnoEntity*> m_Entities;
+	std::vector<SceneHierarchyRow> m_Rows;
+	std::vector<InnoComponent*> m_Components;
+	std::unordered_map<const InnoEntity*, uint32_t> m_EntityRows;
+	size_t m_HoleCount = 0;
+	std::vector<uint32_t> m_CompactionOrder;
+	uint64_t m_Version = 0;
+};
+
+// Holds the read lock of the scene hierarchy, so the ranges taken from it stay valid as long as it's alive
+// Don't register or unregister any component on the same thread while holding it
+class SceneHierarchyMapView
+{
+public:
+	SceneHierarchyMapView(const SceneHierarchyMap& map, std::shared_mutex& mutex) : m_Map(&map), m_Lock(mutex) {};
+
+	const SceneHierarchyMap& operator*() const { return *m_Map; }
+	const SceneHierarchyMap* operator->() const { return m_Map; }
+
+private:
+	const SceneHierarchyMap* m_Map;
+	std::shared_lock<std::shared_mutex> m_Lock;
+};
+
+// The components of one entity, with the same lifetime rule as SceneHierarchyMapView
+class SceneHierarchyComponentRange : public ComponentRange
+{
+public:
+	SceneHierarchyComponentRange(std::shared_mutex& mutex) : m_Lock(mutex) {};
+
+	void Assign(const ComponentRange& range) { static_cast<ComponentRange&>(*this) = range; }
+
+private:
+	std::shared_lock<std::shared_mutex> m_Lock;
+};
 
 class ISceneHierarchyManager
 {
@@ -14,5 +117,10 @@ public:
 	virtual bool Setup() = 0;
 	virtual bool Initialize() = 0;
 	virtual bool Terminate() = 0;
-	virtual const SceneHierarchyMap& GetSceneHierarchyMap() = 0;
-};
\ No newline at end of file
+	virtual bool RegisterComponent(InnoComponent* component) = 0;
+	virtual bool UnregisterComponent(InnoComponent* component) = 0;
+	virtual SceneHierarchyComponentRange GetComponents(const InnoEntity* entity) = 0;
+	virtual SceneHierarchyMapView GetSceneHierarchyMap() = 0;
+	// Increased on every successful component registration and unregistration
+	virtual uint64_t GetVersion() = 0;
+};
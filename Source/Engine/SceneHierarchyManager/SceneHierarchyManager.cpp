@@ -1,9 +1,5 @@
 #include "SceneHierarchyManager.h"
-#include "../Common/CommonMacro.inl"
-#include "../ComponentManager/ITransformComponentManager.h"
-#include "../ComponentManager/IVisibleComponentManager.h"
-#include "../ComponentManager/ILightComponentManager.h"
-#include "../ComponentManager/ICameraComponentManager.h"
+#include "../Core/InnoLogger.h"
 
 #include "../Interface/IModuleManager.h"
 
@@ -11,27 +7,165 @@ extern IModuleManager* g_pModuleManager;
 
 namespace InnoSceneHierarchyManagerNS
 {
-	SceneHierarchyMap m_SceneHierarchyMap;
-	std::atomic<bool> m_needUpdate = true;
+	const uint32_t m_InitialRowCapacity = 4;
 
-	std::function<void()> f_SceneLoadingStartCallback;
-	std::function<void()> f_SceneLoadingFinishCallback;
+	SceneHierarchyMap m_SceneHierarchyMap;
+	std::shared_mutex m_Mutex;
+	std::atomic<uint64_t> m_Version = 0;
 }
 
 using namespace InnoSceneHierarchyManagerNS;
 
-bool InnoSceneHierarchyManager::Setup()
+ComponentRange SceneHierarchyMap::Find(const InnoEntity* entity) const
+{
+	auto l_result = m_EntityRows.find(entity);
+	if (l_result == m_EntityRows.end())
+	{
+		return ComponentRange();
+	}
+
+	return GetRow(l_result->second);
+}
+
+void SceneHierarchyMap::Reserve(size_t entityCount)
+{
+	m_Entities.reserve(entityCount);
+	m_Rows.reserve(entityCount);
+	m_Components.reserve(entityCount * m_InitialRowCapacity);
+	m_EntityRows.reserve(entityCount);
+}
+
+uint32_t SceneHierarchyMap::Allocate(uint32_t capacity)
 {
-	f_SceneLoadingStartCallback = [&]() {
-		m_SceneHierarchyMap.clear();
-	};
+	auto l_offset = (uint32_t)m_Components.size();
+	m_Components.resize(m_Components.size() + capacity, nullptr);
+
+	return l_offset;
+}
 
-	f_SceneLoadingFinishCallback = [&]() {
-		m_needUpdate = true;
-	};
+// Move the rows down in the order of their offsets, so every row is copied to a place before or at its current one
+void SceneHierarchyMap::Compact()
+{
+	m_CompactionOrder.resize(m_Rows.size());
+	for (uint32_t i = 0; i < (uint32_t)m_Rows.size(); i++)
+	{
+		m_CompactionOrder[i] = i;
+	}
 
-	g_pModuleManager->getFileSystem()->addSceneLoadingStartCallback(&f_SceneLoadingStartCallback);
-	g_pModuleManager->getFileSystem()->addSceneLoadingFinishCallback(&f_SceneLoadingFinishCallback);
+	std::sort(m_CompactionOrder.begin(), m_CompactionOrder.end(), [&](uint32_t lhs, uint32_t rhs) { return m_Rows[lhs].m_Offset < m_Rows[rhs].m_Offset; });
+
+	uint32_t l_offset = 0;
+
+	for (auto i : m_CompactionOrder)
+	{
+		auto& l_row = m_Rows[i];
+		std::copy(m_Components.begin() + l_row.m_Offset, m_Components.begin() + l_row.m_Offset + l_row.m_Count, m_Components.begin() + l_offset);
+		std::fill(m_Components.begin() + l_offset + l_row.m_Count, m_Components.begin() + l_offset + l_row.m_Capacity, nullptr);
+		l_row.m_Offset = l_offset;
+		l_offset += l_row.m_Capacity;
+	}
+
+	m_Components.resize(l_offset);
+	m_HoleCount = 0;
+}
+
+bool SceneHierarchyMap::Add(InnoComponent* component)
+{
+	auto l_entity = component->m_ParentEntity;
+	auto l_result = m_EntityRows.find(l_entity);
+
+	if (l_result == m_EntityRows.end())
+	{
+		SceneHierarchyRow l_row;
+		l_row.m_Capacity = m_InitialRowCapacity;
+		l_row.m_Offset = Allocate(l_row.m_Capacity);
+
+		l_result = m_EntityRows.emplace(l_entity, (uint32_t)m_Entities.size()).first;
+		m_Entities.emplace_back(l_entity);
+		m_Rows.emplace_back(l_row);
+	}
+
+	auto& l_row = m_Rows[l_result->second];
+
+	if (l_row.m_Count == l_row.m_Capacity)
+	{
+		auto l_offset = Allocate(l_row.m_Capacity * 2);
+		std::copy(m_Components.begin() + l_row.m_Offset, m_Components.begin() + l_row.m_Offset + l_row.m_Count, m_Components.begin() + l_offset);
+
+		m_HoleCount += l_row.m_Capacity;
+		l_row.m_Offset = l_offset;
+		l_row.m_Capacity *= 2;
+	}
+
+	m_Components[l_row.m_Offset + l_row.m_Count] = component;
+	l_row.m_Count++;
+
+	if (m_HoleCount > m_Components.size() / 2)
+	{
+		Compact();
+	}
+
+	m_Version++;
+
+	return true;
+}
+bool SceneHierarchyMap::Remove(InnoComponent* component)
+{
+	auto l_result = m_EntityRows.find(component->m_ParentEntity);
+	if (l_result == m_EntityRows.end())
+	{
+		InnoLogger::Log(LogLevel::Warning, "SceneHierarchyManager: Entity of component ", component->GetDebugName().c_str(), " is not registered.");
+		return false;
+	}
+
+	auto l_rowIndex = l_result->second;
+	auto& l_row = m_Rows[l_rowIndex];
+	auto l_first = m_Components.begin() + l_row.m_Offset;
+	auto l_last = l_first + l_row.m_Count;
+	auto l_component = std::find(l_first, l_last, component);
+
+	if (l_component == l_last)
+	{
+		InnoLogger::Log(LogLevel::Warning, "SceneHierarchyManager: Component ", component->GetDebugName().c_str(), " is not registered.");
+		return false;
+	}
+
+	// Keep the registration order inside the row
+	std::copy(l_component + 1, l_last, l_component);
+	*(l_last - 1) = nullptr;
+	l_row.m_Count--;
+
+	// An empty row leaves its capacity as a hole, the last row takes its place
+	if (!l_row.m_Count)
+	{
+		m_HoleCount += l_row.m_Capacity;
+
+		auto l_lastRowIndex = (uint32_t)m_Entities.size() - 1;
+		if (l_rowIndex != l_lastRowIndex)
+		{
+			m_Entities[l_rowIndex] = m_Entities[l_lastRowIndex];
+			m_Rows[l_rowIndex] = m_Rows[l_lastRowIndex];
+			m_EntityRows[m_Entities[l_rowIndex]] = l_rowIndex;
+		}
+
+		m_EntityRows.erase(component->m_ParentEntity);
+		m_Entities.pop_back();
+		m_Rows.pop_back();
+
+		if (m_HoleCount > m_Components.size() / 2)
+		{
+			Compact();
+		}
+	}
+
+	m_Version++;
+
+	return true;
+}
+
+bool InnoSceneHierarchyManager::Setup()
+{
+	m_SceneHierarchyMap.Reserve(4096);
 
 	return true;
 }
@@ -46,34 +180,48 @@ bool InnoSceneHierarchyManager::Terminate()
 	return true;
 }
 
-#define AddComponentToSceneHierarchyMap( className ) \
-{ \
-	auto l_Components = GetComponentManager(className)->GetAllComponents(); \
-	for (auto i : l_Components) \
-	{ \
-		auto l_result = m_SceneHierarchyMap.find(i->m_ParentEntity); \
-		if (l_result != m_SceneHierarchyMap.end()) \
-		{ \
-			l_result->second.emplace(i); \
-		} \
-		else \
-		{ \
-			m_SceneHierarchyMap.emplace(i->m_ParentEntity, std::set<InnoComponent*>{ i }); \
-		} \
-	}\
+bool InnoSceneHierarchyManager::RegisterComponent(InnoComponent* component)
+{
+	std::unique_lock<std::shared_mutex> lock{ m_Mutex };
+
+	if (!m_SceneHierarchyMap.Add(component))
+	{
+		return false;
+	}
+
+	m_Version = m_SceneHierarchyMap.GetVersion();
+
+	return true;
 }
 
-const SceneHierarchyMap & InnoSceneHierarchyManager::GetSceneHierarchyMap()
+bool InnoSceneHierarchyManager::UnregisterComponent(InnoComponent* component)
 {
-	if (m_needUpdate)
-	{
-		AddComponentToSceneHierarchyMap(TransformComponent);
-		AddComponentToSceneHierarchyMap(VisibleComponent);
-		AddComponentToSceneHierarchyMap(LightComponent);
-		AddComponentToSceneHierarchyMap(CameraComponent);
+	std::unique_lock<std::shared_mutex> lock{ m_Mutex };
 
-		m_needUpdate = false;
+	if (!m_SceneHierarchyMap.Remove(component))
+	{
+		return false;
 	}
 
-	return m_SceneHierarchyMap;
-}
\ No newline at end of file
+	m_Version = m_SceneHierarchyMap.GetVersion();
+
+	return true;
+}
+
+SceneHierarchyComponentRange InnoSceneHierarchyManager::GetComponents(const InnoEntity* entity)
+{
+	SceneHierarchyComponentRange l_result(m_Mutex);
+	l_result.Assign(m_SceneHierarchyMap.Find(entity));
+
+	return l_result;
+}
+
+SceneHierarchyMapView InnoSceneHierarchyManager::GetSceneHierarchyMap()
+{
+	return SceneHierarchyMapView(m_SceneHierarchyMap, m_Mutex);
+}
+
+uint64_t InnoSceneHierarchyManager::GetVersion()
+{
+	return m_Version;
+}
@@ -9,5 +9,9 @@ public:
 	bool Setup() override;
 	bool Initialize() override;
 	bool Terminate() override;
-	const SceneHierarchyMap& GetSceneHierarchyMap() override;
+	bool RegisterComponent(InnoComponent* component) override;
+	bool UnregisterComponent(InnoComponent* component) override;
+	SceneHierarchyComponentRange GetComponents(const InnoEntity* entity) override;
+	SceneHierarchyMapView GetSceneHierarchyMap() override;
+	uint64_t GetVersion() override;
 };
\ No newline at end of file
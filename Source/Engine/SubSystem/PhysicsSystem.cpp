@@ -3,13 +3,20 @@
 #include "../ComponentManager/ITransformComponentManager.h"
 #include "../ComponentManager/IVisibleComponentManager.h"
 #include "../ComponentManager/ICameraComponentManager.h"
+#include "../ComponentManager/ILightComponentManager.h"
+#include "../ComponentManager/ComponentQuery.h"
 
 #include "../Common/InnoMathHelper.h"
 #include "../Core/InnoLogger.h"
 #include "../Core/InnoMemory.h"
+#include "../Core/InnoBVH.h"
+#include "../Core/InnoOcclusionCulling.h"
+#include "../Core/InnoSceneQuery.h"
 
 #if defined INNO_PLATFORM_WIN
 #include "../ThirdParty/PhysXWrapper/PhysXWrapper.h"
+#else
+#include "../Core/InnoRigidBodyDynamics.h"
 #endif
 
 #include "../Interface/IModuleManager.h"
@@ -26,7 +33,6 @@ namespace InnoPhysicsSystemNS
 	bool generateAABBInWorldSpace(PhysicsDataComponent* PDC, const Mat4& m);
 	bool generatePhysicsProxy(VisibleComponent * VC);
 
-	void updateVisibleSceneBoundary(const AABB& rhs);
 	void updateTotalSceneBoundary(const AABB& rhs);
 	void updateStaticSceneBoundary(const AABB& rhs);
 
@@ -43,19 +49,129 @@ namespace InnoPhysicsSystemNS
 	Vec4 m_staticSceneBoundMax;
 	Vec4 m_staticSceneBoundMin;
 	PhysicsDataComponent* m_RootPhysicsDataComponent = 0;
-	BVHNode* m_RootBVHNode = 0;
 
 	IObjectPool* m_PhysicsDataComponentPool;
 
 	std::vector<PhysicsDataComponent*> m_Components;
-	std::vector<PhysicsDataComponent*> m_IntermediateComponents;
-	std::vector<BVHNode> m_BVHNodes;
 
-	DoubleBuffer<std::vector<CullingData>, true> m_cullingData;
+	struct CullingProxy
+	{
+		PhysicsDataComponent* m_PDC;
+		VisibleComponent* m_VisibleComponent;
+		TransformComponent* m_TransformComponent;
+		// The transformation which m_AABBWS was generated with
+		Mat4 m_Transformation;
+		// The interpolated transformation of the last culling pass which output the proxy, it's the previous one of the next pass
+		// They're written under the shared side of the mutex: the culling passes run one by one on the thread 1, every proxy belongs to only one culling chunk, and the scene queries never read them
+		Mat4 m_RenderedTransformation;
+		uint64_t m_RenderedCullingIndex = 0;
+	};
+
+	// The rendered states are kept through the rebuilding of the culling proxies, so the motion vectors don't reset when the scene changes
+	std::unordered_map<PhysicsDataComponent*, std::pair<Mat4, uint64_t>> m_RenderedStates;
+
+	ComponentQuery<VisibleComponent, TransformComponent> m_VisibleComponentQuery;
+	std::vector<CullingProxy> m_CullingProxies;
+	std::vector<AABB> m_CullingProxyBounds;
+	std::vector<uint32_t> m_DynamicCullingProxyIndices;
+	std::vector<uint32_t> m_ChangedCullingProxyIndices;
+	std::vector<AABB> m_ChangedBoundsLS;
+	std::vector<Mat4> m_ChangedTransformations;
+	std::vector<AABB> m_ChangedBoundsWS;
+	BVH m_BVH;
+
+	// Rebuild the BVH in background when the refitted tree is this much worse than the freshly built one
+	const float m_BVHRebuildThreshold = 1.5f;
+	float m_BVHBuildSAHCost = 0.0f;
+	BVH m_PendingBVH;
+	std::vector<AABB> m_PendingBVHBounds;
+	std::shared_ptr<IInnoTask> m_BVHRebuildTask;
+
+	std::vector<uint32_t> m_VisibleCullingProxyIndices;
+	std::vector<bool> m_CullingProxyVisibilities;
+
+	// Each chunk of culling proxies is processed by one worker into its own output, the outputs are merged in the chunk order
+	struct CullingChunk
+	{
+		std::vector<CullingData> m_CullingData;
+		Vec4 m_VisibleSceneBoundMax;
+		Vec4 m_VisibleSceneBoundMin;
+		Vec4 m_TotalSceneBoundMax;
+		Vec4 m_TotalSceneBoundMin;
+	};
+
+	// Software occlusion culling, the visible opaque meshes which cover the most of the screen are rasterized as occluders
+	const uint32_t m_OcclusionBufferWidth = 256;
+	const uint32_t m_OcclusionBufferHeight = 128;
+	const uint32_t m_OcclusionBufferBandHeight = 16;
+	const size_t m_MaxOccluderCount = 32;
+	const size_t m_MaxOccluderTriangleCount = 32768;
+
+	struct Occluder
+	{
+		MeshDataComponent* m_Mesh;
+		Mat4 m_WVP;
+		size_t m_ScreenVertexOffset;
+	};
+
+	OcclusionBuffer m_OcclusionBuffer;
+	std::vector<std::pair<float, uint32_t>> m_OccluderCandidates;
+	std::vector<Occluder> m_Occluders;
+	std::vector<Vec4> m_OccluderScreenVertices;
+	std::vector<uint8_t> m_OccludeeVisibilities;
+
+	// The sun's cascades as oriented boxes, bit i of a proxy's mask is set if it's inside the cascade i extended toward the sun
+	const uint32_t m_AllShadowCascadesMask = 0xFFFFFFFF;
+	std::vector<Frustum> m_ShadowCascadeFrustums;
+	std::vector<uint32_t> m_ShadowCasterIndices;
+	std::vector<uint32_t> m_CullingProxyShadowCascadeMasks;
+
+	const size_t m_CullingChunkSize = 1024;
+	std::vector<CullingChunk> m_CullingChunks;
+	std::vector<size_t> m_CullingChunkOffsets;
+
+	// The culling results are written into a buffer without any view and handed to the consumers in place, so the buffers are reused instead of copied every frame
+	std::vector<std::shared_ptr<std::vector<CullingData>>> m_cullingDataBuffers;
+	CullingDataView m_latestCullingData;
+	std::mutex m_latestCullingDataMutex;
 
-	size_t m_maxBVHDepth = 16;
 	std::atomic<size_t> m_BVHWorkloadCount = 0;
 
+	// Counts the culling passes from 1, the passes run one by one
+	uint64_t m_CullingIndex = 0;
+
+	// The scene queries and the culling read the BVH and the culling proxies under the shared side, the updates take the exclusive side
+	// The unfinished scene queries are waited before the physics proxies they return are destroyed
+	SceneQueryContext m_SceneQueryContext;
+	const size_t m_SceneQueryGrainSize = 64;
+
+	float raycastMesh(const CullingProxy& cullingProxy, const Vec4& origin, const Vec4& direction, float boundsDistance, float maxDistance);
+	void executeSceneQueries(SceneQueryBatch& batch);
+
+#if !defined INNO_PLATFORM_WIN
+	// The native rigid body simulation, toggled by the same key as PhysX
+	const float m_MaxSimulationTimeStep = 1.0f / 30.0f;
+	RigidBodyWorld m_RigidBodyWorld;
+	std::mutex m_RigidBodyWorldMutex;
+	bool m_needSimulate = false;
+	std::shared_ptr<IInnoTask> m_SimulationTask;
+	std::function<void()> f_pauseSimulate;
+
+	void addGroundRigidBody();
+	void addRigidBody(TransformComponent* transformComponent, RigidBodyDesc& desc, bool isDynamic);
+#endif
+
+	void rebuildBVH();
+	void updateDynamicBound(PhysicsDataComponent* PDC, const Mat4& m);
+	void refitBVH();
+	float getScreenSize(const CullingProxy& cullingProxy, const Vec4& cameraPos, float pixelsPerUnit);
+	TransformMatrix getRenderingTransformMatrix(const TransformComponent* transformComponent);
+	AABB getOccludeeBounds(uint32_t cullingProxyIndex);
+	void updateOcclusionCulling(const Mat4& VP, const Vec4& cameraPos);
+	bool generateShadowCascadeFrustums();
+	void generateCullingData(CullingProxy& cullingProxy, bool isVisible, uint32_t shadowCascadeMask, CullingChunk& cullingChunk);
+	std::shared_ptr<std::vector<CullingData>> getFreeCullingDataBuffer();
+
 	std::function<void()> f_sceneLoadingStartCallback;
 }
 
@@ -66,28 +182,43 @@ bool InnoPhysicsSystemNS::setup()
 	m_PhysicsDataComponentPool = InnoMemory::CreateObjectPool<PhysicsDataComponent>(32678);
 
 	m_Components.reserve(16384);
-	m_IntermediateComponents.reserve(16384);
-	m_BVHNodes.reserve(32678);
+	m_CullingProxies.reserve(16384);
+	m_CullingProxyBounds.reserve(16384);
+
+	m_latestCullingData = getFreeCullingDataBuffer();
 
 #if defined INNO_PLATFORM_WIN
 	PhysXWrapper::get().setup();
+#else
+	addGroundRigidBody();
+
+	f_pauseSimulate = [&]() { m_needSimulate = !m_needSimulate; };
+
+	g_pModuleManager->getEventSystem()->addButtonStateCallback(ButtonState{ INNO_KEY_P, true }, ButtonEvent{ EventLifeTime::OneShot, &f_pauseSimulate });
 #endif
 
 	f_sceneLoadingStartCallback = [&]()
 	{
-		auto l_intermediatePDCCount = m_IntermediateComponents.size();
-		for (size_t i = 0; i < l_intermediatePDCCount; i++)
-		{
-			m_PhysicsDataComponentPool->Destroy(m_IntermediateComponents[i]);
-		}
 		auto l_PDCCount = m_Components.size();
 		for (size_t i = 0; i < l_PDCCount; i++)
 		{
 			m_PhysicsDataComponentPool->Destroy(m_Components[i]);
 		}
 		m_Components.clear();
-		m_IntermediateComponents.clear();
-		m_BVHNodes.clear();
+		InnoSceneQuery::WaitAll(m_SceneQueryContext);
+		if (m_BVHRebuildTask)
+		{
+			m_BVHRebuildTask->Wait();
+			m_BVHRebuildTask = nullptr;
+		}
+
+		{
+			std::unique_lock<std::shared_mutex> lock{ m_SceneQueryContext.m_Mutex };
+			m_CullingProxies.clear();
+			m_CullingProxyBounds.clear();
+			m_DynamicCullingProxyIndices.clear();
+			m_BVH = BVH();
+		}
 
 		if (m_RootPhysicsDataComponent)
 		{
@@ -105,6 +236,17 @@ bool InnoPhysicsSystemNS::setup()
 		m_staticSceneBoundMax.w = 1.0f;
 		m_staticSceneBoundMin = InnoMath::maxVec4<float>;
 		m_staticSceneBoundMin.w = 1.0f;
+
+#if !defined INNO_PLATFORM_WIN
+		m_needSimulate = false;
+		if (m_SimulationTask)
+		{
+			m_SimulationTask->Wait();
+			m_SimulationTask = nullptr;
+		}
+		InnoRigidBodyDynamics::Clear(m_RigidBodyWorld);
+		addGroundRigidBody();
+#endif
 	};
 
 	g_pModuleManager->getFileSystem()->addSceneLoadingStartCallback(&f_sceneLoadingStartCallback);
@@ -117,11 +259,60 @@ bool InnoPhysicsSystemNS::update()
 {
 #if defined INNO_PLATFORM_WIN
 	PhysXWrapper::get().update();
+#else
+	// One step for each fixed step, it runs in order with the other simulation tasks of the thread 0 and it's finished before the step ends
+	if (m_needSimulate)
+	{
+		m_SimulationTask = g_pModuleManager->getTaskSystem()->submit("RigidBodySimulationTask", 0, nullptr, [&]()
+		{
+			std::lock_guard<std::mutex> lock{ m_RigidBodyWorldMutex };
+
+			InnoRigidBodyDynamics::Step(m_RigidBodyWorld, std::min(g_pModuleManager->getFixedTimeStep() / 1000.0f, m_MaxSimulationTimeStep));
+
+			for (auto& i : m_RigidBodyWorld.m_Bodies)
+			{
+				if (i.m_InvMass > 0.0f && !i.m_Sleeping && i.m_UserData)
+				{
+					auto l_transformComponent = reinterpret_cast<TransformComponent*>(i.m_UserData);
+					l_transformComponent->m_localTransformVector_target.m_pos = i.m_Position;
+					l_transformComponent->m_localTransformVector_target.m_rot = i.m_Rotation;
+					l_transformComponent->m_localTransformVector = l_transformComponent->m_localTransformVector_target;
+				}
+			}
+		});
+	}
 #endif
 
 	return true;
 }
 
+#if !defined INNO_PLATFORM_WIN
+void InnoPhysicsSystemNS::addGroundRigidBody()
+{
+	// The same ground as the plane of PhysX, the top face is at y = 0
+	RigidBodyDesc l_desc;
+	l_desc.m_Position = Vec4(0.0f, -1.0f, 0.0f, 1.0f);
+	l_desc.m_HalfExtents = Vec4(10000.0f, 1.0f, 10000.0f, 0.0f);
+	l_desc.m_Mass = 0.0f;
+
+	InnoRigidBodyDynamics::AddRigidBody(m_RigidBodyWorld, l_desc);
+}
+
+void InnoPhysicsSystemNS::addRigidBody(TransformComponent* transformComponent, RigidBodyDesc& desc, bool isDynamic)
+{
+	std::lock_guard<std::mutex> lock{ m_RigidBodyWorldMutex };
+
+	desc.m_Position = transformComponent->m_localTransformVector_target.m_pos;
+	desc.m_Rotation = transformComponent->m_localTransformVector_target.m_rot;
+	desc.m_Mass = isDynamic ? 10.0f : 0.0f;
+	desc.m_UserData = transformComponent;
+
+	InnoRigidBodyDynamics::AddRigidBody(m_RigidBodyWorld, desc);
+
+	InnoLogger::Log(LogLevel::Verbose, "PhysicsSystem: RigidBody has been created for ", transformComponent, ".");
+}
+#endif
+
 PhysicsDataComponent * InnoPhysicsSystemNS::AddPhysicsDataComponent(InnoEntity * parentEntity)
 {
 	auto l_PDC = InnoMemory::Spawn<PhysicsDataComponent>(m_PhysicsDataComponentPool);
@@ -173,6 +364,8 @@ bool InnoPhysicsSystemNS::generatePhysicsProxy(VisibleComponent * VC)
 		updateTotalSceneBoundary(i->m_AABBWS);
 	}
 
+	m_BVHWorkloadCount++;
+
 #if defined INNO_PLATFORM_WIN
 	if (VC->m_simulatePhysics)
 	{
@@ -195,17 +388,50 @@ bool InnoPhysicsSystemNS::generatePhysicsProxy(VisibleComponent * VC)
 			break;
 		}
 	}
+#else
+	if (VC->m_simulatePhysics)
+	{
+		auto l_transformComponent = GetComponent(TransformComponent, VC->m_ParentEntity);
+		auto l_isDynamic = (VC->m_meshUsageType == MeshUsageType::Dynamic);
+		auto& l_scale = l_transformComponent->m_localTransformVector_target.m_scale;
+		RigidBodyDesc l_desc;
+
+		switch (VC->m_meshShapeType)
+		{
+		case MeshShapeType::Cube:
+			l_desc.m_ShapeType = RigidBodyShapeType::Box;
+			l_desc.m_HalfExtents = Vec4(l_scale.x, l_scale.y, l_scale.z, 0.0f);
+			addRigidBody(l_transformComponent, l_desc, l_isDynamic);
+			break;
+		case MeshShapeType::Sphere:
+			l_desc.m_ShapeType = RigidBodyShapeType::Sphere;
+			l_desc.m_Radius = l_scale.x;
+			addRigidBody(l_transformComponent, l_desc, l_isDynamic);
+			break;
+		case MeshShapeType::Custom:
+			// One body for the whole entity, the hull of the scaled vertices of all the sub-meshes is decimated by AddRigidBody
+			l_desc.m_ShapeType = RigidBodyShapeType::Convex;
+			for (auto i : VC->m_PDCs)
+			{
+				auto& l_vertices = i->m_ModelPair.first->m_vertices;
+				l_desc.m_ConvexVertices.reserve(l_desc.m_ConvexVertices.size() + l_vertices.size());
+				for (size_t j = 0; j < l_vertices.size(); j++)
+				{
+					auto& l_pos = l_vertices[j].m_pos;
+					l_desc.m_ConvexVertices.emplace_back(l_pos.x * l_scale.x, l_pos.y * l_scale.y, l_pos.z * l_scale.z, 0.0f);
+				}
+			}
+			addRigidBody(l_transformComponent, l_desc, l_isDynamic);
+			break;
+		default:
+			break;
+		}
+	}
 #endif
 
 	return true;
 }
 
-void InnoPhysicsSystemNS::updateVisibleSceneBoundary(const AABB& rhs)
-{
-	m_visibleSceneBoundMax = InnoMath::elementWiseMax(rhs.m_boundMax, m_visibleSceneBoundMax);
-	m_visibleSceneBoundMin = InnoMath::elementWiseMin(rhs.m_boundMin, m_visibleSceneBoundMin);
-}
-
 void InnoPhysicsSystemNS::updateTotalSceneBoundary(const AABB& rhs)
 {
 	m_totalSceneBoundMax = InnoMath::elementWiseMax(rhs.m_boundMax, m_totalSceneBoundMax);
@@ -249,6 +475,12 @@ bool InnoPhysicsSystem::update()
 
 bool InnoPhysicsSystem::terminate()
 {
+#if !defined INNO_PLATFORM_WIN
+	if (InnoPhysicsSystemNS::m_SimulationTask)
+	{
+		InnoPhysicsSystemNS::m_SimulationTask->Wait();
+	}
+#endif
 	InnoPhysicsSystemNS::m_ObjectStatus = ObjectStatus::Terminated;
 	InnoLogger::Log(LogLevel::Success, "PhysicsSystem has been terminated.");
 	return true;
@@ -264,345 +496,577 @@ PhysicsDataComponent* InnoPhysicsSystem::generatePhysicsDataComponent(const Mode
 	return InnoPhysicsSystemNS::generatePhysicsDataComponent(modelPair);
 }
 
-bool generateBVHLeafNodes(BVHNode* parentNode)
+void InnoPhysicsSystemNS::rebuildBVH()
 {
-	if (parentNode->childrenPDCs.size() == 1)
+	if (m_BVHRebuildTask)
 	{
-		return true;
+		m_BVHRebuildTask->Wait();
+		m_BVHRebuildTask = nullptr;
 	}
-	// Find max axis
-	float l_maxAxisLength;
-	uint32_t l_maxAxis;
-	if (parentNode->intermediatePDC->m_AABBWS.m_extend.x > parentNode->intermediatePDC->m_AABBWS.m_extend.y)
+
+	m_RenderedStates.clear();
+	for (auto& i : m_CullingProxies)
 	{
-		if (parentNode->intermediatePDC->m_AABBWS.m_extend.x > parentNode->intermediatePDC->m_AABBWS.m_extend.z)
-		{
-			l_maxAxisLength = parentNode->intermediatePDC->m_AABBWS.m_extend.x;
-			l_maxAxis = 0;
-		}
-		else
-		{
-			l_maxAxisLength = parentNode->intermediatePDC->m_AABBWS.m_extend.z;
-			l_maxAxis = 2;
-		}
+		m_RenderedStates.emplace(i.m_PDC, std::make_pair(i.m_RenderedTransformation, i.m_RenderedCullingIndex));
 	}
-	else
+
+	m_CullingProxies.clear();
+	m_CullingProxyBounds.clear();
+	m_DynamicCullingProxyIndices.clear();
+
+	m_VisibleComponentQuery.ForEach([&](VisibleComponent* visibleComponent, TransformComponent* transformComponent)
 	{
-		if (parentNode->intermediatePDC->m_AABBWS.m_extend.y > parentNode->intermediatePDC->m_AABBWS.m_extend.z)
+		for (auto i : visibleComponent->m_PDCs)
 		{
-			l_maxAxisLength = parentNode->intermediatePDC->m_AABBWS.m_extend.y;
-			l_maxAxis = 1;
+			// Not all the physics proxies are generated yet
+			if (!i || i->m_VisibleComponent != visibleComponent)
+			{
+				continue;
+			}
+
+			if (visibleComponent->m_meshUsageType == MeshUsageType::Dynamic)
+			{
+				m_DynamicCullingProxyIndices.emplace_back((uint32_t)m_CullingProxies.size());
+				updateDynamicBound(i, transformComponent->m_globalTransformMatrix.m_transformationMat);
+			}
+
+			CullingProxy l_cullingProxy;
+			l_cullingProxy.m_PDC = i;
+			l_cullingProxy.m_VisibleComponent = visibleComponent;
+			l_cullingProxy.m_TransformComponent = transformComponent;
+			l_cullingProxy.m_Transformation = transformComponent->m_globalTransformMatrix.m_transformationMat;
+
+			auto l_renderedState = m_RenderedStates.find(i);
+			if (l_renderedState != m_RenderedStates.end())
+			{
+				l_cullingProxy.m_RenderedTransformation = l_renderedState->second.first;
+				l_cullingProxy.m_RenderedCullingIndex = l_renderedState->second.second;
+			}
+			else
+			{
+				l_cullingProxy.m_RenderedTransformation = l_cullingProxy.m_Transformation;
+				l_cullingProxy.m_RenderedCullingIndex = 0;
+			}
+
+			m_CullingProxies.emplace_back(l_cullingProxy);
+			m_CullingProxyBounds.emplace_back(i->m_AABBWS);
 		}
-		else
+	});
+
+	InnoBVH::Build(m_BVH, m_CullingProxyBounds.data(), m_CullingProxyBounds.size());
+	m_BVHBuildSAHCost = InnoBVH::GetNormalizedSAHCost(m_BVH);
+}
+
+void InnoPhysicsSystemNS::updateDynamicBound(PhysicsDataComponent* PDC, const Mat4& m)
+{
+	PDC->m_AABBWS = InnoMath::transformAABBSpace(PDC->m_AABBLS, m);
+	PDC->m_SphereWS = InnoMath::generateBoundSphere(PDC->m_AABBWS);
+}
+
+void InnoPhysicsSystemNS::refitBVH()
+{
+	// Swap in the background rebuilt tree, the bounds might have changed after the snapshot
+	if (m_BVHRebuildTask && m_BVHRebuildTask->IsFinished())
+	{
+		m_BVHRebuildTask = nullptr;
+		std::swap(m_BVH, m_PendingBVH);
+		InnoBVH::RefitAll(m_BVH, m_CullingProxyBounds.data());
+		m_BVHBuildSAHCost = InnoBVH::GetNormalizedSAHCost(m_BVH);
+	}
+
+	m_ChangedCullingProxyIndices.clear();
+	m_ChangedBoundsLS.clear();
+	m_ChangedTransformations.clear();
+
+	for (auto i : m_DynamicCullingProxyIndices)
+	{
+		auto& l_cullingProxy = m_CullingProxies[i];
+		auto& l_transformation = l_cullingProxy.m_TransformComponent->m_globalTransformMatrix.m_transformationMat;
+
+		if (std::memcmp(&l_transformation, &l_cullingProxy.m_Transformation, sizeof(Mat4)))
 		{
-			l_maxAxisLength = parentNode->intermediatePDC->m_AABBWS.m_extend.z;
-			l_maxAxis = 2;
+			l_cullingProxy.m_Transformation = l_transformation;
+			m_ChangedCullingProxyIndices.emplace_back(i);
+			m_ChangedBoundsLS.emplace_back(l_cullingProxy.m_PDC->m_AABBLS);
+			m_ChangedTransformations.emplace_back(l_transformation);
 		}
 	}
 
-	// Sort children nodes
-	if (l_maxAxis == 0)
+	// Transform the moved bounds in one batch, the scratch arrays keep their capacity between frames
+	auto l_changedCount = m_ChangedCullingProxyIndices.size();
+	m_ChangedBoundsWS.resize(l_changedCount);
+	InnoMath::transformAABBSpace(m_ChangedBoundsLS.data(), m_ChangedTransformations.data(), l_changedCount, m_ChangedBoundsWS.data());
+
+	for (size_t i = 0; i < l_changedCount; i++)
 	{
-		std::sort(parentNode->childrenPDCs.begin(), parentNode->childrenPDCs.end(), [&](PhysicsDataComponent* A, PhysicsDataComponent* B)
-		{
-			return A->m_AABBWS.m_boundMin.x < B->m_AABBWS.m_boundMin.x;
-		});
+		auto l_cullingProxyIndex = m_ChangedCullingProxyIndices[i];
+		auto l_PDC = m_CullingProxies[l_cullingProxyIndex].m_PDC;
+
+		l_PDC->m_AABBWS = m_ChangedBoundsWS[i];
+		l_PDC->m_SphereWS = InnoMath::generateBoundSphere(l_PDC->m_AABBWS);
+		m_CullingProxyBounds[l_cullingProxyIndex] = l_PDC->m_AABBWS;
 	}
-	else if (l_maxAxis == 1)
+
+	if (m_ChangedCullingProxyIndices.empty())
 	{
-		std::sort(parentNode->childrenPDCs.begin(), parentNode->childrenPDCs.end(), [&](PhysicsDataComponent* A, PhysicsDataComponent* B)
-		{
-			return A->m_AABBWS.m_boundMin.y < B->m_AABBWS.m_boundMin.y;
-		});
+		return;
 	}
-	else
+
+	InnoBVH::Refit(m_BVH, m_CullingProxyBounds.data(), m_ChangedCullingProxyIndices.data(), m_ChangedCullingProxyIndices.size());
+
+	if (!m_BVHRebuildTask && InnoBVH::GetNormalizedSAHCost(m_BVH) > m_BVHBuildSAHCost * m_BVHRebuildThreshold)
 	{
-		std::sort(parentNode->childrenPDCs.begin(), parentNode->childrenPDCs.end(), [&](PhysicsDataComponent* A, PhysicsDataComponent* B)
+		InnoLogger::Log(LogLevel::Verbose, "PhysicsSystem: BVH quality degraded, start rebuilding in background.");
+
+		m_PendingBVHBounds = m_CullingProxyBounds;
+		m_BVHRebuildTask = g_pModuleManager->getTaskSystem()->submit("BVHRebuildTask", -1, nullptr, [&]()
 		{
-			return A->m_AABBWS.m_boundMin.z < B->m_AABBWS.m_boundMin.z;
+			InnoBVH::Build(m_PendingBVH, m_PendingBVHBounds.data(), m_PendingBVHBounds.size());
 		});
 	}
+}
+
+void InnoPhysicsSystem::updateBVH()
+{
+	std::unique_lock<std::shared_mutex> lock{ m_SceneQueryContext.m_Mutex };
 
-	// Construct middle split points
-	auto l_midMin = parentNode->intermediatePDC->m_AABBWS.m_boundMin;
-	auto l_midMax = parentNode->intermediatePDC->m_AABBWS.m_boundMax;
+	auto l_isSceneChanged = m_VisibleComponentQuery.Update(g_pModuleManager->getSceneHierarchyManager());
+	size_t l_BVHWorkloadCount = m_BVHWorkloadCount;
 
-	//And sort children nodes
-	if (l_maxAxis == 0)
+	if (l_isSceneChanged || l_BVHWorkloadCount)
 	{
-		l_midMin.x += l_maxAxisLength / 2.0f;
-		l_midMax.x -= l_maxAxisLength / 2.0f;
+		rebuildBVH();
+		m_BVHWorkloadCount -= l_BVHWorkloadCount;
 	}
-	else if (l_maxAxis == 1)
+	else
 	{
-		l_midMin.y += l_maxAxisLength / 2.0f;
-		l_midMax.y -= l_maxAxisLength / 2.0f;
+		refitBVH();
 	}
-	else
+}
+
+// Moller-Trumbore against the triangles in the local space of the mesh, the distance along the ray is the same in both spaces
+float InnoPhysicsSystemNS::raycastMesh(const CullingProxy& cullingProxy, const Vec4& origin, const Vec4& direction, float boundsDistance, float maxDistance)
+{
+	auto l_mesh = cullingProxy.m_PDC->m_ModelPair.first;
+
+	if (!l_mesh || l_mesh->m_meshPrimitiveTopology != MeshPrimitiveTopology::Triangle || l_mesh->m_indices.size() < 3)
 	{
-		l_midMin.z += l_maxAxisLength / 2.0f;
-		l_midMax.z -= l_maxAxisLength / 2.0f;
+		return boundsDistance;
 	}
 
-	// Split children nodes
-	std::vector<PhysicsDataComponent*> l_leftChildrenPDCs;
-	std::vector<PhysicsDataComponent*> l_rightChildrenPDCs;
+	auto l_invM = cullingProxy.m_Transformation.inverse();
+	auto l_direction = direction;
+	l_direction.w = 0.0f;
+#ifdef USE_COLUMN_MAJOR_MEMORY_LAYOUT
+	auto l_originLS = InnoMath::mul(origin, l_invM);
+	auto l_directionLS = InnoMath::mul(l_direction, l_invM);
+#endif
+#ifdef USE_ROW_MAJOR_MEMORY_LAYOUT
+	auto l_originLS = InnoMath::mul(l_invM, origin);
+	auto l_directionLS = InnoMath::mul(l_invM, l_direction);
+#endif
+
+	auto l_closestDistance = -1.0f;
+	auto l_triangleCount = l_mesh->m_indices.size() / 3;
+
+	for (size_t i = 0; i < l_triangleCount; i++)
+	{
+		auto& l_p0 = l_mesh->m_vertices[l_mesh->m_indices[i * 3]].m_pos;
+		auto& l_p1 = l_mesh->m_vertices[l_mesh->m_indices[i * 3 + 1]].m_pos;
+		auto& l_p2 = l_mesh->m_vertices[l_mesh->m_indices[i * 3 + 2]].m_pos;
+
+		auto l_edge1 = l_p1 - l_p0;
+		auto l_edge2 = l_p2 - l_p0;
+		l_edge1.w = 0.0f;
+		l_edge2.w = 0.0f;
 
-	auto l_totalChildrenPDCCount = parentNode->childrenPDCs.size();
+		auto l_p = l_directionLS.cross(l_edge2);
+		auto l_det = l_edge1.x * l_p.x + l_edge1.y * l_p.y + l_edge1.z * l_p.z;
 
-	l_leftChildrenPDCs.reserve(l_totalChildrenPDCCount);
-	l_rightChildrenPDCs.reserve(l_totalChildrenPDCCount);
+		// The back faces are hit too, only the triangles parallel to the ray are skipped
+		if (std::abs(l_det) < std::numeric_limits<float>::epsilon())
+		{
+			continue;
+		}
 
-	for (size_t i = 0; i < l_totalChildrenPDCCount; i++)
+		auto l_invDet = 1.0f / l_det;
+		auto l_t = l_originLS - l_p0;
+		auto l_u = (l_t.x * l_p.x + l_t.y * l_p.y + l_t.z * l_p.z) * l_invDet;
+		if (l_u < 0.0f || l_u > 1.0f)
+		{
+			continue;
+		}
+
+		l_t.w = 0.0f;
+		auto l_q = l_t.cross(l_edge1);
+		auto l_v = (l_directionLS.x * l_q.x + l_directionLS.y * l_q.y + l_directionLS.z * l_q.z) * l_invDet;
+		if (l_v < 0.0f || l_u + l_v > 1.0f)
+		{
+			continue;
+		}
+
+		auto l_distance = (l_edge2.x * l_q.x + l_edge2.y * l_q.y + l_edge2.z * l_q.z) * l_invDet;
+		if (l_distance >= 0.0f && l_distance <= maxDistance)
+		{
+			maxDistance = l_distance;
+			l_closestDistance = l_distance;
+		}
+	}
+
+	return l_closestDistance;
+}
+
+// Called under the shared side of the mutex by InnoSceneQuery
+void InnoPhysicsSystemNS::executeSceneQueries(SceneQueryBatch& batch)
+{
+	auto l_raycastCount = batch.m_Raycasts.size();
+	batch.m_RaycastResults.clear();
+	batch.m_RaycastResults.resize(l_raycastCount);
+
+	g_pModuleManager->getTaskSystem()->parallelFor("SceneRaycastTask", l_raycastCount, m_SceneQueryGrainSize, [&](size_t begin, size_t end)
 	{
-		if (l_maxAxis == 0)
+		for (auto i = begin; i < end; i++)
 		{
-			if (parentNode->childrenPDCs[i]->m_AABBWS.m_boundMax.x < l_midMin.x)
+			auto& l_query = batch.m_Raycasts[i];
+			auto& l_result = batch.m_RaycastResults[i];
+			auto l_isRay = l_query.m_Extent.x == 0.0f && l_query.m_Extent.y == 0.0f && l_query.m_Extent.z == 0.0f;
+
+			BVHRaycastCallback l_callback;
+			if (l_isRay && l_query.m_TestTriangles)
 			{
-				l_leftChildrenPDCs.emplace_back(parentNode->childrenPDCs[i]);
+				l_callback = [&](uint32_t primitiveIndex, float boundsDistance, float maxDistance)
+				{
+					return raycastMesh(m_CullingProxies[primitiveIndex], l_query.m_Origin, l_query.m_Direction, boundsDistance, maxDistance);
+				};
 			}
-			else
+
+			uint32_t l_primitiveIndex;
+			l_result.m_IsHit = InnoBVH::Raycast(m_BVH, l_query.m_Origin, l_query.m_Direction, l_query.m_Extent, l_query.m_MaxDistance, l_callback, l_primitiveIndex, l_result.m_Distance);
+
+			if (l_result.m_IsHit)
 			{
-				l_rightChildrenPDCs.emplace_back(parentNode->childrenPDCs[i]);
+				auto& l_cullingProxy = m_CullingProxies[l_primitiveIndex];
+				l_result.m_Position = l_query.m_Origin + l_query.m_Direction * l_result.m_Distance;
+				l_result.m_Position.w = 1.0f;
+				l_result.m_VisibleComponent = l_cullingProxy.m_VisibleComponent;
+				l_result.m_PDC = l_cullingProxy.m_PDC;
 			}
 		}
-		else if (l_maxAxis == 1)
+	});
+
+	// Every overlap collects into its own list, then they're merged in the query order
+	auto l_overlapCount = batch.m_Overlaps.size();
+	std::vector<std::vector<uint32_t>> l_overlapHits(l_overlapCount);
+
+	g_pModuleManager->getTaskSystem()->parallelFor("SceneOverlapTask", l_overlapCount, m_SceneQueryGrainSize, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
 		{
-			if (parentNode->childrenPDCs[i]->m_AABBWS.m_boundMax.y < l_midMin.y)
-			{
-				l_leftChildrenPDCs.emplace_back(parentNode->childrenPDCs[i]);
-			}
-			else
-			{
-				l_rightChildrenPDCs.emplace_back(parentNode->childrenPDCs[i]);
-			}
+			InnoBVH::Overlap(m_BVH, batch.m_Overlaps[i], l_overlapHits[i]);
 		}
-		else
+	});
+
+	batch.m_OverlapResultOffsets.resize(l_overlapCount + 1);
+	batch.m_OverlapResultOffsets[0] = 0;
+	for (size_t i = 0; i < l_overlapCount; i++)
+	{
+		batch.m_OverlapResultOffsets[i + 1] = batch.m_OverlapResultOffsets[i] + l_overlapHits[i].size();
+	}
+
+	batch.m_OverlapResults.resize(batch.m_OverlapResultOffsets[l_overlapCount]);
+	for (size_t i = 0; i < l_overlapCount; i++)
+	{
+		for (size_t j = 0; j < l_overlapHits[i].size(); j++)
 		{
-			if (parentNode->childrenPDCs[i]->m_AABBWS.m_boundMax.z < l_midMin.z)
-			{
-				l_leftChildrenPDCs.emplace_back(parentNode->childrenPDCs[i]);
-			}
-			else
-			{
-				l_rightChildrenPDCs.emplace_back(parentNode->childrenPDCs[i]);
-			}
+			batch.m_OverlapResults[batch.m_OverlapResultOffsets[i] + j] = m_CullingProxies[l_overlapHits[i][j]].m_PDC;
 		}
 	}
+}
 
-	parentNode->childrenPDCs.clear();
-	parentNode->childrenPDCs.shrink_to_fit();
+float InnoPhysicsSystemNS::getScreenSize(const CullingProxy& cullingProxy, const Vec4& cameraPos, float pixelsPerUnit)
+{
+	return InnoCulling::GetScreenSize(cullingProxy.m_PDC->m_SphereWS, cameraPos, pixelsPerUnit);
+}
+
+TransformMatrix InnoPhysicsSystemNS::getRenderingTransformMatrix(const TransformComponent* transformComponent)
+{
+	auto& l_current = transformComponent->m_globalTransformMatrix;
+	auto& l_previous = transformComponent->m_globalTransformMatrix_prev;
 
-	// Add intermediate nodes and store children PDC
-	if (l_leftChildrenPDCs.size() > 0)
+	// The rendering is between the last two simulation steps, the still objects don't need to be interpolated
+	if (std::memcmp(&l_current.m_transformationMat, &l_previous.m_transformationMat, sizeof(Mat4)))
 	{
-		m_BVHNodes.emplace_back();
-		auto l_leftBVHNode = &m_BVHNodes[m_BVHNodes.size() - 1];
+		return InnoMath::interpolateTransformMatrix(l_previous, l_current, g_pModuleManager->getInterpolationFactor());
+	}
 
-		parentNode->leftChildNode = l_leftBVHNode;
-		l_leftBVHNode->parentNode = parentNode;
-		l_leftBVHNode->depth = parentNode->depth + 1;
-		l_leftBVHNode->childrenPDCs = std::move(l_leftChildrenPDCs);
-		l_leftBVHNode->childrenPDCs.shrink_to_fit();
+	return l_current;
+}
 
-		if (l_leftChildrenPDCs.size() != 1)
-		{
-			auto l_leftPDC = AddPhysicsDataComponent(parentNode->intermediatePDC->m_ParentEntity);
+AABB InnoPhysicsSystemNS::getOccludeeBounds(uint32_t cullingProxyIndex)
+{
+	auto& l_cullingProxy = m_CullingProxies[cullingProxyIndex];
+	auto& l_current = l_cullingProxy.m_TransformComponent->m_globalTransformMatrix;
+	auto& l_previous = l_cullingProxy.m_TransformComponent->m_globalTransformMatrix_prev;
+	auto& l_bounds = m_CullingProxyBounds[cullingProxyIndex];
 
-			l_leftPDC->m_AABBWS = InnoMath::generateAABB(l_midMax, parentNode->intermediatePDC->m_AABBWS.m_boundMin);
-			l_leftPDC->m_SphereWS = InnoMath::generateBoundSphere(l_leftPDC->m_AABBWS);
-			l_leftPDC->m_IsIntermediate = true;
+	if (!std::memcmp(&l_current.m_transformationMat, &l_previous.m_transformationMat, sizeof(Mat4)))
+	{
+		return l_bounds;
+	}
 
-			m_IntermediateComponents.emplace_back(l_leftPDC);
+	// The occluders are drawn between the last two simulation steps, so a moving occludee is tested with the bounds of both
+	auto l_previousBounds = InnoMath::transformAABBSpace(l_cullingProxy.m_PDC->m_AABBLS, l_previous.m_transformationMat);
 
-			l_leftBVHNode->intermediatePDC = l_leftPDC;
+	return InnoMath::generateAABB(InnoMath::elementWiseMax(l_bounds.m_boundMax, l_previousBounds.m_boundMax), InnoMath::elementWiseMin(l_bounds.m_boundMin, l_previousBounds.m_boundMin));
+}
+
+void InnoPhysicsSystemNS::updateOcclusionCulling(const Mat4& VP, const Vec4& cameraPos)
+{
+	auto l_taskSystem = g_pModuleManager->getTaskSystem();
+
+	// 1. Rank the visible meshes by the solid angle of their bound spheres
+	m_OccluderCandidates.clear();
+
+	for (auto i : m_VisibleCullingProxyIndices)
+	{
+		auto& l_cullingProxy = m_CullingProxies[i];
+		auto l_mesh = l_cullingProxy.m_PDC->m_ModelPair.first;
+
+		if (l_cullingProxy.m_VisibleComponent->m_visibilityType != VisibilityType::Opaque
+			|| l_mesh == nullptr
+			|| l_mesh->m_ObjectStatus != ObjectStatus::Activated
+			|| l_mesh->m_meshPrimitiveTopology != MeshPrimitiveTopology::Triangle
+			|| l_mesh->m_indicesSize < 3
+			|| l_mesh->m_vertices.size() == 0)
+		{
+			continue;
 		}
+
+		auto& l_sphere = l_cullingProxy.m_PDC->m_SphereWS;
+		auto l_distance = (l_sphere.m_center - cameraPos).length();
+		auto l_score = l_sphere.m_radius * l_sphere.m_radius / std::max(l_distance * l_distance, 1e-4f);
+
+		m_OccluderCandidates.emplace_back(l_score, i);
 	}
 
-	if (l_rightChildrenPDCs.size() > 0)
+	auto l_candidateCount = std::min(m_OccluderCandidates.size(), m_MaxOccluderCount);
+	std::partial_sort(m_OccluderCandidates.begin(), m_OccluderCandidates.begin() + l_candidateCount, m_OccluderCandidates.end(), [](const std::pair<float, uint32_t>& lhs, const std::pair<float, uint32_t>& rhs)
 	{
-		m_BVHNodes.emplace_back();
-		auto l_rightBVHNode = &m_BVHNodes[m_BVHNodes.size() - 1];
+		return lhs.first != rhs.first ? lhs.first > rhs.first : lhs.second < rhs.second;
+	});
 
-		parentNode->rightChildNode = l_rightBVHNode;
-		l_rightBVHNode->parentNode = parentNode;
-		l_rightBVHNode->depth = parentNode->depth + 1;
-		l_rightBVHNode->childrenPDCs = std::move(l_rightChildrenPDCs);
-		l_rightBVHNode->childrenPDCs.shrink_to_fit();
+	// 2. Take the occluders within the triangle budget
+	m_Occluders.clear();
+	size_t l_triangleCount = 0;
+	size_t l_screenVertexCount = 0;
+
+	for (size_t i = 0; i < l_candidateCount; i++)
+	{
+		auto& l_cullingProxy = m_CullingProxies[m_OccluderCandidates[i].second];
+		auto l_mesh = l_cullingProxy.m_PDC->m_ModelPair.first;
 
-		if (l_rightChildrenPDCs.size() != 1)
+		if (l_triangleCount + l_mesh->m_indicesSize / 3 > m_MaxOccluderTriangleCount)
 		{
-			auto l_rightPDC = AddPhysicsDataComponent(parentNode->intermediatePDC->m_ParentEntity);
+			continue;
+		}
+		l_triangleCount += l_mesh->m_indicesSize / 3;
 
-			l_rightPDC->m_AABBWS = InnoMath::generateAABB(parentNode->intermediatePDC->m_AABBWS.m_boundMax, l_midMin);
-			l_rightPDC->m_SphereWS = InnoMath::generateBoundSphere(l_rightPDC->m_AABBWS);
-			l_rightPDC->m_IsIntermediate = true;
+		Occluder l_occluder;
+		l_occluder.m_Mesh = l_mesh;
+		// Rasterized with the same transform as the rendering frontend draws the mesh
+		l_occluder.m_WVP = VP * getRenderingTransformMatrix(l_cullingProxy.m_TransformComponent).m_transformationMat;
+		l_occluder.m_ScreenVertexOffset = l_screenVertexCount;
+		l_screenVertexCount += l_mesh->m_vertices.size();
 
-			m_IntermediateComponents.emplace_back(l_rightPDC);
+		m_Occluders.emplace_back(l_occluder);
+	}
 
-			l_rightBVHNode->intermediatePDC = l_rightPDC;
-		}
+	InnoOcclusionCulling::Clear(m_OcclusionBuffer, m_OcclusionBufferWidth, m_OcclusionBufferHeight);
+
+	if (m_Occluders.empty())
+	{
+		return;
 	}
 
-	return true;
-}
+	// 3. Transform the occluders, then every worker rasterizes all of them into its own rows
+	m_OccluderScreenVertices.resize(l_screenVertexCount);
 
-void generateBVH(BVHNode* node)
-{
-	if (node)
+	l_taskSystem->parallelFor("OccluderTransformTask", m_Occluders.size(), 1, [&](size_t begin, size_t end)
 	{
-		if (node->intermediatePDC)
+		for (auto i = begin; i < end; i++)
 		{
-			generateBVHLeafNodes(node);
+			auto& l_occluder = m_Occluders[i];
+			InnoOcclusionCulling::TransformOccluderVertices(m_OcclusionBuffer, l_occluder.m_WVP, &l_occluder.m_Mesh->m_vertices[0], l_occluder.m_Mesh->m_vertices.size(), &m_OccluderScreenVertices[l_occluder.m_ScreenVertexOffset]);
 		}
+	});
 
-		if (node->depth < m_maxBVHDepth)
+	auto l_bandCount = (m_OcclusionBuffer.m_Height + m_OcclusionBufferBandHeight - 1) / m_OcclusionBufferBandHeight;
+
+	l_taskSystem->parallelFor("OccluderRasterizationTask", l_bandCount, 1, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
 		{
-			generateBVH(node->leftChildNode);
-			generateBVH(node->rightChildNode);
+			auto l_rowBegin = (uint32_t)i * m_OcclusionBufferBandHeight;
+			for (auto& j : m_Occluders)
+			{
+				InnoOcclusionCulling::RasterizeOccluder(m_OcclusionBuffer, &m_OccluderScreenVertices[j.m_ScreenVertexOffset], &j.m_Mesh->m_indices[0], j.m_Mesh->m_indicesSize, l_rowBegin, l_rowBegin + m_OcclusionBufferBandHeight);
+			}
 		}
-	}
-}
+	});
 
-void InnoPhysicsSystem::updateBVH()
-{
-	if (m_BVHWorkloadCount)
+	InnoOcclusionCulling::UpdateHierarchy(m_OcclusionBuffer);
+
+	// 4. Test the frustum culling survivors, each worker writes only its own range of the results
+	auto l_visibleCount = m_VisibleCullingProxyIndices.size();
+	m_OccludeeVisibilities.resize(l_visibleCount);
+
+	l_taskSystem->parallelFor("OccludeeTestTask", l_visibleCount, 256, [&](size_t begin, size_t end)
 	{
-		for (size_t i = 0; i < m_IntermediateComponents.size(); i++)
+		for (auto i = begin; i < end; i++)
 		{
-			m_PhysicsDataComponentPool->Destroy(m_IntermediateComponents[i]);
+			m_OccludeeVisibilities[i] = InnoOcclusionCulling::TestOccludee(m_OcclusionBuffer, VP, getOccludeeBounds(m_VisibleCullingProxyIndices[i]));
 		}
+	});
 
-		m_IntermediateComponents.clear();
-		m_BVHNodes.clear();
+	size_t l_visibleIndex = 0;
+	for (size_t i = 0; i < l_visibleCount; i++)
+	{
+		auto l_cullingProxyIndex = m_VisibleCullingProxyIndices[i];
+		if (m_OccludeeVisibilities[i])
+		{
+			m_VisibleCullingProxyIndices[l_visibleIndex++] = l_cullingProxyIndex;
+		}
+		else
+		{
+			m_CullingProxyVisibilities[l_cullingProxyIndex] = false;
+		}
+	}
+	m_VisibleCullingProxyIndices.resize(l_visibleIndex);
+}
 
-		// Result
-		m_BVHNodes.emplace_back();
-		m_RootBVHNode = &m_BVHNodes[m_BVHNodes.size() - 1];
+bool InnoPhysicsSystemNS::generateShadowCascadeFrustums()
+{
+	m_ShadowCascadeFrustums.clear();
 
-		m_RootBVHNode->intermediatePDC = m_RootPhysicsDataComponent;
-		m_RootBVHNode->childrenPDCs = m_Components;
+	auto l_sun = GetComponentManager(LightComponent)->GetSun();
+	if (l_sun == nullptr)
+	{
+		return false;
+	}
 
-		generateBVH(m_RootBVHNode);
+	auto l_sunTransformComponent = GetComponent(TransformComponent, l_sun->m_ParentEntity);
+	if (l_sunTransformComponent == nullptr)
+	{
+		return false;
+	}
 
-		m_BVHWorkloadCount = 0;
+	auto& l_splitAABBLS = GetComponentManager(LightComponent)->GetSunSplitAABBLS();
+	if (l_splitAABBLS.empty())
+	{
+		return false;
 	}
-}
 
-void PlainCulling(const Frustum& frustum, std::vector<CullingData>& cullingDatas)
-{
-	auto l_visibleComponents = GetComponentManager(VisibleComponent)->GetAllComponents();
+	// The light space is the inverse rotation of the sun, so its axes in world space are the columns of the rotation
+	auto l_lightRotMat = l_sunTransformComponent->m_globalTransformMatrix.m_rotationMat;
+	Vec4 l_axes[3] = { Vec4(1.0f, 0.0f, 0.0f, 0.0f), Vec4(0.0f, 1.0f, 0.0f, 0.0f), Vec4(0.0f, 0.0f, 1.0f, 0.0f) };
+
+	for (size_t i = 0; i < 3; i++)
+	{
+#ifdef USE_COLUMN_MAJOR_MEMORY_LAYOUT
+		l_axes[i] = InnoMath::mul(l_axes[i], l_lightRotMat);
+#endif
+#ifdef USE_ROW_MAJOR_MEMORY_LAYOUT
+		l_axes[i] = InnoMath::mul(l_lightRotMat, l_axes[i]);
+#endif
+	}
+
+	auto l_towardSun = InnoMath::getDirection(Direction::Backward, l_sunTransformComponent->m_globalTransformVector.m_rot);
 
-	for (auto visibleComponent : l_visibleComponents)
+	for (auto& i : l_splitAABBLS)
 	{
-		if (visibleComponent->m_visibilityType != VisibilityType::Invisible && visibleComponent->m_ObjectStatus == ObjectStatus::Activated)
+		Frustum l_frustum;
+		Plane* l_planes[6] = { &l_frustum.m_px, &l_frustum.m_nx, &l_frustum.m_py, &l_frustum.m_ny, &l_frustum.m_pz, &l_frustum.m_nz };
+		float l_boundMax[3] = { i.m_boundMax.x, i.m_boundMax.y, i.m_boundMax.z };
+		float l_boundMin[3] = { i.m_boundMin.x, i.m_boundMin.y, i.m_boundMin.z };
+
+		size_t l_sunFacingPlaneIndex = 0;
+		float l_sunFacingPlaneCosine = -1.0f;
+
+		for (size_t j = 0; j < 6; j++)
 		{
-			auto l_transformComponent = GetComponent(TransformComponent, visibleComponent->m_ParentEntity);
-			auto l_globalTm = l_transformComponent->m_globalTransformMatrix.m_transformationMat;
+			auto l_axisIndex = j / 2;
+			auto l_isPositive = (j % 2) == 0;
 
-			for (auto i : visibleComponent->m_PDCs)
-			{
-				auto l_PDC = i;
+			l_planes[j]->m_normal = l_isPositive ? l_axes[l_axisIndex] : l_axes[l_axisIndex] * -1.0f;
+			l_planes[j]->m_distance = l_isPositive ? l_boundMax[l_axisIndex] : -l_boundMin[l_axisIndex];
 
-				if (l_PDC)
-				{
-					CullingData l_cullingData;
-
-					l_cullingData.m = l_globalTm;
-					l_cullingData.m_prev = l_transformComponent->m_globalTransformMatrix_prev.m_transformationMat;
-					l_cullingData.normalMat = l_transformComponent->m_globalTransformMatrix.m_rotationMat;
-					l_cullingData.mesh = l_PDC->m_ModelPair.first;
-					l_cullingData.material = l_PDC->m_ModelPair.second;
-					l_cullingData.visibilityType = visibleComponent->m_visibilityType;
-					l_cullingData.meshUsageType = visibleComponent->m_meshUsageType;
-					l_cullingData.UUID = visibleComponent->m_UUID;
-
-					if (visibleComponent->m_meshUsageType == MeshUsageType::Dynamic)
-					{
-						l_PDC->m_AABBWS = InnoMath::transformAABBSpace(l_PDC->m_AABBLS, l_globalTm);
-						l_PDC->m_SphereWS = generateBoundSphere(l_PDC->m_AABBWS);
-					}
-
-					if (InnoMath::intersectCheck(frustum, l_PDC->m_SphereWS))
-					{
-						updateVisibleSceneBoundary(l_PDC->m_AABBWS);
-						l_cullingData.cullingDataChannel = CullingDataChannel::MainCamera;
-					}
-					else
-					{
-						//@TODO: Culling from sun
-						l_cullingData.cullingDataChannel = CullingDataChannel::Shadow;
-					}
-
-					cullingDatas.emplace_back(l_cullingData);
-
-					updateTotalSceneBoundary(l_PDC->m_AABBWS);
-				}
+			auto l_cosine = l_planes[j]->m_normal * l_towardSun;
+			if (l_cosine > l_sunFacingPlaneCosine)
+			{
+				l_sunFacingPlaneCosine = l_cosine;
+				l_sunFacingPlaneIndex = j;
 			}
 		}
+
+		// The casters between the sun and the cascade still throw shadow into it
+		l_planes[l_sunFacingPlaneIndex]->m_distance = std::numeric_limits<float>::max();
+
+		m_ShadowCascadeFrustums.emplace_back(l_frustum);
 	}
+
+	return true;
 }
 
-CullingData generateCullingData(const Frustum& frustum, PhysicsDataComponent* PDC)
+void InnoPhysicsSystemNS::generateCullingData(CullingProxy& cullingProxy, bool isVisible, uint32_t shadowCascadeMask, CullingChunk& cullingChunk)
 {
-	auto l_transformComponent = GetComponent(TransformComponent, PDC->m_VisibleComponent->m_ParentEntity);
-	auto l_globalTm = l_transformComponent->m_globalTransformMatrix.m_transformationMat;
+	auto l_visibleComponent = cullingProxy.m_VisibleComponent;
+	if (l_visibleComponent->m_visibilityType == VisibilityType::Invisible)
+	{
+		return;
+	}
 
-	if (PDC->m_VisibleComponent->m_meshUsageType == MeshUsageType::Dynamic)
+	if (!isVisible && !shadowCascadeMask)
 	{
-		PDC->m_AABBWS = InnoMath::transformAABBSpace(PDC->m_AABBLS, l_globalTm);
-		PDC->m_SphereWS = generateBoundSphere(PDC->m_AABBWS);
+		return;
 	}
 
+	auto l_PDC = cullingProxy.m_PDC;
+	auto l_transformComponent = cullingProxy.m_TransformComponent;
+
 	CullingData l_cullingData;
 
-	l_cullingData.m = l_globalTm;
-	l_cullingData.m_prev = l_transformComponent->m_globalTransformMatrix_prev.m_transformationMat;
-	l_cullingData.normalMat = l_transformComponent->m_globalTransformMatrix.m_rotationMat;
-	l_cullingData.mesh = PDC->m_ModelPair.first;
-	l_cullingData.material = PDC->m_ModelPair.second;
-	l_cullingData.visibilityType = PDC->m_VisibleComponent->m_visibilityType;
-	l_cullingData.meshUsageType = PDC->m_VisibleComponent->m_meshUsageType;
-	l_cullingData.UUID = PDC->m_VisibleComponent->m_UUID;
+	auto l_transformMatrix = getRenderingTransformMatrix(l_transformComponent);
 
-	if (InnoMath::intersectCheck(frustum, PDC->m_SphereWS))
+	l_cullingData.m = l_transformMatrix.m_transformationMat;
+	l_cullingData.normalMat = l_transformMatrix.m_rotationMat;
+	// The motion is between the rendered frames, a proxy which wasn't output by the last pass has no motion
+	l_cullingData.m_prev = cullingProxy.m_RenderedCullingIndex + 1 == m_CullingIndex ? cullingProxy.m_RenderedTransformation : l_cullingData.m;
+	cullingProxy.m_RenderedTransformation = l_cullingData.m;
+	cullingProxy.m_RenderedCullingIndex = m_CullingIndex;
+	l_cullingData.mesh = l_PDC->m_ModelPair.first;
+	l_cullingData.material = l_PDC->m_ModelPair.second;
+	l_cullingData.visibilityType = l_visibleComponent->m_visibilityType;
+	l_cullingData.meshUsageType = l_visibleComponent->m_meshUsageType;
+	l_cullingData.UUID = l_visibleComponent->m_UUID;
+	l_cullingData.PDC = l_PDC;
+
+	l_cullingData.shadowCascadeMask = shadowCascadeMask;
+
+	if (isVisible)
 	{
-		updateVisibleSceneBoundary(PDC->m_AABBWS);
-		l_cullingData.cullingDataChannel = CullingDataChannel::MainCamera;
+		cullingChunk.m_VisibleSceneBoundMax = InnoMath::elementWiseMax(l_PDC->m_AABBWS.m_boundMax, cullingChunk.m_VisibleSceneBoundMax);
+		cullingChunk.m_VisibleSceneBoundMin = InnoMath::elementWiseMin(l_PDC->m_AABBWS.m_boundMin, cullingChunk.m_VisibleSceneBoundMin);
+		l_cullingData.cullingDataChannel = shadowCascadeMask ? CullingDataChannel::All : CullingDataChannel::MainCamera;
 	}
 	else
 	{
-		//@TODO: Culling from sun
 		l_cullingData.cullingDataChannel = CullingDataChannel::Shadow;
 	}
 
-	return l_cullingData;
-}
+	cullingChunk.m_CullingData.emplace_back(l_cullingData);
 
-void BVHCulling(BVHNode* node, const Frustum& frustum, std::vector<CullingData>& cullingDatas)
-{
-	if (node->intermediatePDC)
-	{
-		if (InnoMath::intersectCheck(frustum, node->intermediatePDC->m_SphereWS))
-		{
-			if (node->leftChildNode)
-			{
-				BVHCulling(node->leftChildNode, frustum, cullingDatas);
-			}
-			if (node->rightChildNode)
-			{
-				BVHCulling(node->rightChildNode, frustum, cullingDatas);
-			}
-		}
-	}
-	auto l_PDCCount = node->childrenPDCs.size();
-	for (size_t i = 0; i < l_PDCCount; i++)
-	{
-		auto l_PDC = node->childrenPDCs[i];
-		auto l_cullingData = generateCullingData(frustum, l_PDC);
-
-		cullingDatas.emplace_back(l_cullingData);
-	}
+	cullingChunk.m_TotalSceneBoundMax = InnoMath::elementWiseMax(l_PDC->m_AABBWS.m_boundMax, cullingChunk.m_TotalSceneBoundMax);
+	cullingChunk.m_TotalSceneBoundMin = InnoMath::elementWiseMin(l_PDC->m_AABBWS.m_boundMin, cullingChunk.m_TotalSceneBoundMin);
 }
 
 void InnoPhysicsSystem::updateCulling()
@@ -621,6 +1085,10 @@ void InnoPhysicsSystem::updateCulling()
 		return;
 	}
 
+	std::shared_lock<std::shared_mutex> l_BVHLock{ m_SceneQueryContext.m_Mutex };
+
+	m_CullingIndex++;
+
 	auto l_cameraFrustum = l_mainCamera->m_frustum;
 
 	m_visibleSceneBoundMax = InnoMath::minVec4<float>;
@@ -629,23 +1097,147 @@ void InnoPhysicsSystem::updateCulling()
 	m_visibleSceneBoundMin = InnoMath::maxVec4<float>;
 	m_visibleSceneBoundMin.w = 1.0f;
 
-	auto l_visibleComponents = GetComponentManager(VisibleComponent)->GetAllComponents();
+	m_VisibleCullingProxyIndices.clear();
+	InnoBVH::ParallelCull(m_BVH, l_cameraFrustum, m_VisibleCullingProxyIndices);
+
+	auto l_cameraPos = l_mainCameraTransformComponent->m_globalTransformVector.m_pos;
+	auto l_pixelsPerUnit = InnoCulling::GetPixelsPerUnit(l_mainCamera->m_projectionMatrix, (float)g_pModuleManager->getRenderingFrontend()->getScreenResolution().y);
+
+	m_CullingProxyVisibilities.assign(m_CullingProxies.size(), false);
+
+	size_t l_visibleIndex = 0;
+	for (auto i : m_VisibleCullingProxyIndices)
+	{
+		auto& l_cullingProxy = m_CullingProxies[i];
+		if (getScreenSize(l_cullingProxy, l_cameraPos, l_pixelsPerUnit) >= l_cullingProxy.m_VisibleComponent->m_minScreenSize)
+		{
+			m_CullingProxyVisibilities[i] = true;
+			m_VisibleCullingProxyIndices[l_visibleIndex++] = i;
+		}
+	}
+	m_VisibleCullingProxyIndices.resize(l_visibleIndex);
 
-	std::vector<CullingData> l_cullingDataVector;
-	l_cullingDataVector.reserve(l_visibleComponents.size());
+	if (g_pModuleManager->getRenderingFrontend()->getRenderingConfig().useOcclusionCulling)
+	{
+		// The view matrix of the rendering frontend, see updatePerFrameConstantBuffer()
+		auto l_cameraTransformMatrix = getRenderingTransformMatrix(l_mainCameraTransformComponent);
+		auto r = l_cameraTransformMatrix.m_rotationMat.inverse();
+		auto t = l_cameraTransformMatrix.m_translationMat.inverse();
 
-	PlainCulling(l_cameraFrustum, l_cullingDataVector);
-	//BVHCulling(m_RootBVHNode, l_cameraFrustum, l_cullingDataVector);
+		updateOcclusionCulling(l_mainCamera->m_projectionMatrix * r * t, l_cameraPos);
+	}
+
+	// Without the cascades of this frame every object is treated as a shadow caster, except the ones too small to cast a visible shadow
+	auto l_hasShadowCascades = generateShadowCascadeFrustums();
+	m_CullingProxyShadowCascadeMasks.assign(m_CullingProxies.size(), 0);
+
+	if (!l_hasShadowCascades)
+	{
+		for (size_t i = 0; i < m_CullingProxies.size(); i++)
+		{
+			auto& l_cullingProxy = m_CullingProxies[i];
+			if (getScreenSize(l_cullingProxy, l_cameraPos, l_pixelsPerUnit) >= l_cullingProxy.m_VisibleComponent->m_minShadowScreenSize)
+			{
+				m_CullingProxyShadowCascadeMasks[i] = m_AllShadowCascadesMask;
+			}
+		}
+	}
+
+	auto l_shadowCascadeCount = (uint32_t)m_ShadowCascadeFrustums.size();
+	for (uint32_t i = 0; i < l_shadowCascadeCount; i++)
+	{
+		m_ShadowCasterIndices.clear();
+		InnoBVH::ParallelCull(m_BVH, m_ShadowCascadeFrustums[i], m_ShadowCasterIndices);
+
+		for (auto j : m_ShadowCasterIndices)
+		{
+			auto& l_cullingProxy = m_CullingProxies[j];
+			if (getScreenSize(l_cullingProxy, l_cameraPos, l_pixelsPerUnit) >= l_cullingProxy.m_VisibleComponent->m_minShadowScreenSize)
+			{
+				m_CullingProxyShadowCascadeMasks[j] |= 1u << i;
+			}
+		}
+	}
+
+	auto l_cullingProxyCount = m_CullingProxies.size();
+	auto l_cullingChunkCount = (l_cullingProxyCount + m_CullingChunkSize - 1) / m_CullingChunkSize;
+	m_CullingChunks.resize(l_cullingChunkCount);
+
+	g_pModuleManager->getTaskSystem()->parallelFor("CullingDataTask", l_cullingChunkCount, 1, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			auto& l_cullingChunk = m_CullingChunks[i];
+			l_cullingChunk.m_CullingData.clear();
+			l_cullingChunk.m_VisibleSceneBoundMax = m_visibleSceneBoundMax;
+			l_cullingChunk.m_VisibleSceneBoundMin = m_visibleSceneBoundMin;
+			l_cullingChunk.m_TotalSceneBoundMax = m_totalSceneBoundMax;
+			l_cullingChunk.m_TotalSceneBoundMin = m_totalSceneBoundMin;
+
+			auto l_last = std::min((i + 1) * m_CullingChunkSize, l_cullingProxyCount);
+			for (auto j = i * m_CullingChunkSize; j < l_last; j++)
+			{
+				generateCullingData(m_CullingProxies[j], m_CullingProxyVisibilities[j], m_CullingProxyShadowCascadeMasks[j], l_cullingChunk);
+			}
+		}
+	});
+
+	// Prefix sum of the chunk sizes, then every chunk is copied to its own range so the order is the same as the serial one
+	m_CullingChunkOffsets.resize(l_cullingChunkCount + 1);
+	m_CullingChunkOffsets[0] = 0;
+	for (size_t i = 0; i < l_cullingChunkCount; i++)
+	{
+		auto& l_cullingChunk = m_CullingChunks[i];
+		m_CullingChunkOffsets[i + 1] = m_CullingChunkOffsets[i] + l_cullingChunk.m_CullingData.size();
+
+		m_visibleSceneBoundMax = InnoMath::elementWiseMax(l_cullingChunk.m_VisibleSceneBoundMax, m_visibleSceneBoundMax);
+		m_visibleSceneBoundMin = InnoMath::elementWiseMin(l_cullingChunk.m_VisibleSceneBoundMin, m_visibleSceneBoundMin);
+		m_totalSceneBoundMax = InnoMath::elementWiseMax(l_cullingChunk.m_TotalSceneBoundMax, m_totalSceneBoundMax);
+		m_totalSceneBoundMin = InnoMath::elementWiseMin(l_cullingChunk.m_TotalSceneBoundMin, m_totalSceneBoundMin);
+	}
+
+	auto l_cullingDataBuffer = getFreeCullingDataBuffer();
+	auto& l_cullingDataVector = *l_cullingDataBuffer;
+	l_cullingDataVector.resize(m_CullingChunkOffsets[l_cullingChunkCount]);
+
+	g_pModuleManager->getTaskSystem()->parallelFor("CullingDataMergeTask", l_cullingChunkCount, 1, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			std::copy(m_CullingChunks[i].m_CullingData.begin(), m_CullingChunks[i].m_CullingData.end(), l_cullingDataVector.begin() + m_CullingChunkOffsets[i]);
+		}
+	});
 
 	m_visibleSceneAABB = InnoMath::generateAABB(InnoPhysicsSystemNS::m_visibleSceneBoundMax, InnoPhysicsSystemNS::m_visibleSceneBoundMin);
 	m_totalSceneAABB = InnoMath::generateAABB(InnoPhysicsSystemNS::m_totalSceneBoundMax, InnoPhysicsSystemNS::m_totalSceneBoundMin);
 
-	m_cullingData.SetValue(std::move(l_cullingDataVector));
+	std::lock_guard<std::mutex> lock{ m_latestCullingDataMutex };
+	m_latestCullingData = l_cullingDataBuffer;
 }
 
-const std::vector<CullingData>& InnoPhysicsSystem::getCullingData()
+std::shared_ptr<std::vector<CullingData>> InnoPhysicsSystemNS::getFreeCullingDataBuffer()
 {
-	return InnoPhysicsSystemNS::m_cullingData.GetValue();
+	for (auto& i : m_cullingDataBuffers)
+	{
+		// Only the pool owns it, and nobody could get a new view of it since it's not the latest one
+		if (i.use_count() == 1)
+		{
+			// Pairs with the release of the last view, so its reads are finished before the buffer is overwritten
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return i;
+		}
+	}
+
+	m_cullingDataBuffers.emplace_back(std::make_shared<std::vector<CullingData>>());
+	m_cullingDataBuffers.back()->reserve(m_CullingProxies.capacity());
+
+	return m_cullingDataBuffers.back();
+}
+
+CullingDataView InnoPhysicsSystem::getCullingData()
+{
+	std::lock_guard<std::mutex> lock{ InnoPhysicsSystemNS::m_latestCullingDataMutex };
+	return InnoPhysicsSystemNS::m_latestCullingData;
 }
 
 AABB InnoPhysicsSystem::getVisibleSceneAABB()
@@ -663,9 +1255,12 @@ AABB InnoPhysicsSystem::getTotalSceneAABB()
 	return InnoPhysicsSystemNS::m_totalSceneAABB;
 }
 
-BVHNode * InnoPhysicsSystem::getRootBVHNode()
+std::shared_ptr<IInnoTask> InnoPhysicsSystem::submitSceneQueries(const std::shared_ptr<SceneQueryBatch>& batch)
 {
-	return InnoPhysicsSystemNS::m_RootBVHNode;
+	return InnoSceneQuery::Submit(InnoPhysicsSystemNS::m_SceneQueryContext, "SceneQueryTask", [=]()
+	{
+		InnoPhysicsSystemNS::executeSceneQueries(*batch);
+	});
 }
 
 bool InnoPhysicsSystem::generateAABBInWorldSpace(PhysicsDataComponent* PDC, const Mat4& m)
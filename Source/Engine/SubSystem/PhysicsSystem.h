@@ -18,9 +18,9 @@ public:
 	bool generatePhysicsProxy(VisibleComponent* VC) override;
 	void updateBVH() override;
 	void updateCulling() override;
-	const std::vector<CullingData>& getCullingData() override;
+	CullingDataView getCullingData() override;
 	AABB getVisibleSceneAABB() override;
 	AABB getStaticSceneAABB() override;
 	AABB getTotalSceneAABB() override;
-	BVHNode* getRootBVHNode() override;
+	std::shared_ptr<IInnoTask> submitSceneQueries(const std::shared_ptr<SceneQueryBatch>& batch) override;
 };
@@ -63,6 +63,11 @@ size_t InnoTaskSystem::GetTotalThreadsNumber()
 	return InnoTaskScheduler::GetTotalThreadsNumber();
 }
 
+void InnoTaskSystem::parallelFor(const char* name, size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func)
+{
+	InnoTaskScheduler::ParallelFor(name, count, grainSize, func);
+}
+
 std::shared_ptr<IInnoTask> InnoTaskSystem::addTaskImpl(std::unique_ptr<IInnoTask>&& task, int32_t threadID)
 {
 	return InnoTaskScheduler::AddTaskImpl(std::move(task), threadID);
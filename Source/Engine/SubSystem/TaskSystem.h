@@ -17,6 +17,7 @@ public:
 
 	const RingBuffer<InnoTaskReport, true>& GetTaskReport(int32_t threadID) override;
 	size_t GetTotalThreadsNumber() override;
+	void parallelFor(const char* name, size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func) override;
 
 protected:
 	std::shared_ptr<IInnoTask> addTaskImpl(std::unique_ptr<IInnoTask>&& task, int32_t threadID) override;
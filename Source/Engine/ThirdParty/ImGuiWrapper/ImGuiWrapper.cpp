@@ -229,6 +229,12 @@ void ImGuiWrapperNS::showApplicationProfiler()
 {
 	ImGui::Begin("Profiler", 0, ImGuiWindowFlags_AlwaysAutoResize);
 	ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+
+	static size_t l_lastUploadedBytes = 0;
+	auto l_uploadedBytes = g_pModuleManager->getRenderingServer()->GetUploadedBytes();
+	ImGui::Text("GPU buffer upload %.2f KB/frame", (float)(l_uploadedBytes - l_lastUploadedBytes) / 1024.0f);
+	l_lastUploadedBytes = l_uploadedBytes;
+
 	ImGui::Checkbox("Show concurrency profiler", &m_showConcurrencyProfiler);
 	ImGui::Checkbox("Use Motion Blur", &m_renderingConfig.useMotionBlur);
 	ImGui::Checkbox("Use TAA", &m_renderingConfig.useTAA);
@@ -309,7 +315,7 @@ void ImGuiWrapperNS::showWorldExplorer()
 	{
 		auto l_sceneHierarchyMap = g_pModuleManager->getSceneHierarchyManager()->GetSceneHierarchyMap();
 
-		for (auto& i : l_sceneHierarchyMap)
+		for (auto i : *l_sceneHierarchyMap)
 		{
 			if (i.first->m_ObjectSource == ObjectSource::Asset)
 			{
@@ -317,7 +323,7 @@ void ImGuiWrapperNS::showWorldExplorer()
 				{
 					for (auto& j : i.second)
 					{
-						if (ImGui::Selectable(j->m_ComponentName.c_str(), selectedComponent == j))
+						if (ImGui::Selectable(j->GetDebugName().c_str(), selectedComponent == j))
 						{
 							selectedComponent = j;
 							selectedComponentType = j->m_ComponentType;
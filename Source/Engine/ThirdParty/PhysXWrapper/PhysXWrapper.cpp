@@ -45,7 +45,6 @@ namespace PhysXWrapperNS
 	PxMaterial* gMaterial = nullptr;
 
 	bool m_needSimulate = false;
-	std::atomic<bool> m_allowUpdate = true;
 	std::function<void()> f_sceneLoadingStartCallback;
 	std::function<void()> f_pauseSimulate;
 
@@ -133,37 +132,32 @@ bool PhysXWrapperNS::update()
 {
 	if (m_needSimulate)
 	{
-		if (m_allowUpdate)
+		// One step for each fixed step, it runs in order with the other simulation tasks of the thread 0
+		m_currentTask = g_pModuleManager->getTaskSystem()->submit("PhysXUpdateTask", 0, nullptr, [&]()
 		{
-			m_allowUpdate = false;
+			gScene->simulate(g_pModuleManager->getFixedTimeStep() / 1000.0f);
+			gScene->fetchResults(true);
 
-			m_currentTask = g_pModuleManager->getTaskSystem()->submit("PhysXUpdateTask", 3, nullptr, [&]()
+			for (auto i : PhysXActors)
 			{
-				gScene->simulate(g_pModuleManager->getTickTime() / 1000.0f);
-				gScene->fetchResults(true);
-
-				for (auto i : PhysXActors)
+				if (i.isDynamic)
 				{
-					if (i.isDynamic)
+					PxTransform t = i.m_PxRigidActor->getGlobalPose();
+					PxVec3 p = t.p;
+					PxQuat q = t.q;
+
+					auto l_rigidBody = reinterpret_cast<PxRigidDynamic*>(i.m_PxRigidActor);
+
+					if (l_rigidBody->userData)
 					{
-						PxTransform t = i.m_PxRigidActor->getGlobalPose();
-						PxVec3 p = t.p;
-						PxQuat q = t.q;
-
-						auto l_rigidBody = reinterpret_cast<PxRigidDynamic*>(i.m_PxRigidActor);
-
-						if (l_rigidBody->userData)
-						{
-							auto l_transformComponent = reinterpret_cast<TransformComponent*>(l_rigidBody->userData);
-							l_transformComponent->m_localTransformVector_target.m_pos = Vec4(p.x, p.y, p.z, 1.0f);
-							l_transformComponent->m_localTransformVector_target.m_rot = Vec4(q.x, q.y, q.z, q.w);
-							l_transformComponent->m_localTransformVector = l_transformComponent->m_localTransformVector_target;
-						}
+						auto l_transformComponent = reinterpret_cast<TransformComponent*>(l_rigidBody->userData);
+						l_transformComponent->m_localTransformVector_target.m_pos = Vec4(p.x, p.y, p.z, 1.0f);
+						l_transformComponent->m_localTransformVector_target.m_rot = Vec4(q.x, q.y, q.z, q.w);
+						l_transformComponent->m_localTransformVector = l_transformComponent->m_localTransformVector_target;
 					}
 				}
-				m_allowUpdate = true;
-			});
-		}
+			}
+		});
 	}
 
 	return true;
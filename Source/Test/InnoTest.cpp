@@ -1,9 +1,25 @@
 #include "../Engine/Common/InnoContainer.h"
 #include "../Engine/Common/InnoMathHelper.h"
+#include "../Engine/Common/InnoEntity.h"
+#include "../Engine/Common/InnoComponent.h"
+#include "../Engine/Component/VisibleComponent.h"
 #include "../Engine/Core/InnoTimer.h"
 #include "../Engine/Core/InnoLogger.h"
 #include "../Engine/Core/InnoMemory.h"
 #include "../Engine/Core/InnoTaskScheduler.h"
+#include "../Engine/Core/InnoBVH.h"
+#include "../Engine/Core/InnoSceneQuery.h"
+#include "../Engine/Core/InnoOcclusionCulling.h"
+#include "../Engine/Core/InnoRigidBodyDynamics.h"
+#include "../Engine/Core/InnoRadixSort.h"
+#include "../Engine/Core/InnoStringTable.h"
+#include "../Engine/EntityManager/EntityManager.h"
+#include "../Engine/SceneHierarchyManager/SceneHierarchyManager.h"
+
+class IModuleManager;
+IModuleManager* g_pModuleManager = nullptr;
+InnoEntityManager g_EntityManager;
+InnoSceneHierarchyManager g_SceneHierarchyManager;
 
 void TestIToA(size_t testCaseCount)
 {
@@ -134,6 +150,333 @@ void TestInnoMemory(size_t testCaseCount)
 	InnoMemory::DestroyObjectPool(l_objectPool);
 }
 
+EntityID createEntityID_Legacy()
+{
+	std::stringstream ss;
+	for (uint32_t i = 0; i < 16; i++) {
+		auto rc = []() -> unsigned char {
+			std::random_device rd;
+			std::mt19937 gen(rd());
+			std::uniform_int_distribution<> dis(0, 255);
+			return static_cast<unsigned char>(dis(gen));
+		};
+		std::stringstream hexstream;
+		hexstream << std::hex << int32_t(rc());
+		auto hex = hexstream.str();
+		ss << (hex.length() < 2 ? '0' + hex : hex);
+	}
+
+	auto l_str = ss.str();
+	EntityID result = l_str.c_str();
+	return result;
+}
+
+// The entity manager's pool holds 65536 entities for all the tests, so the spawning of the whole test case count is measured on dedicated pools
+void TestEntitySpawning(size_t testCaseCount, size_t entityManagerTestCaseCount)
+{
+	auto l_legacyEntityPool = InnoMemory::CreateObjectPool<InnoEntity>((uint32_t)testCaseCount);
+	auto l_batchEntityPool = InnoMemory::CreateObjectPool<InnoEntity>((uint32_t)testCaseCount);
+	std::vector<InnoEntity*> l_entities(testCaseCount);
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_entity = InnoMemory::Spawn<InnoEntity>(l_legacyEntityPool);
+		l_entity->m_EntityID = createEntityID_Legacy();
+		l_entity->m_ObjectStatus = ObjectStatus::Activated;
+	}
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	// The same steps as InnoEntityManager::SpawnBatch without the name index
+	auto l_isSpawned = InnoMemory::SpawnBatch<InnoEntity>(l_batchEntityPool, l_entities.data(), testCaseCount);
+	if (l_isSpawned)
+	{
+		for (auto i : l_entities)
+		{
+			i->m_EntityID = InnoMath::createEntityID();
+			i->m_ObjectStatus = ObjectStatus::Activated;
+		}
+	}
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	if (!l_isSpawned)
+	{
+		InnoLogger::Log(LogLevel::Error, "Batch spawning of ", testCaseCount, " entities failed!");
+		return;
+	}
+
+	std::unordered_set<std::string> l_uniqueIDs;
+	l_uniqueIDs.reserve(testCaseCount);
+	for (auto i : l_entities)
+	{
+		l_uniqueIDs.emplace(i->m_EntityID.c_str());
+	}
+
+	InnoMemory::DestroyObjectPool(l_legacyEntityPool);
+	InnoMemory::DestroyObjectPool(l_batchEntityPool);
+
+	if (l_uniqueIDs.size() != testCaseCount)
+	{
+		InnoLogger::Log(LogLevel::Error, "EntityID collision happened in ", testCaseCount, " entities!");
+		return;
+	}
+
+	auto l_Timestamp3 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	auto l_managedEntities = g_EntityManager.SpawnBatch((uint32_t)entityManagerTestCaseCount, ObjectSource::Runtime, ObjectOwnership::Engine, "TestEntity_");
+
+	auto l_Timestamp4 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	if (l_managedEntities.size() != entityManagerTestCaseCount)
+	{
+		InnoLogger::Log(LogLevel::Error, "Batch spawning returned ", l_managedEntities.size(), " entities instead of ", entityManagerTestCaseCount, "!");
+		return;
+	}
+
+	if (!g_EntityManager.SpawnBatch(0, ObjectSource::Runtime, ObjectOwnership::Engine, "TestEntity_").empty())
+	{
+		InnoLogger::Log(LogLevel::Error, "Batch spawning of 0 entities returned entities!");
+		return;
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+
+	InnoLogger::Log(LogLevel::Success, "Spawning ", testCaseCount, " entities took ", (l_Timestamp2 - l_Timestamp1), "us in batch, legacy VS batch speed ratio is ", l_SpeedRatio, ", entity manager spawned ", entityManagerTestCaseCount, " named and indexed entities in ", (l_Timestamp4 - l_Timestamp3), "us");
+}
+
+// Follows JSONParser::loadScene and assignComponentRuntimeData, which need the whole engine: every entity is spawned one by one, then every transform component's parent entity is resolved by name
+void TestEntityNameLookup(size_t testCaseCount)
+{
+	std::vector<std::string> l_entityNames(testCaseCount);
+	std::vector<EntityName> l_parentEntityNames(testCaseCount);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_entityNames[i] = "Entity_" + std::to_string(i) + "/";
+		l_parentEntityNames[i] = ("Entity_" + std::to_string(i / 2) + "/").c_str();
+	}
+
+	std::vector<InnoEntity*> l_entities(testCaseCount);
+
+	auto l_SpawnStartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_entities[i] = g_EntityManager.Spawn(ObjectSource::Asset, ObjectOwnership::Client, l_entityNames[i].c_str());
+	}
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	size_t l_linearFoundCount = 0;
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_parentEntityName = l_parentEntityNames[i].c_str();
+		auto l_result = std::find_if(l_entities.begin(), l_entities.end(), [&](auto val) -> bool {
+			return val->m_EntityName == l_parentEntityName;
+		});
+
+		if (l_result != l_entities.end())
+		{
+			l_linearFoundCount++;
+		}
+	}
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	size_t l_hashedFoundCount = 0;
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_result = g_EntityManager.Find(l_parentEntityNames[i].c_str());
+		if (l_result.has_value() && *l_result == l_entities[i / 2])
+		{
+			l_hashedFoundCount++;
+		}
+	}
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	if (l_linearFoundCount != testCaseCount || l_hashedFoundCount != testCaseCount)
+	{
+		InnoLogger::Log(LogLevel::Error, "Entity name lookup failed, linear found ", l_linearFoundCount, ", hashed found ", l_hashedFoundCount);
+		return;
+	}
+
+	// Duplicated names resolve to the earliest spawned entity, also after renaming it back and forth
+	auto l_duplicatedEntity = g_EntityManager.Spawn(ObjectSource::Runtime, ObjectOwnership::Engine, "Entity_0/");
+	auto l_duplicatedEntityID = l_duplicatedEntity->m_EntityID;
+
+	if (g_EntityManager.Find("Entity_0") != l_entities[0])
+	{
+		InnoLogger::Log(LogLevel::Error, "Entity name lookup didn't return the earliest spawned entity of a duplicated name!");
+		return;
+	}
+
+	g_EntityManager.Rename(l_entities[0], "RenamedEntity_0/");
+
+	if (g_EntityManager.Find("Entity_0") != l_duplicatedEntity || g_EntityManager.Find("RenamedEntity_0") != l_entities[0])
+	{
+		InnoLogger::Log(LogLevel::Error, "Entity name index wasn't re-keyed after renaming!");
+		return;
+	}
+
+	g_EntityManager.Rename(l_entities[0], "Entity_0/");
+
+	if (g_EntityManager.Find("Entity_0") != l_entities[0] || g_EntityManager.Find("RenamedEntity_0").has_value())
+	{
+		InnoLogger::Log(LogLevel::Error, "Entity name lookup lost the spawn order after renaming!");
+		return;
+	}
+
+	g_EntityManager.Destroy(l_duplicatedEntity);
+
+	if (g_EntityManager.Find(l_duplicatedEntityID).has_value())
+	{
+		InnoLogger::Log(LogLevel::Error, "Destroyed entity is still in the ID index!");
+		return;
+	}
+
+	g_EntityManager.Destroy(l_entities[0]);
+
+	if (g_EntityManager.Find("Entity_0").has_value())
+	{
+		InnoLogger::Log(LogLevel::Error, "Destroyed entity is still in the name index!");
+		return;
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+
+	InnoLogger::Log(LogLevel::Success, "Loading a scene of ", testCaseCount, " entities took ", (l_StartTime - l_SpawnStartTime), "us to spawn and ", (l_Timestamp2 - l_Timestamp1), "us to resolve the parent entities with index, linear VS hashed lookup speed ratio is ", l_SpeedRatio);
+}
+
+void TestSceneHierarchy(size_t testCaseCount)
+{
+	auto l_entities = g_EntityManager.SpawnBatch((uint32_t)testCaseCount, ObjectSource::Runtime, ObjectOwnership::Engine, "HierarchyEntity_");
+
+	// Every entity has a transform and a visible component, every eighth one has 8 more to grow its row
+	const size_t l_extraComponentCount = 8;
+	std::vector<InnoComponent> l_components(testCaseCount * 2);
+	std::vector<InnoComponent> l_extraComponents((testCaseCount + 7) / 8 * l_extraComponentCount);
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_components[i * 2].m_ParentEntity = l_entities[i];
+		l_components[i * 2].m_ComponentType = ComponentType::TransformComponent;
+		l_components[i * 2 + 1].m_ParentEntity = l_entities[i];
+		l_components[i * 2 + 1].m_ComponentType = ComponentType::VisibleComponent;
+
+		g_SceneHierarchyManager.RegisterComponent(&l_components[i * 2]);
+		g_SceneHierarchyManager.RegisterComponent(&l_components[i * 2 + 1]);
+
+		if (i % 8 == 0)
+		{
+			for (size_t j = 0; j < l_extraComponentCount; j++)
+			{
+				auto& l_extraComponent = l_extraComponents[i / 8 * l_extraComponentCount + j];
+				l_extraComponent.m_ParentEntity = l_entities[i];
+				l_extraComponent.m_ComponentType = ComponentType::LightComponent;
+				g_SceneHierarchyManager.RegisterComponent(&l_extraComponent);
+			}
+		}
+	}
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	// The per-entity queries don't allocate, the range points into the flat component array
+	size_t l_componentCount = 0;
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_componentCount += g_SceneHierarchyManager.GetComponents(l_entities[i]).size();
+	}
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	if (l_componentCount != l_components.size() + l_extraComponents.size())
+	{
+		InnoLogger::Log(LogLevel::Error, "Scene hierarchy has ", l_componentCount, " components instead of ", l_components.size() + l_extraComponents.size(), "!");
+		return;
+	}
+
+	// Remove the visible component of every even entity and all the components of every fourth entity
+	for (size_t i = 0; i < testCaseCount; i += 2)
+	{
+		g_SceneHierarchyManager.UnregisterComponent(&l_components[i * 2 + 1]);
+
+		if (i % 4 == 0)
+		{
+			g_SceneHierarchyManager.UnregisterComponent(&l_components[i * 2]);
+
+			if (i % 8 == 0)
+			{
+				for (size_t j = 0; j < l_extraComponentCount; j++)
+				{
+					g_SceneHierarchyManager.UnregisterComponent(&l_extraComponents[i / 8 * l_extraComponentCount + j]);
+				}
+			}
+		}
+	}
+
+	auto l_Timestamp3 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	{
+		auto l_sceneHierarchyMap = g_SceneHierarchyManager.GetSceneHierarchyMap();
+
+		for (size_t i = 0; i < testCaseCount; i++)
+		{
+			auto l_row = l_sceneHierarchyMap->Find(l_entities[i]);
+			size_t l_expectedCount = (i % 4 == 0) ? 0 : (i % 2 == 0) ? 1 : 2;
+
+			if (l_row.size() != l_expectedCount || (l_expectedCount && l_row.begin()[0] != &l_components[i * 2]) || (l_expectedCount == 2 && l_row.begin()[1] != &l_components[i * 2 + 1]))
+			{
+				InnoLogger::Log(LogLevel::Error, "Scene hierarchy has ", l_row.size(), " components instead of ", l_expectedCount, " at entity ", i, "!");
+				return;
+			}
+		}
+
+		if (l_sceneHierarchyMap->size() != testCaseCount - (testCaseCount + 3) / 4)
+		{
+			InnoLogger::Log(LogLevel::Error, "Scene hierarchy has ", l_sceneHierarchyMap->size(), " entities after removing the empty ones!");
+			return;
+		}
+
+		// The holes of the removed and the grown rows are compacted
+		size_t l_usedCapacity = 0;
+		for (auto i : *l_sceneHierarchyMap)
+		{
+			l_usedCapacity += i.second.size();
+		}
+
+		if (l_sceneHierarchyMap->GetComponentCapacity() > l_usedCapacity * 8)
+		{
+			InnoLogger::Log(LogLevel::Error, "Scene hierarchy keeps ", l_sceneHierarchyMap->GetComponentCapacity(), " slots for ", l_usedCapacity, " components!");
+			return;
+		}
+	}
+
+	InnoLogger::Log(LogLevel::Success, "Registering ", l_componentCount, " components to the scene hierarchy took ", (l_Timestamp1 - l_StartTime), "us, querying the components of ", testCaseCount, " entities took ", (l_Timestamp2 - l_Timestamp1), "us, unregistering took ", (l_Timestamp3 - l_Timestamp2), "us");
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		if (i % 4 != 0)
+		{
+			g_SceneHierarchyManager.UnregisterComponent(&l_components[i * 2]);
+		}
+		if (i % 2 != 0)
+		{
+			g_SceneHierarchyManager.UnregisterComponent(&l_components[i * 2 + 1]);
+		}
+	}
+
+	if (g_SceneHierarchyManager.GetSceneHierarchyMap()->size())
+	{
+		InnoLogger::Log(LogLevel::Error, "Scene hierarchy isn't empty after unregistering all the components!");
+	}
+}
+
 template <typename T>
 class AtomicDoubleBuffer
 {
@@ -182,6 +525,126 @@ private:
 Atomic<uint32_t> l_atomicBuffer;
 std::atomic<uint32_t> l_finishedTaskCount;
 
+// The component layout before the interning, with the name built and stored by SpawnComponentImpl
+class LegacyVisibleComponent : public VisibleComponent
+{
+public:
+	FixedSizeString<128> m_LegacyComponentName;
+};
+
+template <typename T>
+uint64_t SpawnTestComponents(IObjectPool* componentPool, InnoEntity* parentEntity, std::vector<T*>& components, size_t testCaseCount)
+{
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	// The same steps as SpawnComponentImpl without the map and the scene hierarchy registration
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_rawPtr = componentPool->Spawn();
+		auto l_Component = new(l_rawPtr)T();
+		l_Component->m_ParentEntity = parentEntity;
+		l_Component->m_ComponentType = ComponentType::VisibleComponent;
+		l_Component->m_ObjectStatus = ObjectStatus::Created;
+		l_Component->m_ObjectSource = ObjectSource::Runtime;
+		l_Component->m_ObjectOwnership = ObjectOwnership::Client;
+		l_Component->m_UUID = g_EntityManager.AcquireUUID();
+		if constexpr (std::is_same_v<T, LegacyVisibleComponent>)
+		{
+			l_Component->m_LegacyComponentName = FixedSizeString<128>((std::string(parentEntity->m_EntityName.c_str()) + ".VisibleComponent_" + std::to_string(i) + "/").c_str());
+		}
+		components.emplace_back(l_Component);
+		l_Component->m_ObjectStatus = ObjectStatus::Activated;
+	}
+
+	return InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond) - l_StartTime;
+}
+
+void TestComponentNaming(size_t testCaseCount)
+{
+	auto l_entity = g_EntityManager.Spawn(ObjectSource::Runtime, ObjectOwnership::Engine, "NamingTestEntity/");
+
+	auto l_legacyComponentPool = InnoMemory::CreateObjectPool<LegacyVisibleComponent>((uint32_t)testCaseCount);
+	auto l_componentPool = InnoMemory::CreateObjectPool<VisibleComponent>((uint32_t)testCaseCount);
+	std::vector<LegacyVisibleComponent*> l_legacyComponents;
+	std::vector<VisibleComponent*> l_components;
+	l_legacyComponents.reserve(testCaseCount);
+	l_components.reserve(testCaseCount);
+
+	auto l_legacySpawnTime = SpawnTestComponents(l_legacyComponentPool, l_entity, l_legacyComponents, testCaseCount);
+	auto l_spawnTime = SpawnTestComponents(l_componentPool, l_entity, l_components, testCaseCount);
+
+	InnoMemory::DestroyObjectPool(l_legacyComponentPool);
+	InnoMemory::DestroyObjectPool(l_componentPool);
+
+	// Named components still intern their names, the lookups by ID are lock-free
+	std::vector<std::string> l_names(testCaseCount);
+	std::vector<ComponentName> l_internedNames(testCaseCount);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_names[i] = "Entity_" + std::to_string(i / 4) + ".VisibleComponent_" + std::to_string(i) + "/";
+	}
+
+	auto l_tableSize = InnoStringTable::GetTotalSize();
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_internedNames[i] = l_names[i].c_str();
+	}
+
+	l_tableSize = InnoStringTable::GetTotalSize() - l_tableSize;
+
+	std::atomic<size_t> l_mismatchCount = 0;
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoTaskScheduler::ParallelFor("ComponentNameLookupTestTask", testCaseCount, 1024, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			if (l_internedNames[i] != FixedSizeString<128>(l_names[i].c_str()).c_str())
+			{
+				l_mismatchCount++;
+			}
+		}
+	});
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	if (l_mismatchCount)
+	{
+		InnoLogger::Log(LogLevel::Error, l_mismatchCount.load(), " interned component names mismatch!");
+		g_EntityManager.Destroy(l_entity);
+		return;
+	}
+
+	// The debug names of unnamed components follow the renaming of their parent entity
+	InnoComponent l_component;
+	l_component.m_ParentEntity = l_entity;
+	l_component.m_ComponentType = ComponentType::VisibleComponent;
+	l_component.m_UUID = 42;
+
+	auto l_debugName = l_component.GetDebugName();
+
+	g_EntityManager.Rename(l_entity, "RenamedNamingTestEntity/");
+
+	auto l_renamedDebugName = l_component.GetDebugName();
+
+	g_EntityManager.Destroy(l_entity);
+
+	if (l_debugName != "NamingTestEntity.VisibleComponent_42" || l_renamedDebugName != "RenamedNamingTestEntity.VisibleComponent_42")
+	{
+		InnoLogger::Log(LogLevel::Error, "Component debug name is ", l_debugName.c_str(), " before and ", l_renamedDebugName.c_str(), " after renaming its entity!");
+		return;
+	}
+
+	auto l_SpeedRatio = double(l_legacySpawnTime) / double(l_spawnTime);
+	auto l_internedSize = double(sizeof(ComponentName)) + double(l_tableSize) / double(testCaseCount);
+
+	InnoLogger::Log(LogLevel::Success, "Spawning ", testCaseCount, " components took ", l_legacySpawnTime, "us with named components (", sizeof(LegacyVisibleComponent), " bytes) VS ", l_spawnTime, "us with unnamed components (", sizeof(VisibleComponent), " bytes), speed ratio is ", l_SpeedRatio);
+	InnoLogger::Log(LogLevel::Success, "Looking up ", testCaseCount, " interned component names in parallel took ", (l_Timestamp2 - l_Timestamp1), "us, ", sizeof(FixedSizeString<128>), " bytes VS ", l_internedSize, " bytes per name");
+}
+
 bool CheckCyclic(std::vector<std::shared_ptr<IInnoTask>> tasks, size_t initialIndex, size_t targetIndex)
 {
 	auto l_currentTask = tasks[initialIndex];
@@ -439,18 +902,967 @@ void TestStackAllocator(size_t testCaseCount)
 	DispatchTestTasks(testCaseCount, ExampleJob_StackAllocator);
 }
 
+void TestRadixSort(size_t testCaseCount)
+{
+	// Draw call like keys, a few passes, shaders, materials and meshes with random depths
+	std::default_random_engine l_generator;
+	std::uniform_int_distribution<uint64_t> l_randomPass(0, 3);
+	std::uniform_int_distribution<uint64_t> l_randomShader(0, 7);
+	std::uniform_int_distribution<uint64_t> l_randomMaterial(0, 255);
+	std::uniform_int_distribution<uint64_t> l_randomMesh(0, 1023);
+	std::uniform_int_distribution<uint64_t> l_randomDepth(0, 0xFFFFF);
+
+	std::vector<uint64_t> l_keys(testCaseCount);
+	std::vector<uint32_t> l_values(testCaseCount);
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_keys[i] = (l_randomPass(l_generator) << 60) | (l_randomShader(l_generator) << 52) | (l_randomMaterial(l_generator) << 36) | (l_randomMesh(l_generator) << 20) | l_randomDepth(l_generator);
+		l_values[i] = (uint32_t)i;
+	}
+
+	std::vector<std::pair<uint64_t, uint32_t>> l_pairs(testCaseCount);
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_pairs[i] = { l_keys[i], l_values[i] };
+	}
+
+	std::vector<uint64_t> l_scratchKeys(testCaseCount);
+	std::vector<uint32_t> l_scratchValues(testCaseCount);
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	std::stable_sort(l_pairs.begin(), l_pairs.end(), [](const std::pair<uint64_t, uint32_t>& lhs, const std::pair<uint64_t, uint32_t>& rhs) { return lhs.first < rhs.first; });
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoRadixSort::Sort(l_keys.data(), l_values.data(), testCaseCount, l_scratchKeys.data(), l_scratchValues.data());
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		if (l_pairs[i].first != l_keys[i] || l_pairs[i].second != l_values[i])
+		{
+			InnoLogger::Log(LogLevel::Error, "Radix sort result is different from std::stable_sort!");
+			return;
+		}
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+
+	InnoLogger::Log(LogLevel::Success, "Radix sort of ", testCaseCount, " keys took ", (l_Timestamp2 - l_Timestamp1), "us, std::stable_sort VS radix sort speed ratio is ", l_SpeedRatio);
+}
+
+void TestParallelFor(size_t testCaseCount)
+{
+	std::vector<float> l_input(testCaseCount);
+	std::vector<float> l_serialResult(testCaseCount);
+	std::vector<float> l_parallelResult(testCaseCount);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_input[i] = float(i % 1024) * 0.01f;
+	}
+
+	auto l_job = [&](std::vector<float>& result, size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; i++)
+		{
+			result[i] = std::sqrt(l_input[i]) * std::sin(l_input[i]) + std::cos(l_input[i]);
+		}
+	};
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	l_job(l_serialResult, 0, testCaseCount);
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoTaskScheduler::ParallelFor("TestParallelFor", testCaseCount, 4096, [&](size_t begin, size_t end) { l_job(l_parallelResult, begin, end); });
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	if (l_serialResult != l_parallelResult)
+	{
+		InnoLogger::Log(LogLevel::Error, "Parallel for result is different from the serial one!");
+		return;
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+
+	InnoLogger::Log(LogLevel::Success, "Parallel for of ", testCaseCount, " elements took ", (l_Timestamp2 - l_Timestamp1), "us on ", InnoTaskScheduler::GetTotalThreadsNumber(), " threads, serial VS parallel speed ratio is ", l_SpeedRatio);
+}
+
+Frustum GenerateTestFrustum(float halfSize)
+{
+	Frustum l_result;
+	Plane* l_planes[6] = { &l_result.m_px, &l_result.m_nx, &l_result.m_py, &l_result.m_ny, &l_result.m_pz, &l_result.m_nz };
+
+	for (size_t i = 0; i < 6; i++)
+	{
+		auto l_sign = (i % 2) ? -1.0f : 1.0f;
+		l_planes[i]->m_normal = Vec4(i / 2 == 0 ? l_sign : 0.0f, i / 2 == 1 ? l_sign : 0.0f, i / 2 == 2 ? l_sign : 0.0f, 0.0f);
+		l_planes[i]->m_distance = halfSize;
+	}
+
+	return l_result;
+}
+
+std::vector<AABB> GenerateTestBounds(size_t testCaseCount, float worldHalfSize)
+{
+	std::default_random_engine l_generator;
+	std::uniform_real_distribution<float> l_randomPosition(-worldHalfSize, worldHalfSize);
+	std::uniform_real_distribution<float> l_randomSize(0.5f, 8.0f);
+
+	std::vector<AABB> l_result(testCaseCount);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_center = Vec4(l_randomPosition(l_generator), l_randomPosition(l_generator), l_randomPosition(l_generator), 1.0f);
+		auto l_extend = Vec4(l_randomSize(l_generator), l_randomSize(l_generator), l_randomSize(l_generator), 0.0f);
+		l_result[i] = InnoMath::generateAABB(l_center + l_extend * 0.5f, l_center - l_extend * 0.5f);
+	}
+
+	return l_result;
+}
+
+// The previous implementation, which transforms and bounds the 8 corners
+AABB TransformAABBCorners(const AABB& rhs, const Mat4& m)
+{
+	auto l_vertices = InnoMath::generateAABBVertices(rhs.m_boundMax, rhs.m_boundMin);
+
+	for (auto& i : l_vertices)
+	{
+#ifdef USE_COLUMN_MAJOR_MEMORY_LAYOUT
+		i.m_pos = InnoMath::mul(i.m_pos, m);
+#endif
+#ifdef USE_ROW_MAJOR_MEMORY_LAYOUT
+		i.m_pos = InnoMath::mul(m, i.m_pos);
+#endif
+	}
+
+	return InnoMath::generateAABB(&l_vertices[0], l_vertices.size());
+}
+
+void TestAABBTransform(size_t testCaseCount)
+{
+	auto l_bounds = GenerateTestBounds(testCaseCount, 250.0f);
+
+	std::default_random_engine l_generator;
+	std::uniform_real_distribution<float> l_randomUnit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> l_randomScale(0.5f, 2.0f);
+
+	std::vector<Mat4> l_transformations(testCaseCount);
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_axis = Vec4(l_randomUnit(l_generator), l_randomUnit(l_generator), l_randomUnit(l_generator) + 2.0f, 0.0f).normalize();
+		auto l_rot = InnoMath::getQuatRotator(l_axis, l_randomUnit(l_generator) * 180.0f);
+		auto l_pos = Vec4(l_randomUnit(l_generator) * 100.0f, l_randomUnit(l_generator) * 100.0f, l_randomUnit(l_generator) * 100.0f, 1.0f);
+		auto l_scale = Vec4(l_randomScale(l_generator), l_randomScale(l_generator), l_randomScale(l_generator), 1.0f);
+
+		l_transformations[i] = InnoMath::toTranslationMatrix(l_pos) * InnoMath::toRotationMatrix(l_rot) * InnoMath::toScaleMatrix(l_scale);
+	}
+
+	std::vector<AABB> l_cornerResult(testCaseCount);
+	std::vector<AABB> l_scalarResult(testCaseCount);
+	std::vector<AABB> l_batchedResult(testCaseCount);
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_cornerResult[i] = TransformAABBCorners(l_bounds[i], l_transformations[i]);
+	}
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_scalarResult[i] = InnoMath::transformAABBSpace(l_bounds[i], l_transformations[i]);
+	}
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoMath::transformAABBSpace(l_bounds.data(), l_transformations.data(), testCaseCount, l_batchedResult.data());
+
+	auto l_Timestamp3 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	float l_maxError = 0.0f;
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_scalarError = InnoMath::elementWiseMax(l_cornerResult[i].m_boundMax - l_scalarResult[i].m_boundMax, l_scalarResult[i].m_boundMin - l_cornerResult[i].m_boundMin);
+		auto l_batchedError = InnoMath::elementWiseMax(l_cornerResult[i].m_boundMax - l_batchedResult[i].m_boundMax, l_batchedResult[i].m_boundMin - l_cornerResult[i].m_boundMin);
+		auto l_error = InnoMath::elementWiseMax(l_scalarError, l_batchedError);
+
+		l_maxError = std::max({ l_maxError, std::abs(l_error.x), std::abs(l_error.y), std::abs(l_error.z) });
+	}
+
+	if (l_maxError > 1e-2f)
+	{
+		InnoLogger::Log(LogLevel::Error, "AABB transformation result is different from the corners, the error is ", l_maxError, "!");
+		return;
+	}
+
+	auto l_ScalarSpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+	auto l_BatchedSpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp3 - l_Timestamp2);
+
+	InnoLogger::Log(LogLevel::Success, "Transforming ", testCaseCount, " AABBs took ", (l_Timestamp3 - l_Timestamp2), "us in batch, corners VS center-extent speed ratio is ", l_ScalarSpeedRatio, ", corners VS batched speed ratio is ", l_BatchedSpeedRatio);
+
+	l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	Frustum l_frustum;
+	auto p = InnoMath::generatePerspectiveMatrix((90.0f / 180.0f) * PI<float>, 16.0f / 9.0f, 0.1f, 1000.0f);
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_vertices = InnoMath::generateFrustumVerticesWS(p, l_transformations[i], l_transformations[i]);
+		l_frustum.m_px.m_distance += InnoMath::makeFrustum(&l_vertices[0]).m_px.m_distance;
+	}
+
+	l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		Vertex l_vertices[8];
+		InnoMath::generateFrustumVerticesWS(p, l_transformations[i], l_transformations[i], l_vertices);
+		l_frustum.m_nx.m_distance += InnoMath::makeFrustum(l_vertices).m_px.m_distance;
+	}
+
+	l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	if (l_frustum.m_px.m_distance != l_frustum.m_nx.m_distance)
+	{
+		InnoLogger::Log(LogLevel::Error, "Frustum vertices are different from the allocating version!");
+		return;
+	}
+
+	auto l_FrustumSpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+
+	InnoLogger::Log(LogLevel::Success, "Generating ", testCaseCount, " frustums took ", (l_Timestamp2 - l_Timestamp1), "us without allocation, allocating VS allocation-free speed ratio is ", l_FrustumSpeedRatio);
+}
+
+void TestSIMDCulling(size_t testCaseCount)
+{
+	auto l_bounds = GenerateTestBounds(testCaseCount, 250.0f);
+	auto l_frustum = InnoCulling::GenerateCullingFrustum(GenerateTestFrustum(100.0f));
+
+	CullingBounds l_cullingBounds;
+	l_cullingBounds.resize(testCaseCount);
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_cullingBounds.Set(i, l_bounds[i]);
+	}
+
+	std::vector<uint32_t> l_scalarResult(testCaseCount);
+	std::vector<uint32_t> l_SIMDResult(testCaseCount);
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	auto l_scalarCount = InnoCulling::CullScalar(l_frustum, l_cullingBounds, 0, testCaseCount, nullptr, l_scalarResult.data());
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	auto l_SIMDCount = InnoCulling::Cull(l_frustum, l_cullingBounds, 0, testCaseCount, nullptr, l_SIMDResult.data());
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	l_scalarResult.resize(l_scalarCount);
+	l_SIMDResult.resize(l_SIMDCount);
+
+	if (l_scalarResult != l_SIMDResult || l_SIMDResult.empty())
+	{
+		InnoLogger::Log(LogLevel::Error, "SIMD culling result is different from the scalar one!");
+		return;
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+
+	InnoLogger::Log(LogLevel::Success, InnoCulling::GetInstructionSet(), " culling of ", testCaseCount, " objects found ", l_SIMDCount, " objects in ", (l_Timestamp2 - l_Timestamp1), "us, scalar VS SIMD speed ratio is ", l_SpeedRatio);
+}
+
+void TestBVH(size_t testCaseCount)
+{
+	auto l_bounds = GenerateTestBounds(testCaseCount, 250.0f);
+	auto l_frustum = GenerateTestFrustum(100.0f);
+
+	std::vector<Sphere> l_spheres(testCaseCount);
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		l_spheres[i] = InnoMath::generateBoundSphere(l_bounds[i]);
+	}
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	BVH l_BVH;
+	InnoBVH::Build(l_BVH, l_bounds.data(), testCaseCount);
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	std::vector<uint32_t> l_linearResult;
+	l_linearResult.reserve(testCaseCount);
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		if (InnoMath::intersectCheck(l_frustum, l_spheres[i]))
+		{
+			l_linearResult.emplace_back((uint32_t)i);
+		}
+	}
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	std::vector<uint32_t> l_BVHResult;
+	l_BVHResult.reserve(testCaseCount);
+	InnoBVH::Cull(l_BVH, l_frustum, l_BVHResult);
+
+	auto l_Timestamp3 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	// The bounding spheres are looser than the AABBs, so every object found by the BVH must be found by the linear pass too
+	std::sort(l_BVHResult.begin(), l_BVHResult.end());
+	if (!std::includes(l_linearResult.begin(), l_linearResult.end(), l_BVHResult.begin(), l_BVHResult.end()) || l_BVHResult.empty())
+	{
+		InnoLogger::Log(LogLevel::Error, "BVH culling result is not a subset of the linear culling result!");
+		return;
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp2 - l_Timestamp1) / double(l_Timestamp3 - l_Timestamp2);
+
+	InnoLogger::Log(LogLevel::Success, "BVH of ", testCaseCount, " objects with ", l_BVH.m_Nodes.size(), " nodes took ", (l_Timestamp1 - l_StartTime), "us to build, culling found ", l_BVHResult.size(), " objects in ", (l_Timestamp3 - l_Timestamp2), "us, linear VS BVH culling speed ratio is ", l_SpeedRatio);
+}
+
+// The closest bounds along the ray by testing all of them
+bool RaycastLinear(const std::vector<AABB>& bounds, const Vec4& origin, const Vec4& direction, float maxDistance, uint32_t& hitIndex, float& hitDistance)
+{
+	auto l_isHit = false;
+	hitDistance = maxDistance;
+
+	for (size_t i = 0; i < bounds.size(); i++)
+	{
+		auto l_tMin = 0.0f;
+		auto l_tMax = hitDistance;
+		float l_origin[3] = { origin.x, origin.y, origin.z };
+		float l_direction[3] = { direction.x, direction.y, direction.z };
+		float l_boundMin[3] = { bounds[i].m_boundMin.x, bounds[i].m_boundMin.y, bounds[i].m_boundMin.z };
+		float l_boundMax[3] = { bounds[i].m_boundMax.x, bounds[i].m_boundMax.y, bounds[i].m_boundMax.z };
+
+		for (size_t j = 0; j < 3; j++)
+		{
+			auto l_t0 = (l_boundMin[j] - l_origin[j]) / l_direction[j];
+			auto l_t1 = (l_boundMax[j] - l_origin[j]) / l_direction[j];
+			l_tMin = std::max(l_tMin, std::min(l_t0, l_t1));
+			l_tMax = std::min(l_tMax, std::max(l_t0, l_t1));
+		}
+
+		if (l_tMin <= l_tMax)
+		{
+			hitIndex = (uint32_t)i;
+			hitDistance = l_tMin;
+			l_isHit = true;
+		}
+	}
+
+	return l_isHit;
+}
+
+void TestBVHSceneQuery(size_t testCaseCount, size_t queryCount)
+{
+	auto l_bounds = GenerateTestBounds(testCaseCount, 250.0f);
+
+	BVH l_BVH;
+	InnoBVH::Build(l_BVH, l_bounds.data(), testCaseCount);
+
+	std::default_random_engine l_generator;
+	std::uniform_real_distribution<float> l_randomPosition(-250.0f, 250.0f);
+	std::uniform_real_distribution<float> l_randomDirection(-1.0f, 1.0f);
+
+	std::vector<Vec4> l_origins(queryCount);
+	std::vector<Vec4> l_directions(queryCount);
+	std::vector<AABB> l_overlaps(queryCount);
+
+	for (size_t i = 0; i < queryCount; i++)
+	{
+		l_origins[i] = Vec4(l_randomPosition(l_generator), l_randomPosition(l_generator), l_randomPosition(l_generator), 1.0f);
+		l_directions[i] = Vec4(l_randomDirection(l_generator), l_randomDirection(l_generator), l_randomDirection(l_generator), 0.0f).normalize();
+		l_overlaps[i] = InnoMath::generateAABB(l_origins[i] + Vec4(5.0f, 5.0f, 5.0f, 0.0f), l_origins[i] - Vec4(5.0f, 5.0f, 5.0f, 0.0f));
+	}
+
+	const float l_maxDistance = 1000.0f;
+	std::vector<uint32_t> l_linearHits(queryCount, std::numeric_limits<uint32_t>::max());
+	std::vector<uint32_t> l_BVHHits(queryCount, std::numeric_limits<uint32_t>::max());
+	std::vector<float> l_linearDistances(queryCount);
+	std::vector<float> l_BVHDistances(queryCount);
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < queryCount; i++)
+	{
+		RaycastLinear(l_bounds, l_origins[i], l_directions[i], l_maxDistance, l_linearHits[i], l_linearDistances[i]);
+	}
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoTaskScheduler::ParallelFor("SceneRaycastTestTask", queryCount, 64, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			InnoBVH::Raycast(l_BVH, l_origins[i], l_directions[i], Vec4(), l_maxDistance, nullptr, l_BVHHits[i], l_BVHDistances[i]);
+		}
+	});
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	std::vector<std::vector<uint32_t>> l_overlapResults(queryCount);
+	InnoTaskScheduler::ParallelFor("SceneOverlapTestTask", queryCount, 64, [&](size_t begin, size_t end)
+	{
+		for (auto i = begin; i < end; i++)
+		{
+			InnoBVH::Overlap(l_BVH, l_overlaps[i], l_overlapResults[i]);
+		}
+	});
+
+	auto l_Timestamp3 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	// Different objects could be hit at the same distance, so only the distances are compared
+	size_t l_hitCount = 0;
+	for (size_t i = 0; i < queryCount; i++)
+	{
+		auto l_isLinearHit = l_linearHits[i] != std::numeric_limits<uint32_t>::max();
+		auto l_isBVHHit = l_BVHHits[i] != std::numeric_limits<uint32_t>::max();
+		if (l_isLinearHit != l_isBVHHit || (l_isLinearHit && std::abs(l_linearDistances[i] - l_BVHDistances[i]) > 1e-3f))
+		{
+			InnoLogger::Log(LogLevel::Error, "BVH raycast result is different from the linear raycast result!");
+			return;
+		}
+		l_hitCount += l_isBVHHit ? 1 : 0;
+	}
+
+	size_t l_overlapHitCount = 0;
+	for (size_t i = 0; i < queryCount; i++)
+	{
+		std::vector<uint32_t> l_linearResult;
+		for (size_t j = 0; j < testCaseCount; j++)
+		{
+			if (InnoMath::intersectCheck(l_overlaps[i], l_bounds[j]))
+			{
+				l_linearResult.emplace_back((uint32_t)j);
+			}
+		}
+
+		std::sort(l_overlapResults[i].begin(), l_overlapResults[i].end());
+		if (l_linearResult != l_overlapResults[i])
+		{
+			InnoLogger::Log(LogLevel::Error, "BVH overlap result is different from the linear overlap result!");
+			return;
+		}
+		l_overlapHitCount += l_linearResult.size();
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+
+	InnoLogger::Log(LogLevel::Success, "BVH scene query of ", queryCount, " rays against ", testCaseCount, " objects hit ", l_hitCount, " objects in ", (l_Timestamp2 - l_Timestamp1), "us, linear VS BVH raycast speed ratio is ", l_SpeedRatio, ", ", queryCount, " overlaps found ", l_overlapHitCount, " objects in ", (l_Timestamp3 - l_Timestamp2), "us");
+}
+
+void TestBVHRefit(size_t testCaseCount)
+{
+	auto l_bounds = GenerateTestBounds(testCaseCount, 250.0f);
+	auto l_frustum = GenerateTestFrustum(100.0f);
+
+	BVH l_BVH;
+	InnoBVH::Build(l_BVH, l_bounds.data(), testCaseCount);
+	auto l_buildSAHCost = InnoBVH::GetNormalizedSAHCost(l_BVH);
+
+	// Move 1% of the objects
+	std::default_random_engine l_generator;
+	std::uniform_real_distribution<float> l_randomOffset(-20.0f, 20.0f);
+	std::vector<uint32_t> l_changedPrimitives;
+
+	for (size_t i = 0; i < testCaseCount; i += 100)
+	{
+		auto l_offset = Vec4(l_randomOffset(l_generator), l_randomOffset(l_generator), l_randomOffset(l_generator), 0.0f);
+		l_bounds[i] = InnoMath::generateAABB(l_bounds[i].m_boundMax + l_offset, l_bounds[i].m_boundMin + l_offset);
+		l_changedPrimitives.emplace_back((uint32_t)i);
+	}
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoBVH::Refit(l_BVH, l_bounds.data(), l_changedPrimitives.data(), l_changedPrimitives.size());
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	BVH l_rebuiltBVH;
+	InnoBVH::Build(l_rebuiltBVH, l_bounds.data(), testCaseCount);
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	std::vector<uint32_t> l_refittedResult;
+	std::vector<uint32_t> l_rebuiltResult;
+	InnoBVH::Cull(l_BVH, l_frustum, l_refittedResult);
+	InnoBVH::Cull(l_rebuiltBVH, l_frustum, l_rebuiltResult);
+	std::sort(l_refittedResult.begin(), l_refittedResult.end());
+	std::sort(l_rebuiltResult.begin(), l_rebuiltResult.end());
+
+	if (l_refittedResult != l_rebuiltResult)
+	{
+		InnoLogger::Log(LogLevel::Error, "Refitted BVH culling result is different from the rebuilt one!");
+		return;
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp2 - l_Timestamp1) / double(l_Timestamp1 - l_StartTime);
+	auto l_qualityRatio = InnoBVH::GetNormalizedSAHCost(l_BVH) / l_buildSAHCost;
+
+	InnoLogger::Log(LogLevel::Success, "Refitting BVH of ", testCaseCount, " objects after moving ", l_changedPrimitives.size(), " of them took ", (l_Timestamp1 - l_StartTime), "us, SAH cost ratio to the built tree is ", l_qualityRatio, ", rebuild VS refit speed ratio is ", l_SpeedRatio);
+}
+
+// The queries run on the task threads under the shared side of the lock while another thread keeps refitting the BVH under the exclusive side
+void TestBVHConcurrentRefit(size_t testCaseCount, size_t refitCount, size_t queryCount)
+{
+	auto l_bounds = GenerateTestBounds(testCaseCount, 250.0f);
+
+	BVH l_BVH;
+	InnoBVH::Build(l_BVH, l_bounds.data(), testCaseCount);
+
+	// The same context as the physics system, the refits take the exclusive side and the queries are submitted through it
+	SceneQueryContext l_context;
+
+	std::vector<uint32_t> l_changedPrimitives;
+	for (size_t i = 0; i < testCaseCount; i += 100)
+	{
+		l_changedPrimitives.emplace_back((uint32_t)i);
+	}
+
+	std::default_random_engine l_generator;
+	std::uniform_real_distribution<float> l_randomPosition(-250.0f, 250.0f);
+	std::uniform_real_distribution<float> l_randomDirection(-1.0f, 1.0f);
+
+	std::vector<Vec4> l_origins(queryCount);
+	std::vector<Vec4> l_directions(queryCount);
+	std::vector<AABB> l_overlaps(queryCount);
+
+	for (size_t i = 0; i < queryCount; i++)
+	{
+		l_origins[i] = Vec4(l_randomPosition(l_generator), l_randomPosition(l_generator), l_randomPosition(l_generator), 1.0f);
+		l_directions[i] = Vec4(l_randomDirection(l_generator), l_randomDirection(l_generator), l_randomDirection(l_generator), 0.0f).normalize();
+		l_overlaps[i] = InnoMath::generateAABB(l_origins[i] + Vec4(5.0f, 5.0f, 5.0f, 0.0f), l_origins[i] - Vec4(5.0f, 5.0f, 5.0f, 0.0f));
+	}
+
+	std::atomic<bool> l_isRefitFinished = false;
+
+	std::thread l_refitThread([&]()
+	{
+		std::default_random_engine l_refitGenerator;
+		std::uniform_real_distribution<float> l_randomOffset(-5.0f, 5.0f);
+
+		for (size_t i = 0; i < refitCount; i++)
+		{
+			std::unique_lock<std::shared_mutex> lock{ l_context.m_Mutex };
+
+			for (auto j : l_changedPrimitives)
+			{
+				auto l_offset = Vec4(l_randomOffset(l_refitGenerator), l_randomOffset(l_refitGenerator), l_randomOffset(l_refitGenerator), 0.0f);
+				l_bounds[j] = InnoMath::generateAABB(l_bounds[j].m_boundMax + l_offset, l_bounds[j].m_boundMin + l_offset);
+			}
+
+			InnoBVH::Refit(l_BVH, l_bounds.data(), l_changedPrimitives.data(), l_changedPrimitives.size());
+		}
+
+		l_isRefitFinished = true;
+	});
+
+	// Every query is checked against the linear result of the bounds it saw, so a torn tree shows up as a mismatch
+	const float l_maxDistance = 1000.0f;
+	const size_t l_queryGrainSize = 8;
+	std::atomic<size_t> l_mismatchCount = 0;
+	size_t l_roundCount = 0;
+	size_t l_maxTaskCount = 0;
+	std::vector<std::shared_ptr<IInnoTask>> l_tasks;
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	do
+	{
+		l_tasks.clear();
+
+		for (size_t begin = 0; begin < queryCount; begin += l_queryGrainSize)
+		{
+			auto end = std::min(begin + l_queryGrainSize, queryCount);
+
+			l_tasks.emplace_back(InnoSceneQuery::Submit(l_context, "ConcurrentSceneQueryTestTask", [&, begin, end]()
+			{
+				std::vector<uint32_t> l_overlapResult;
+
+				for (auto i = begin; i < end; i++)
+				{
+					uint32_t l_linearHit = std::numeric_limits<uint32_t>::max();
+					uint32_t l_BVHHit = std::numeric_limits<uint32_t>::max();
+					float l_linearDistance;
+					float l_BVHDistance;
+
+					auto l_isLinearHit = RaycastLinear(l_bounds, l_origins[i], l_directions[i], l_maxDistance, l_linearHit, l_linearDistance);
+					auto l_isBVHHit = InnoBVH::Raycast(l_BVH, l_origins[i], l_directions[i], Vec4(), l_maxDistance, nullptr, l_BVHHit, l_BVHDistance);
+
+					if (l_isLinearHit != l_isBVHHit || (l_isLinearHit && std::abs(l_linearDistance - l_BVHDistance) > 1e-3f))
+					{
+						l_mismatchCount++;
+					}
+
+					l_overlapResult.clear();
+					InnoBVH::Overlap(l_BVH, l_overlaps[i], l_overlapResult);
+
+					size_t l_linearOverlapCount = 0;
+					for (size_t j = 0; j < testCaseCount; j++)
+					{
+						l_linearOverlapCount += InnoMath::intersectCheck(l_overlaps[i], l_bounds[j]) ? 1 : 0;
+					}
+
+					if (l_linearOverlapCount != l_overlapResult.size())
+					{
+						l_mismatchCount++;
+					}
+				}
+			}));
+		}
+
+		// The tasks of the last rounds are finished and dropped, so only the ones of this round could be kept
+		l_maxTaskCount = std::max(l_maxTaskCount, InnoSceneQuery::GetTaskCount(l_context));
+
+		for (auto& i : l_tasks)
+		{
+			i->Wait();
+		}
+
+		l_roundCount++;
+	} while (!l_isRefitFinished);
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	l_refitThread.join();
+	InnoSceneQuery::WaitAll(l_context);
+
+	if (l_mismatchCount)
+	{
+		InnoLogger::Log(LogLevel::Error, l_mismatchCount.load(), " BVH scene queries are different from the linear ones while refitting!");
+		return;
+	}
+
+	if (l_maxTaskCount > l_tasks.size() || InnoSceneQuery::GetTaskCount(l_context))
+	{
+		InnoLogger::Log(LogLevel::Error, "Finished scene query tasks are kept, ", l_maxTaskCount, " tasks are kept for ", l_tasks.size(), " tasks of a round!");
+		return;
+	}
+
+	InnoLogger::Log(LogLevel::Success, "BVH scene query of ", queryCount, " rays and overlaps against ", testCaseCount, " objects ran ", l_roundCount, " rounds while refitting ", refitCount, " times in ", (l_Timestamp1 - l_StartTime), "us");
+}
+
+void TestParallelCulling(size_t testCaseCount)
+{
+	auto l_bounds = GenerateTestBounds(testCaseCount, 250.0f);
+	auto l_frustum = GenerateTestFrustum(100.0f);
+
+	BVH l_BVH;
+	InnoBVH::Build(l_BVH, l_bounds.data(), testCaseCount);
+
+	std::vector<uint32_t> l_serialResult;
+	std::vector<uint32_t> l_parallelResult;
+	l_serialResult.reserve(testCaseCount);
+	l_parallelResult.reserve(testCaseCount);
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoBVH::Cull(l_BVH, l_frustum, l_serialResult);
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoBVH::ParallelCull(l_BVH, l_frustum, l_parallelResult);
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	// Not sorted, the order must be the same too
+	if (l_serialResult != l_parallelResult || l_parallelResult.empty())
+	{
+		InnoLogger::Log(LogLevel::Error, "Parallel culling result is different from the serial one!");
+		return;
+	}
+
+	auto l_SpeedRatio = double(l_Timestamp1 - l_StartTime) / double(l_Timestamp2 - l_Timestamp1);
+
+	InnoLogger::Log(LogLevel::Success, "Parallel culling of ", testCaseCount, " objects found ", l_parallelResult.size(), " objects in ", (l_Timestamp2 - l_Timestamp1), "us on ", InnoTaskScheduler::GetTotalThreadsNumber(), " threads, serial VS parallel speed ratio is ", l_SpeedRatio);
+}
+
+void TestScreenSizeCulling(size_t testCaseCount)
+{
+	// The camera is at the origin looking at -Z
+	auto l_P = InnoMath::generatePerspectiveMatrix<float>(PI<float> / 2.0f, 2.0f, 0.1f, 1000.0f);
+	auto l_cameraPos = Vec4(0.0f, 0.0f, 0.0f, 1.0f);
+
+	OcclusionBuffer l_buffer;
+	InnoOcclusionCulling::Clear(l_buffer, 256, 128);
+
+	auto l_pixelsPerUnit = InnoCulling::GetPixelsPerUnit(l_P, (float)l_buffer.m_Height);
+
+	// The screen size is the distance between the projected top and bottom of the bound sphere
+	Sphere l_sphere;
+	l_sphere.m_center = Vec4(3.0f, 0.0f, -50.0f, 1.0f);
+	l_sphere.m_radius = 2.0f;
+
+	Vertex l_sphereVertices[2];
+	l_sphereVertices[0].m_pos = Vec4(3.0f, 2.0f, -50.0f, 1.0f);
+	l_sphereVertices[1].m_pos = Vec4(3.0f, -2.0f, -50.0f, 1.0f);
+
+	Vec4 l_sphereScreenVertices[2];
+	InnoOcclusionCulling::TransformOccluderVertices(l_buffer, l_P, l_sphereVertices, 2, l_sphereScreenVertices);
+
+	auto l_projectedSize = std::abs(l_sphereScreenVertices[0].y - l_sphereScreenVertices[1].y);
+	auto l_screenSize = InnoCulling::GetScreenSize(l_sphere, l_cameraPos, l_pixelsPerUnit);
+
+	if (std::abs(l_projectedSize - l_screenSize) > l_projectedSize * 0.01f)
+	{
+		InnoLogger::Log(LogLevel::Error, "Screen size of the bound sphere is ", l_screenSize, " pixels, but it's projected to ", l_projectedSize, " pixels!");
+		return;
+	}
+
+	// The camera inside of a bound sphere always keeps the object, also as a shadow caster
+	l_sphere.m_center = Vec4(0.5f, 0.0f, -0.5f, 1.0f);
+	l_sphere.m_radius = 1.0f;
+
+	if (InnoCulling::GetScreenSize(l_sphere, l_cameraPos, l_pixelsPerUnit) < std::numeric_limits<float>::max())
+	{
+		InnoLogger::Log(LogLevel::Error, "Object is culled by its screen size while the camera is inside of its bound sphere!");
+		return;
+	}
+
+	// With the default thresholds, an object of 1.5 pixels is visible but too small to cast a shadow
+	VisibleComponent l_visibleComponent;
+
+	auto l_isKept = [&](float screenSize, float distance, float threshold)
+	{
+		Sphere l_testSphere;
+		l_testSphere.m_radius = screenSize * distance / l_pixelsPerUnit;
+		l_testSphere.m_center = Vec4(0.0f, 0.0f, -distance, 1.0f);
+		return InnoCulling::GetScreenSize(l_testSphere, l_cameraPos, l_pixelsPerUnit) >= threshold;
+	};
+
+	if (l_isKept(0.5f, 100.0f, l_visibleComponent.m_minScreenSize)
+		|| !l_isKept(1.5f, 100.0f, l_visibleComponent.m_minScreenSize)
+		|| l_isKept(1.5f, 100.0f, l_visibleComponent.m_minShadowScreenSize)
+		|| !l_isKept(3.0f, 100.0f, l_visibleComponent.m_minShadowScreenSize))
+	{
+		InnoLogger::Log(LogLevel::Error, "Screen size threshold filtering result is wrong!");
+		return;
+	}
+
+	std::default_random_engine l_generator;
+	std::uniform_real_distribution<float> l_randomPosition(-500.0f, 500.0f);
+	std::uniform_real_distribution<float> l_randomRadius(0.01f, 4.0f);
+
+	std::vector<Sphere> l_spheres(testCaseCount);
+	for (auto& i : l_spheres)
+	{
+		i.m_center = Vec4(l_randomPosition(l_generator), l_randomPosition(l_generator), l_randomPosition(l_generator), 1.0f);
+		i.m_radius = l_randomRadius(l_generator);
+	}
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	size_t l_visibleCount = 0;
+	size_t l_shadowCasterCount = 0;
+	for (auto& i : l_spheres)
+	{
+		auto l_size = InnoCulling::GetScreenSize(i, l_cameraPos, l_pixelsPerUnit);
+		l_visibleCount += l_size >= l_visibleComponent.m_minScreenSize;
+		l_shadowCasterCount += l_size >= l_visibleComponent.m_minShadowScreenSize;
+	}
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	if (l_shadowCasterCount > l_visibleCount)
+	{
+		InnoLogger::Log(LogLevel::Error, "More objects are kept by the shadow threshold than the visible one!");
+		return;
+	}
+
+	InnoLogger::Log(LogLevel::Success, "Screen size culling of ", testCaseCount, " objects kept ", l_visibleCount, " visible objects and ", l_shadowCasterCount, " shadow casters in ", (l_Timestamp1 - l_StartTime), "us");
+}
+
+void TestOcclusionCulling(size_t testCaseCount)
+{
+	// The camera is at the origin looking at -Z, a wall covers the left half of the screen
+	auto l_VP = InnoMath::generatePerspectiveMatrix<float>(PI<float> / 2.0f, 2.0f, 0.1f, 1000.0f);
+
+	Vertex l_wallVertices[4];
+	l_wallVertices[0].m_pos = Vec4(-40.0f, -20.0f, -10.0f, 1.0f);
+	l_wallVertices[1].m_pos = Vec4(0.0f, -20.0f, -10.0f, 1.0f);
+	l_wallVertices[2].m_pos = Vec4(0.0f, 20.0f, -10.0f, 1.0f);
+	l_wallVertices[3].m_pos = Vec4(-40.0f, 20.0f, -10.0f, 1.0f);
+	uint32_t l_wallIndices[6] = { 0, 1, 2, 0, 2, 3 };
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	OcclusionBuffer l_buffer;
+	InnoOcclusionCulling::Clear(l_buffer, 256, 128);
+
+	Vec4 l_wallScreenVertices[4];
+	InnoOcclusionCulling::TransformOccluderVertices(l_buffer, l_VP, l_wallVertices, 4, l_wallScreenVertices);
+	InnoOcclusionCulling::RasterizeOccluder(l_buffer, l_wallScreenVertices, l_wallIndices, 6, 0, l_buffer.m_Height);
+	InnoOcclusionCulling::UpdateHierarchy(l_buffer);
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	auto l_generateBox = [](float x, float y, float z) { return InnoMath::generateAABB(Vec4(x + 1.0f, y + 1.0f, z + 1.0f, 1.0f), Vec4(x - 1.0f, y - 1.0f, z - 1.0f, 1.0f)); };
+
+	if (InnoOcclusionCulling::TestOccludee(l_buffer, l_VP, l_generateBox(-15.0f, 0.0f, -30.0f))
+		|| !InnoOcclusionCulling::TestOccludee(l_buffer, l_VP, l_generateBox(15.0f, 0.0f, -30.0f))
+		|| !InnoOcclusionCulling::TestOccludee(l_buffer, l_VP, l_generateBox(-3.0f, 0.0f, -5.0f))
+		|| !InnoOcclusionCulling::TestOccludee(l_buffer, l_VP, l_generateBox(0.0f, 0.0f, -30.0f)))
+	{
+		InnoLogger::Log(LogLevel::Error, "Occlusion culling result is wrong!");
+		return;
+	}
+
+	std::default_random_engine l_generator;
+	std::uniform_real_distribution<float> l_randomX(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> l_randomDepth(2.0f, 100.0f);
+
+	std::vector<AABB> l_occludees(testCaseCount);
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		auto l_depth = l_randomDepth(l_generator);
+		l_occludees[i] = l_generateBox(l_randomX(l_generator) * l_depth, l_randomX(l_generator) * l_depth * 0.5f, -l_depth);
+	}
+
+	auto l_Timestamp2 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	size_t l_occludedCount = 0;
+	for (size_t i = 0; i < testCaseCount; i++)
+	{
+		if (!InnoOcclusionCulling::TestOccludee(l_buffer, l_VP, l_occludees[i]))
+		{
+			l_occludedCount++;
+		}
+	}
+
+	auto l_Timestamp3 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	InnoLogger::Log(LogLevel::Success, InnoCulling::GetInstructionSet(), " occlusion buffer took ", (l_Timestamp1 - l_StartTime), "us to rasterize, testing ", testCaseCount, " occludees took ", (l_Timestamp3 - l_Timestamp2), "us, ", l_occludedCount, " of them are occluded");
+}
+
+void TestRigidBodyStacking(size_t columnCount, size_t stackHeight, size_t stepCount)
+{
+	RigidBodyWorld l_world;
+
+	RigidBodyDesc l_groundDesc;
+	l_groundDesc.m_Position = Vec4(0.0f, -0.5f, 0.0f, 1.0f);
+	l_groundDesc.m_HalfExtents = Vec4(100.0f, 0.5f, 100.0f, 0.0f);
+	l_groundDesc.m_Mass = 0.0f;
+	InnoRigidBodyDynamics::AddRigidBody(l_world, l_groundDesc);
+
+	// Box stacks on a grid, every stack is an island
+	auto l_gridSize = (size_t)std::ceil(std::sqrt((double)columnCount));
+	std::vector<uint32_t> l_topBoxIndices;
+
+	for (size_t i = 0; i < columnCount; i++)
+	{
+		for (size_t j = 0; j < stackHeight; j++)
+		{
+			RigidBodyDesc l_boxDesc;
+			l_boxDesc.m_Position = Vec4((float)(i % l_gridSize) * 3.0f, 0.5f + (float)j, (float)(i / l_gridSize) * 3.0f, 1.0f);
+			auto l_index = InnoRigidBodyDynamics::AddRigidBody(l_world, l_boxDesc);
+
+			if (j == stackHeight - 1)
+			{
+				l_topBoxIndices.emplace_back(l_index);
+			}
+		}
+	}
+
+	// A sphere and a convex octahedron resting next to the stacks
+	RigidBodyDesc l_sphereDesc;
+	l_sphereDesc.m_ShapeType = RigidBodyShapeType::Sphere;
+	l_sphereDesc.m_Position = Vec4(-5.0f, 2.0f, 0.0f, 1.0f);
+	auto l_sphereIndex = InnoRigidBodyDynamics::AddRigidBody(l_world, l_sphereDesc);
+
+	RigidBodyDesc l_convexDesc;
+	l_convexDesc.m_ShapeType = RigidBodyShapeType::Convex;
+	l_convexDesc.m_Position = Vec4(-5.0f, 2.0f, 5.0f, 1.0f);
+	l_convexDesc.m_ConvexVertices = { Vec4(0.5f, 0.0f, 0.0f, 0.0f), Vec4(-0.5f, 0.0f, 0.0f, 0.0f), Vec4(0.0f, 0.5f, 0.0f, 0.0f), Vec4(0.0f, -0.5f, 0.0f, 0.0f), Vec4(0.0f, 0.0f, 0.5f, 0.0f), Vec4(0.0f, 0.0f, -0.5f, 0.0f) };
+	// The interior and the duplicated vertices of a mesh aren't part of the hull
+	l_convexDesc.m_ConvexVertices.emplace_back(0.0f, 0.0f, 0.0f, 0.0f);
+	l_convexDesc.m_ConvexVertices.emplace_back(0.1f, 0.1f, 0.1f, 0.0f);
+	l_convexDesc.m_ConvexVertices.emplace_back(0.5f, 0.0f, 0.0f, 0.0f);
+	auto l_convexIndex = InnoRigidBodyDynamics::AddRigidBody(l_world, l_convexDesc);
+
+	if (l_world.m_ConvexShapes[l_world.m_Bodies[l_convexIndex].m_ConvexShapeIndex].size() != 6)
+	{
+		InnoLogger::Log(LogLevel::Error, "Rigid body convex hull has ", l_world.m_ConvexShapes[l_world.m_Bodies[l_convexIndex].m_ConvexShapeIndex].size(), " vertices instead of 6!");
+		return;
+	}
+
+	auto l_StartTime = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	for (size_t i = 0; i < stepCount; i++)
+	{
+		InnoRigidBodyDynamics::Step(l_world, 1.0f / 60.0f);
+	}
+
+	auto l_Timestamp1 = InnoTimer::GetCurrentTimeFromEpoch(TimeUnit::Microsecond);
+
+	auto l_expectedTopHeight = (float)stackHeight - 0.5f;
+	for (auto i : l_topBoxIndices)
+	{
+		auto& l_position = l_world.m_Bodies[i].m_Position;
+		if (std::abs(l_position.y - l_expectedTopHeight) > 0.1f || std::abs(l_position.x - std::round(l_position.x)) > 0.1f)
+		{
+			InnoLogger::Log(LogLevel::Error, "Rigid body stack collapsed, the top box is at (", l_position.x, ", ", l_position.y, ", ", l_position.z, ")!");
+			return;
+		}
+	}
+
+	if (std::abs(l_world.m_Bodies[l_sphereIndex].m_Position.y - 0.5f) > 0.05f)
+	{
+		InnoLogger::Log(LogLevel::Error, "Rigid body sphere isn't resting on the ground, it's at ", l_world.m_Bodies[l_sphereIndex].m_Position.y, "!");
+		return;
+	}
+
+	if (l_world.m_Bodies[l_convexIndex].m_Position.y < 0.2f || l_world.m_Bodies[l_convexIndex].m_Position.y > 0.55f)
+	{
+		InnoLogger::Log(LogLevel::Error, "Rigid body convex shape isn't resting on the ground, it's at ", l_world.m_Bodies[l_convexIndex].m_Position.y, "!");
+		return;
+	}
+
+	auto l_StepsPerSecond = double(stepCount) * 1000000.0 / double(l_Timestamp1 - l_StartTime);
+
+	InnoLogger::Log(LogLevel::Success, "Rigid body stacking of ", columnCount, " stacks of ", stackHeight, " boxes ran at ", l_StepsPerSecond, " steps per second with ", InnoRigidBodyDynamics::GetIslandCount(l_world), " islands, ", InnoRigidBodyDynamics::GetContactPointCount(l_world), " contact points and ", InnoRigidBodyDynamics::GetSleepingBodyCount(l_world), " sleeping bodies");
+}
+
 int main(int argc, char *argv[])
 {
 	InnoTaskScheduler::Setup();
 	InnoTaskScheduler::Initialize();
+	g_EntityManager.Setup();
+	g_SceneHierarchyManager.Setup();
 
 	TestIToA(8192);
 	TestArray(8192);
 	TestInnoMemory(65536);
+	TestEntitySpawning(100000, 8192);
+	TestEntityNameLookup(50000);
+	TestComponentNaming(100000);
+	TestSceneHierarchy(4096);
 	TestAtomic(128);
 	TestAtomicDoubleBuffer(128);
 	TestInnoRingBuffer(128);
 	TestStackAllocator(128);
+	TestParallelFor(4194304);
+	TestRadixSort(30000);
+	TestAABBTransform(1000000);
+	TestSIMDCulling(100000);
+	TestBVH(10000);
+	TestBVH(50000);
+	TestBVH(200000);
+	TestBVHRefit(100000);
+	TestBVHSceneQuery(100000, 1000);
+	TestBVHConcurrentRefit(20000, 200, 256);
+	TestParallelCulling(200000);
+	TestScreenSizeCulling(100000);
+	TestOcclusionCulling(100000);
+	TestRigidBodyStacking(64, 5, 600);
 	InnoTaskScheduler::Terminate();
 
 	return 0;